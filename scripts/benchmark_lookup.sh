@@ -0,0 +1,19 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# SourceAnalyzer 缓存查找吞吐随线程数的变化；THREADS 为要测的线程数列表
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_OUTPUT="${BUILD_OUTPUT:-/tmp/bazel-deps-checker-lookup-benchmark}"
+CXX="${CXX:-clang++}"
+THREADS="${THREADS:-1 2 4 8}"
+
+echo "[1/2] Compiling lookup benchmark..."
+"$CXX" -std=c++17 -O2 -Wall -Wextra -Wpedantic \
+  -I"$ROOT_DIR/src/common" \
+  "$ROOT_DIR/scripts/lookup_benchmark.cpp" \
+  "$ROOT_DIR/src/common/concurrency/CacheBudget.cpp" \
+  -o "$BUILD_OUTPUT" -pthread
+
+echo "[2/2] Measuring lookups with threads: ${THREADS}"
+# shellcheck disable=SC2086
+"$BUILD_OUTPUT" $THREADS
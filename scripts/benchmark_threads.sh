@@ -0,0 +1,118 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# 分析阶段随 BAZEL_DEPS_CHECKER_THREADS 的伸缩：每个线程数、每种模式各跑 SAMPLES 次，报告中位数与相对第一个线程数的加速比，
+# 并确认各线程数下的报告一致。未指定 WORKSPACE_PATH 时生成一个带源码的合成工作区，用 --parser build-files 解析，不需要 bazel。
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_OUTPUT="${BUILD_OUTPUT:-/tmp/bazel-deps-analyzer}"
+CXX="${CXX:-clang++}"
+THREADS="${THREADS:-1 2 4 8}"
+SAMPLES="${SAMPLES:-3}"
+MODES="${MODES:-cycle scc fas unused}"
+WORK_DIR="${WORK_DIR:-/tmp/bazel-deps-checker-thread-benchmark}"
+TARGETS="${TARGETS:-3000}"
+EXTRA_DEPS="${EXTRA_DEPS:-2}"
+
+echo "[1/4] Compiling binary..."
+"$CXX" -std=c++17 -O2 -Wall -Wextra -Wpedantic \
+  -I"$ROOT_DIR/src" -I"$ROOT_DIR/src/common" -I"$ROOT_DIR/src/core" -I"$ROOT_DIR/src/runtime" -I"$ROOT_DIR/thirds" \
+  $(find "$ROOT_DIR/src" -name '*.cpp' | tr '\n' ' ') \
+  -o "$BUILD_OUTPUT" -pthread
+
+mkdir -p "$WORK_DIR"
+PARSER_ARGS=()
+if [[ -z "${WORKSPACE_PATH:-}" ]]; then
+  WORKSPACE_PATH="$WORK_DIR/workspace-${TARGETS}-${EXTRA_DEPS}"
+  echo "[2/4] Generating synthetic workspace (${TARGETS} targets) in ${WORKSPACE_PATH}..."
+  # t[i] 依赖 t[i+1]（首尾相连成一个大分量）再加 EXTRA_DEPS 条随机边；约三分之二的依赖在源码中真正被 include
+  python3 - "$WORKSPACE_PATH" "$TARGETS" "$EXTRA_DEPS" <<'PY'
+import os
+import random
+import sys
+
+root, count, extra = sys.argv[1], int(sys.argv[2]), int(sys.argv[3])
+if not os.path.exists(os.path.join(root, "MODULE.bazel")):
+    rng = random.Random(3)
+    packages = {}
+    for index in range(count):
+        package = f"m{index % 50}"
+        deps = [(index + 1) % count] + [rng.randrange(count) for _ in range(extra)]
+        includes = [f'#include "{package}/t{index}.h"']
+        includes += [f'#include "m{dep % 50}/t{dep}.h"' for dep in deps if rng.randrange(3)]
+        os.makedirs(os.path.join(root, package), exist_ok=True)
+        with open(os.path.join(root, package, f"t{index}.cc"), "w") as source:
+            source.write("\n".join(includes) + "\n" + "/" * 2000 + f"\nint f{index}() {{ return 0; }}\n")
+        with open(os.path.join(root, package, f"t{index}.h"), "w") as header:
+            header.write(f"#pragma once\nint f{index}();\n")
+        dep_labels = ", ".join(f'"//m{dep % 50}:t{dep}"' for dep in deps)
+        packages.setdefault(package, []).append(
+            f'cc_library(\n    name = "t{index}",\n    srcs = ["t{index}.cc"],\n'
+            f'    hdrs = ["t{index}.h"],\n    deps = [{dep_labels}],\n)\n')
+    for package, rules in packages.items():
+        with open(os.path.join(root, package, "BUILD"), "w") as build:
+            build.write("\n".join(rules))
+    open(os.path.join(root, "MODULE.bazel"), "w").close()
+PY
+  PARSER_ARGS=(--parser build-files)
+else
+  echo "[2/4] Using workspace ${WORKSPACE_PATH}..."
+fi
+
+# 解析结果与依赖图快照放在独立目录，预热后每次测量只包含分析阶段（源码分析缓存是进程内的，每次都是冷的）
+export BAZEL_DEPS_CHECKER_CACHE_DIR="$WORK_DIR/cache"
+
+mode_args() {
+  case "$1" in
+    cycle) echo "--cycle-report cycles" ;;
+    scc) echo "--cycle-report scc" ;;
+    fas) echo "--cycle-report fas" ;;
+    unused) echo "--unused" ;;
+    *) echo "unknown mode: $1" >&2; return 1 ;;
+  esac
+}
+
+run_once() {
+  local threads="$1" mode="$2" output="$3"
+  local start_ns end_ns
+  start_ns="$(date +%s%N)"
+  # shellcheck disable=SC2046
+  BAZEL_DEPS_CHECKER_THREADS="$threads" "$BUILD_OUTPUT" -w "$WORKSPACE_PATH" "${PARSER_ARGS[@]}" \
+    $(mode_args "$mode") -f json -o "$output" >/dev/null 2>&1
+  end_ns="$(date +%s%N)"
+  echo $(( (end_ns - start_ns) / 1000000 ))
+}
+
+echo "[3/4] Warming up parse and graph snapshots..."
+for mode in $MODES; do
+  run_once 1 "$mode" "$WORK_DIR/warmup-${mode}.json" >/dev/null
+done
+
+echo "[4/4] Measuring thread counts: ${THREADS} (${SAMPLES} samples each)"
+for mode in $MODES; do
+  values=()
+  for threads in $THREADS; do
+    samples=()
+    for _ in $(seq 1 "$SAMPLES"); do
+      samples+=("$(run_once "$threads" "$mode" "$WORK_DIR/${mode}-${threads}.json")")
+    done
+    values+=("${threads}:$(IFS=,; echo "${samples[*]}")")
+    if ! diff -q <(grep -v '"timestamp"' "$WORK_DIR/warmup-${mode}.json") \
+                 <(grep -v '"timestamp"' "$WORK_DIR/${mode}-${threads}.json") >/dev/null; then
+      echo "  ${mode}: report with ${threads} threads differs from the single-thread report" >&2
+      exit 1
+    fi
+  done
+
+  python3 - "$mode" "${values[@]}" <<'PY'
+import statistics
+import sys
+
+mode = sys.argv[1]
+base = None
+for entry in sys.argv[2:]:
+    threads, samples = entry.split(":")
+    median = statistics.median(float(value) for value in samples.split(","))
+    base = base or median
+    print(f"{mode:<7} threads={threads:<3} median {median:8.0f} ms   speedup x{base / median:.2f}")
+PY
+done
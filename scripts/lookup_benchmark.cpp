@@ -0,0 +1,148 @@
+// SourceAnalyzer 缓存的查找吞吐：分段表与单把互斥锁的 unordered_map 在不同线程数下的对比。
+// 路径缓存是 ConcurrentMap<std::string, std::string>，依赖判定缓存是 BoundedConcurrentMap<std::uint64_t, bool>，
+// 键的规模与形态和真实工作区相近；每一轮的总查找次数固定，线程越多每个线程分到的越少，
+// 每种组合跑 kRepeats 轮取最快的一轮，减少共享机器上的抖动。
+//
+// 用法：lookup_benchmark [线程数...]，默认 1 2 4 8
+
+#include "concurrency/BoundedConcurrentMap.h"
+#include "concurrency/ConcurrentMap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr size_t kKeyCount = 100000;
+constexpr size_t kLookupsPerRound = 4000000;
+// 互质步长打散访问顺序，各线程从不同偏移开始
+constexpr size_t kStride = 7919;
+constexpr int kRepeats = 3;
+
+// 把 kLookupsPerRound 次查找平分给 threads 个线程，返回每秒百万次查找
+template <typename Lookup>
+double MeasureRound(unsigned threads, Lookup& lookup) {
+    const size_t per_thread = kLookupsPerRound / threads;
+    std::vector<size_t> hits(threads, 0);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned index = 0; index < threads; ++index) {
+        workers.emplace_back([&, index] {
+            size_t hit = 0;
+            for (size_t i = 0; i < per_thread; ++i) {
+                hit += lookup((i * kStride + index * (kKeyCount / threads)) % kKeyCount) ? 1 : 0;
+            }
+            hits[index] = hit;
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (size_t hit : hits) {
+        if (hit != per_thread) {
+            std::fprintf(stderr, "lookup missed: %zu of %zu\n", per_thread - hit, per_thread);
+            std::exit(1);
+        }
+    }
+    return static_cast<double>(per_thread * threads) / seconds / 1e6;
+}
+
+template <typename Lookup>
+double MeasureLookups(unsigned threads, Lookup&& lookup) {
+    double best = 0;
+    for (int repeat = 0; repeat < kRepeats; ++repeat) {
+        best = std::max(best, MeasureRound(threads, lookup));
+    }
+    return best;
+}
+
+void PrintRow(const char* cache, unsigned threads, double mutex_rate, double sharded_rate, double sharded_base) {
+    std::printf("%-18s threads=%-3u single-mutex %6.2f M/s   sharded %6.2f M/s   sharded speedup x%.2f\n",
+                cache, threads, mutex_rate, sharded_rate, sharded_rate / sharded_base);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<unsigned> thread_counts;
+    for (int index = 1; index < argc; ++index) {
+        const int threads = std::atoi(argv[index]);
+        if (threads > 0) {
+            thread_counts.push_back(static_cast<unsigned>(threads));
+        }
+    }
+    if (thread_counts.empty()) {
+        thread_counts = {1, 2, 4, 8};
+    }
+    std::printf("hardware threads: %u, keys: %zu, lookups per round: %zu\n",
+                std::thread::hardware_concurrency(), kKeyCount, kLookupsPerRound);
+
+    // 路径缓存：工作区相对路径 -> 解析后的路径
+    std::vector<std::string> paths;
+    paths.reserve(kKeyCount);
+    for (size_t index = 0; index < kKeyCount; ++index) {
+        paths.push_back("src/pkg" + std::to_string(index % 300) + "/module" + std::to_string(index % 17) +
+                        "/file" + std::to_string(index) + ".h");
+    }
+    std::unordered_map<std::string, std::string> locked_paths;
+    std::mutex locked_paths_mutex;
+    ConcurrentMap<std::string, std::string> sharded_paths;
+    for (const std::string& path : paths) {
+        locked_paths.emplace(path, path);
+        sharded_paths.InsertOnce(path, path);
+    }
+
+    // 依赖判定缓存：打包的 (target, dependency) id -> 是否需要
+    std::vector<std::uint64_t> pairs;
+    pairs.reserve(kKeyCount);
+    for (size_t index = 0; index < kKeyCount; ++index) {
+        pairs.push_back(static_cast<std::uint64_t>(index / 8) << 32 | static_cast<std::uint32_t>(index * 31));
+    }
+    std::unordered_map<std::uint64_t, bool> locked_pairs;
+    std::mutex locked_pairs_mutex;
+    BoundedConcurrentMap<std::uint64_t, bool> sharded_pairs{"benchmark.dependency_needed"};
+    for (size_t index = 0; index < kKeyCount; ++index) {
+        locked_pairs.emplace(pairs[index], index % 3 == 0);
+        sharded_pairs.Insert(pairs[index], index % 3 == 0);
+    }
+
+    double path_base = 0;
+    double pair_base = 0;
+    for (unsigned threads : thread_counts) {
+        const double locked_path_rate = MeasureLookups(threads, [&](size_t index) {
+            std::lock_guard<std::mutex> lock(locked_paths_mutex);
+            return locked_paths.find(paths[index]) != locked_paths.end();
+        });
+        const double sharded_path_rate = MeasureLookups(threads, [&](size_t index) {
+            return sharded_paths.FindRef(paths[index]) != nullptr;
+        });
+        if (path_base == 0) {
+            path_base = sharded_path_rate;
+        }
+        PrintRow("path cache", threads, locked_path_rate, sharded_path_rate, path_base);
+
+        const double locked_pair_rate = MeasureLookups(threads, [&](size_t index) {
+            std::lock_guard<std::mutex> lock(locked_pairs_mutex);
+            return locked_pairs.find(pairs[index]) != locked_pairs.end();
+        });
+        const double sharded_pair_rate = MeasureLookups(threads, [&](size_t index) {
+            bool needed = false;
+            return sharded_pairs.Find(pairs[index], needed);
+        });
+        if (pair_base == 0) {
+            pair_base = sharded_pair_rate;
+        }
+        PrintRow("dependency needed", threads, locked_pair_rate, sharded_pair_rate, pair_base);
+    }
+    return 0;
+}
@@ -26,6 +26,8 @@ CommandLineArgs CommandLineArgs::Parse(int argc, char* argv[]) {
             args.workspace_path = RequireValue(argc, argv, index, option);
         } else if (option == "--unused" || option == "-u") {
             args.execute_function = ExcuteFuction::UNUSED_DEPENDENCY_CHECK;
+        } else if (option == "--reduce" || option == "-r") {
+            args.execute_function = ExcuteFuction::TRANSITIVE_REDUCTION;
         } else if (option == "--time" || option == "-T") {
             args.execute_function = ExcuteFuction::BUILD_TIME_ANALYZE;
         } else if (option == "--bazel_path" || option == "-b") {
@@ -34,8 +36,18 @@ CommandLineArgs CommandLineArgs::Parse(int argc, char* argv[]) {
             args.output_path = RequireValue(argc, argv, index, option);
         } else if (option == "--format" || option == "-f") {
             args.output_format = ParseOutputFormat(RequireValue(argc, argv, index, option));
+        } else if (option == "--parser") {
+            args.parse_strategy = ParseParseStrategy(RequireValue(argc, argv, index, option));
         } else if (option == "--port") {
             args.SetPort(RequireValue(argc, argv, index, option));
+        } else if (option == "--graph-snapshot") {
+            args.graph_snapshot_path = RequireValue(argc, argv, index, option);
+        } else if (option == "--cycle-report") {
+            args.cycle_report_mode = ParseCycleReportMode(RequireValue(argc, argv, index, option));
+        } else if (option == "--max-cycles") {
+            args.SetMaxCycles(RequireValue(argc, argv, index, option));
+        } else if (option == "--cycle-timeout") {
+            args.SetCycleTimeout(RequireValue(argc, argv, index, option));
         } else if (option == "--verbose" || option == "-v") {
             args.verbose = true;
         } else if (option == "--ui") {
@@ -61,10 +73,19 @@ void CommandLineArgs::PrintHelp(std::ostream& os) {
     os << "  -w, --workspace PATH    Bazel workspace path (required unless --ui)\n";
     os << "  -b, --bazel_path PATH   Bazel executable path\n";
     os << "  -u, --unused            Analyze unused dependencies\n";
+    os << "  -r, --reduce            Find dependency edges already implied by other deps (transitive reduction)\n";
     os << "  -t, --tests             Include test targets in analysis\n";
     os << "  -T, --time              Analyze build time\n";
     os << "  -o, --output FILE       Output file path\n";
     os << "  -f, --format FORMAT     Output format: console, markdown, json, html\n";
+    os << "      --parser MODE       Target extraction: query (default), build-files\n";
+    os << "      --graph-snapshot FILE\n";
+    os << "                          Load the dependency graph from FILE when it matches the BUILD files,\n";
+    os << "                          otherwise parse the workspace and write FILE\n";
+    os << "      --cycle-report MODE Cycle report: cycles (default), scc (per-component summary),\n";
+    os << "                          fas (smallest-cost edge set that breaks all cycles)\n";
+    os << "      --max-cycles N      Cycles listed per strongly connected component (default: 1000, 0 = no limit)\n";
+    os << "      --cycle-timeout SEC Time limit for cycle enumeration (default: 30)\n";
     os << "      --ui                Start local web UI server\n";
     os << "      --port PORT         Web UI port (default: 8080)\n";
     os << "  -v, --verbose           Enable verbose logging\n";
@@ -73,7 +94,11 @@ void CommandLineArgs::PrintHelp(std::ostream& os) {
     os << "  bazel-deps-analyzer -w /path/to/workspace\n";
     os << "  bazel-deps-analyzer -w . --unused -f json -o unused.json\n";
     os << "  bazel-deps-analyzer -w . -t -f markdown -o report.md\n";
+    os << "  bazel-deps-analyzer -w . --reduce -f json -o redundant.json\n";
     os << "  bazel-deps-analyzer -w . -T -f json -o build-time.json\n";
+    os << "  bazel-deps-analyzer -w . --parser build-files\n";
+    os << "  bazel-deps-analyzer -w . --graph-snapshot deps.graph\n";
+    os << "  bazel-deps-analyzer -w . --cycle-report scc -f markdown -o scc.md\n";
     os << "  bazel-deps-analyzer --ui --port 8080\n";
     os << "  bazel-deps-analyzer -w . --ui\n";
 }
@@ -95,6 +120,47 @@ OutputFormat CommandLineArgs::ParseOutputFormat(const std::string& format_str) {
     throw std::invalid_argument("Unknown output format: " + format_str);
 }
 
+ParseStrategy CommandLineArgs::ParseParseStrategy(const std::string& strategy_str) {
+    if (strategy_str == "query") {
+        return ParseStrategy::BAZEL_QUERY;
+    }
+    if (strategy_str == "build-files") {
+        return ParseStrategy::BUILD_FILE_READER;
+    }
+
+    throw std::invalid_argument("Unknown parser: " + strategy_str);
+}
+
+std::string CommandLineArgs::ParseStrategyToString(ParseStrategy strategy) {
+    return strategy == ParseStrategy::BUILD_FILE_READER ? "build-files" : "query";
+}
+
+CycleReportMode CommandLineArgs::ParseCycleReportMode(const std::string& mode_str) {
+    if (mode_str == "cycles") {
+        return CycleReportMode::CYCLES;
+    }
+    if (mode_str == "scc") {
+        return CycleReportMode::SCC_SUMMARY;
+    }
+    if (mode_str == "fas") {
+        return CycleReportMode::FEEDBACK_ARCS;
+    }
+
+    throw std::invalid_argument("Unknown cycle report mode: " + mode_str);
+}
+
+std::string CommandLineArgs::CycleReportModeToString(CycleReportMode mode) {
+    switch (mode) {
+        case CycleReportMode::SCC_SUMMARY:
+            return "scc";
+        case CycleReportMode::FEEDBACK_ARCS:
+            return "fas";
+        case CycleReportMode::CYCLES:
+            break;
+    }
+    return "cycles";
+}
+
 std::string CommandLineArgs::RequireValue(int argc, char* argv[], int& index, const std::string& option) {
     if (index + 1 >= argc) {
         throw std::invalid_argument("Missing value for option: " + option);
@@ -116,6 +182,32 @@ void CommandLineArgs::SetPort(const std::string& port_str) {
     }
 }
 
+void CommandLineArgs::SetMaxCycles(const std::string& count_str) {
+    long long count = -1;
+    try {
+        count = std::stoll(count_str);
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Invalid cycle limit: " + count_str);
+    }
+
+    if (count < 0) {
+        throw std::invalid_argument("Cycle limit must not be negative");
+    }
+    max_cycles_per_scc = static_cast<size_t>(count);
+}
+
+void CommandLineArgs::SetCycleTimeout(const std::string& seconds_str) {
+    try {
+        cycle_timeout_seconds = std::stoi(seconds_str);
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Invalid cycle timeout: " + seconds_str);
+    }
+
+    if (cycle_timeout_seconds <= 0) {
+        throw std::invalid_argument("Cycle timeout must be positive");
+    }
+}
+
 void CommandLineArgs::Validate() const {
     if (workspace_path.empty()) {
         if (ui_mode) {
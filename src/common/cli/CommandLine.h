@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <exception>
 #include <iosfwd>
 #include <string>
@@ -21,16 +22,27 @@ public:
     std::string workspace_path{};
     std::string output_path{};
     std::string bazel_binary{"bazel"};
+    std::string graph_snapshot_path{};   // 依赖图快照文件，为空时使用缓存目录
     OutputFormat output_format{OutputFormat::CONSOLE};
+    ParseStrategy parse_strategy{ParseStrategy::BAZEL_QUERY};
     int port{8080};
     bool verbose{false};
     bool ui_mode{false};
     bool include_tests{false};
+    size_t max_cycles_per_scc{1000};   // 每个强连通分量最多枚举的环数，0 表示不限
+    int cycle_timeout_seconds{30};     // 环枚举的总耗时上限
+    CycleReportMode cycle_report_mode{CycleReportMode::CYCLES};
     ExcuteFuction execute_function{ExcuteFuction::CYCLIC_DEPENDENCY_DETECTION};
 
     static OutputFormat ParseOutputFormat(const std::string& format_str);
+    static ParseStrategy ParseParseStrategy(const std::string& strategy_str);
+    static std::string ParseStrategyToString(ParseStrategy strategy);
+    static CycleReportMode ParseCycleReportMode(const std::string& mode_str);
+    static std::string CycleReportModeToString(CycleReportMode mode);
     static std::string RequireValue(int argc, char* argv[], int& index, const std::string& option);
 
     void SetPort(const std::string& port_str);
+    void SetMaxCycles(const std::string& count_str);
+    void SetCycleTimeout(const std::string& seconds_str);
     void Validate() const;
 };
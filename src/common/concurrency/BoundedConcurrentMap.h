@@ -0,0 +1,266 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "concurrency/CacheBudget.h"
+#include "concurrency/ShardedHash.h"
+
+// 受全局内存预算约束的分段加锁哈希表，用于可重新计算的分析备忘表。
+// 分段方式与 ConcurrentMap 相同；每个条目按估算大小记入 CacheBudget，超出预算时按 CLOCK 淘汰：
+// 命中会置位访问标记，淘汰指针扫过已置位的条目时清除标记并跳过，扫到未置位的条目即淘汰。
+//
+// 条目随时可能被淘汰，因此只提供按值返回的接口，调用方在未命中时重新计算即可；
+// GetOrCompute 与 ConcurrentMap 一样在锁外计算，compute 必须是幂等的。
+// 分段锁是叶子锁：持有分段锁时不调用预算，ForEach 的 visitor 也在锁外执行。
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class BoundedConcurrentMap final : public BudgetedCache {
+public:
+    static constexpr size_t kShardCount = ShardedHash::kShardCount;
+
+    // 值持有的堆内存（不含 sizeof(Value)）；为空时只按定长部分记账
+    using ValueBytes = size_t (*)(const Value&);
+
+    explicit BoundedConcurrentMap(std::string name, ValueBytes value_bytes = nullptr)
+        : name_(std::move(name)), value_bytes_(value_bytes) {
+        CacheBudget::Instance().Register(this);
+    }
+
+    ~BoundedConcurrentMap() override {
+        CacheBudget::Instance().Unregister(this);
+        CacheBudget::Instance().Release(bytes_.load(std::memory_order_relaxed));
+    }
+
+    BoundedConcurrentMap(const BoundedConcurrentMap&) = delete;
+    BoundedConcurrentMap& operator=(const BoundedConcurrentMap&) = delete;
+
+    bool Find(const Key& key, Value& value) const {
+        const Shard& shard = ShardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            ++shard.misses;
+            return false;
+        }
+        it->second.referenced = true;
+        value = it->second.value;
+        ++shard.hits;
+        return true;
+    }
+
+    // 键已存在时保留原值；返回表中最终的值
+    Value Insert(const Key& key, Value value) {
+        Shard& shard = ShardFor(key);
+        size_t charged = 0;
+        Value result;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            const auto [it, inserted] = shard.entries.try_emplace(key);
+            if (inserted) {
+                charged = EntryBytes(value);
+                it->second.value = std::move(value);
+                it->second.bytes = charged;
+                it->second.slot = shard.ring.size();
+                shard.ring.push_back(&*it);
+            }
+            result = it->second.value;
+        }
+        if (charged != 0) {
+            entries_.fetch_add(1, std::memory_order_relaxed);
+            bytes_.fetch_add(charged, std::memory_order_relaxed);
+            CacheBudget::Instance().Charge(charged);
+        }
+        return result;
+    }
+
+    template <typename Compute>
+    Value GetOrCompute(const Key& key, Compute&& compute) {
+        Value value;
+        if (Find(key, value)) {
+            return value;
+        }
+        return Insert(key, compute());
+    }
+
+    void Erase(const Key& key) {
+        Shard& shard = ShardFor(key);
+        size_t released = 0;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            const auto it = shard.entries.find(key);
+            if (it != shard.entries.end()) {
+                released = RemoveLocked(shard, &*it);
+            }
+        }
+        Released(released, released != 0 ? 1 : 0);
+    }
+
+    template <typename Predicate>
+    void EraseIf(Predicate&& predicate) {
+        for (Shard& shard : shards_) {
+            size_t released = 0;
+            size_t removed = 0;
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for (size_t slot = shard.ring.size(); slot-- > 0;) {
+                    if (predicate(shard.ring[slot]->first)) {
+                        released += RemoveLocked(shard, shard.ring[slot]);
+                        ++removed;
+                    }
+                }
+            }
+            Released(released, removed);
+        }
+    }
+
+    void Clear() {
+        for (Shard& shard : shards_) {
+            size_t released = 0;
+            size_t removed = 0;
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for (const Node* node : shard.ring) {
+                    released += node->second.bytes;
+                }
+                removed = shard.ring.size();
+                shard.ring.clear();
+                shard.entries.clear();
+                shard.hand = 0;
+            }
+            Released(released, removed);
+        }
+    }
+
+    // 逐段复制后在锁外调用 visitor(key, value)，visitor 可以访问任意缓存
+    template <typename Visitor>
+    void ForEach(Visitor&& visitor) const {
+        std::vector<std::pair<Key, Value>> entries;
+        for (const Shard& shard : shards_) {
+            entries.clear();
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                entries.reserve(shard.entries.size());
+                for (const auto& entry : shard.entries) {
+                    entries.emplace_back(entry.first, entry.second.value);
+                }
+            }
+            for (const auto& [key, value] : entries) {
+                visitor(key, value);
+            }
+        }
+    }
+
+    size_t Size() const { return entries_.load(std::memory_order_relaxed); }
+
+    size_t Evict(size_t bytes) override {
+        const size_t quota = bytes / kShardCount + 1;
+        size_t freed = 0;
+        for (size_t round = 0; round < kShardCount && freed < bytes; ++round) {
+            Shard& shard = shards_[next_shard_.fetch_add(1, std::memory_order_relaxed) % kShardCount];
+            size_t released = 0;
+            size_t removed = 0;
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                // 每个条目最多被跳过一次，因此两圈之内必能淘汰到 quota 或清空分段
+                while (released < quota && !shard.ring.empty()) {
+                    if (shard.hand >= shard.ring.size()) {
+                        shard.hand = 0;
+                    }
+                    Node* node = shard.ring[shard.hand];
+                    if (node->second.referenced) {
+                        node->second.referenced = false;
+                        ++shard.hand;
+                        continue;
+                    }
+                    // 末尾条目换到当前位置，指针不前进
+                    released += RemoveLocked(shard, node);
+                    ++removed;
+                }
+            }
+            Released(released, removed);
+            evictions_.fetch_add(removed, std::memory_order_relaxed);
+            freed += released;
+        }
+        return freed;
+    }
+
+    CacheStats Stats() const override {
+        CacheStats stats;
+        stats.name = name_;
+        stats.instances = 1;
+        stats.entries = Size();
+        stats.bytes = bytes_.load(std::memory_order_relaxed);
+        for (const Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            stats.hits += shard.hits;
+            stats.misses += shard.misses;
+        }
+        stats.evictions = evictions_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    // 哈希表节点、桶指针与 CLOCK 环中的指针，按 64 位平台粗略估计
+    static constexpr size_t kNodeOverhead = 48;
+
+    struct Entry {
+        Value value{};
+        size_t bytes{0};
+        size_t slot{0};                 // 在 ring 中的下标
+        mutable bool referenced{false};
+    };
+    using Node = std::pair<const Key, Entry>;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, Entry, Hash> entries;
+        std::vector<Node*> ring;        // CLOCK 环；节点地址在 rehash 后不变
+        size_t hand{0};
+        // 命中计数放在分段锁内，查找路径上没有所有线程共享的原子变量
+        mutable std::uint64_t hits{0};
+        mutable std::uint64_t misses{0};
+    };
+
+    size_t EntryBytes(const Value& value) const {
+        return sizeof(Key) + sizeof(Entry) + kNodeOverhead + (value_bytes_ != nullptr ? value_bytes_(value) : 0);
+    }
+
+    // 从环与哈希表中删除，返回释放的字节数；调用方持有分段锁
+    static size_t RemoveLocked(Shard& shard, Node* node) {
+        const size_t bytes = node->second.bytes;
+        const size_t slot = node->second.slot;
+        shard.ring[slot] = shard.ring.back();
+        shard.ring[slot]->second.slot = slot;
+        shard.ring.pop_back();
+        shard.entries.erase(shard.entries.find(node->first));
+        return bytes;
+    }
+
+    void Released(size_t bytes, size_t entries) {
+        if (bytes == 0 && entries == 0) {
+            return;
+        }
+        entries_.fetch_sub(entries, std::memory_order_relaxed);
+        bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+        CacheBudget::Instance().Release(bytes);
+    }
+
+    Shard& ShardFor(const Key& key) { return shards_[ShardedHash::Index<Hash>(key)]; }
+    const Shard& ShardFor(const Key& key) const { return shards_[ShardedHash::Index<Hash>(key)]; }
+
+    const std::string name_;
+    const ValueBytes value_bytes_;
+    std::array<Shard, kShardCount> shards_;
+    std::atomic<size_t> entries_{0};
+    std::atomic<size_t> bytes_{0};
+    std::atomic<std::uint64_t> evictions_{0};
+    std::atomic<size_t> next_shard_{0};  // 跨分段轮转淘汰的起点
+};
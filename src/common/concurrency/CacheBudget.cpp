@@ -0,0 +1,121 @@
+#include "CacheBudget.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <map>
+
+namespace {
+
+constexpr size_t kDefaultLimitMegabytes = 1024;
+// 单次向一个缓存索取的最小字节数，避免超出很少时在大量小缓存之间空转；预算很小时按预算的 1/64 取
+constexpr size_t kMinEvictBytes = 64 * 1024;
+
+size_t ConfiguredLimitBytes() {
+    if (const char* budget = std::getenv("BAZEL_DEPS_CHECKER_CACHE_BUDGET_MB"); budget != nullptr && budget[0] != '\0') {
+        try {
+            return static_cast<size_t>(std::stoull(budget)) << 20;
+        } catch (const std::exception&) {
+            // 非法值按默认处理
+        }
+    }
+    return kDefaultLimitMegabytes << 20;
+}
+
+}  // namespace
+
+CacheBudget::CacheBudget() : limit_bytes_(ConfiguredLimitBytes()) {}
+
+CacheBudget& CacheBudget::Instance() {
+    // 不随静态对象析构：进程退出时静态缓存中的表可能晚于预算析构，仍需注销
+    static CacheBudget* instance = new CacheBudget();
+    return *instance;
+}
+
+void CacheBudget::Register(BudgetedCache* cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    caches_.push_back(cache);
+}
+
+void CacheBudget::Unregister(BudgetedCache* cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = std::find(caches_.begin(), caches_.end(), cache);
+    if (it != caches_.end()) {
+        caches_.erase(it);
+    }
+}
+
+void CacheBudget::Charge(size_t bytes) {
+    const size_t used = used_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    const size_t limit = LimitBytes();
+    if (limit != 0 && used > limit) {
+        Reclaim();
+    }
+}
+
+void CacheBudget::Release(size_t bytes) {
+    used_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void CacheBudget::SetLimitBytes(size_t limit_bytes) {
+    limit_bytes_.store(limit_bytes, std::memory_order_relaxed);
+    if (limit_bytes != 0 && UsedBytes() > limit_bytes) {
+        Reclaim();
+    }
+}
+
+void CacheBudget::Reclaim() {
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+    reclaims_.fetch_add(1, std::memory_order_relaxed);
+
+    const size_t limit = LimitBytes();
+    const size_t target = limit - limit / 8;
+    const size_t min_evict = std::max<size_t>(std::min(kMinEvictBytes, limit / 64), 1);
+    // 一整轮所有缓存都没有可淘汰的条目时停止（例如超出的部分来自尚未记账完成的插入）
+    size_t idle_caches = 0;
+    while (!caches_.empty() && idle_caches < caches_.size()) {
+        const size_t used = UsedBytes();
+        if (used <= target) {
+            break;
+        }
+        if (next_cache_ >= caches_.size()) {
+            next_cache_ = 0;
+        }
+        const size_t share = std::max((used - target) / caches_.size(), min_evict);
+        if (caches_[next_cache_++]->Evict(share) == 0) {
+            ++idle_caches;
+        } else {
+            idle_caches = 0;
+        }
+    }
+}
+
+CacheBudget::Snapshot CacheBudget::GetSnapshot() const {
+    Snapshot snapshot;
+    snapshot.limit_bytes = LimitBytes();
+    snapshot.used_bytes = UsedBytes();
+    snapshot.reclaims = reclaims_.load(std::memory_order_relaxed);
+
+    std::map<std::string, CacheStats> by_name;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const BudgetedCache* cache : caches_) {
+            const CacheStats stats = cache->Stats();
+            CacheStats& merged = by_name[stats.name];
+            merged.name = stats.name;
+            merged.instances += 1;
+            merged.entries += stats.entries;
+            merged.bytes += stats.bytes;
+            merged.hits += stats.hits;
+            merged.misses += stats.misses;
+            merged.evictions += stats.evictions;
+        }
+    }
+    for (auto& [name, stats] : by_name) {
+        snapshot.caches.push_back(std::move(stats));
+    }
+    return snapshot;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 单个缓存的记账信息；同名缓存（例如多个工作区上下文各自的同一张表）在快照中合并为一项
+struct CacheStats {
+    std::string name;
+    size_t instances{0};
+    size_t entries{0};
+    size_t bytes{0};            // 估算值：键值本身、值持有的堆内存与哈希表节点开销
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+    std::uint64_t evictions{0};
+};
+
+// 可被全局预算回收的缓存
+class BudgetedCache {
+public:
+    virtual ~BudgetedCache() = default;
+    // 淘汰约 bytes 字节的条目，返回实际释放的字节数
+    virtual size_t Evict(size_t bytes) = 0;
+    // 只读原子计数，不加分段锁
+    virtual CacheStats Stats() const = 0;
+};
+
+// 进程内所有可淘汰的分析缓存共享的内存预算。
+//
+// 缓存插入新条目时调用 Charge 记账，总量超过上限后由插入线程回收到上限的 7/8：
+// 在已注册的缓存之间轮转，每个缓存按自己的 CLOCK 顺序淘汰最近未被访问的条目。
+// 长期未使用的工作区上下文里的条目没有访问标记，会先于正在使用的条目被淘汰。
+//
+// 上限默认 1 GiB，可用环境变量 BAZEL_DEPS_CHECKER_CACHE_BUDGET_MB 指定，0 表示不限。
+// 锁顺序：预算锁 -> 缓存分段锁；缓存在持有分段锁时不会调用本类，因此回收不会与插入互相等待
+class CacheBudget {
+public:
+    struct Snapshot {
+        size_t limit_bytes{0};
+        size_t used_bytes{0};
+        std::uint64_t reclaims{0};      // 触发回收的次数
+        std::vector<CacheStats> caches; // 按名称排序
+    };
+
+    static CacheBudget& Instance();
+
+    CacheBudget(const CacheBudget&) = delete;
+    CacheBudget& operator=(const CacheBudget&) = delete;
+
+    void Register(BudgetedCache* cache);
+    // 返回后回收不会再访问该缓存
+    void Unregister(BudgetedCache* cache);
+
+    // 记入新增条目；超出上限时在调用线程上回收
+    void Charge(size_t bytes);
+    void Release(size_t bytes);
+
+    size_t LimitBytes() const { return limit_bytes_.load(std::memory_order_relaxed); }
+    size_t UsedBytes() const { return used_bytes_.load(std::memory_order_relaxed); }
+    // 调小上限时立即回收
+    void SetLimitBytes(size_t limit_bytes);
+
+    Snapshot GetSnapshot() const;
+
+private:
+    CacheBudget();
+
+    // 同一时刻只有一个线程回收，其他超限的插入线程直接返回
+    void Reclaim();
+
+    std::atomic<size_t> limit_bytes_;
+    std::atomic<size_t> used_bytes_{0};
+    std::atomic<std::uint64_t> reclaims_{0};
+
+    mutable std::mutex mutex_;              // 保护 caches_ 与 next_cache_，回收期间一直持有
+    std::vector<BudgetedCache*> caches_;
+    size_t next_cache_{0};                  // 跨缓存轮转的起点
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "concurrency/ShardedHash.h"
+
+// 分段加锁的哈希表：键按哈希分到固定数量的分段，每段一把锁，不同分段上的读写互不阻塞。
+// 适合“算一次、读多次”的分析缓存：值只插入一次，已存在的键不会被覆盖。
+// GetOrCompute 在锁外计算，两个线程同时未命中时都会计算，先写入的结果胜出，因此 compute 必须是幂等的。
+//
+// Find / Insert / GetOrCompute 以拷贝返回值；FindRef / InsertOnce 返回表内元素的地址，
+// 元素是节点式存储，扩容不移动，在被 Erase / EraseIf / Clear 删除之前一直有效，调用方需保证删除不与读取并发。
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ConcurrentMap {
+public:
+    static constexpr size_t kShardCount = ShardedHash::kShardCount;
+
+    bool Find(const Key& key, Value& value) const {
+        const Shard& shard = ShardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    const Value* FindRef(const Key& key) const {
+        const Shard& shard = ShardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto it = shard.entries.find(key);
+        return it == shard.entries.end() ? nullptr : &it->second;
+    }
+
+    // 键已存在时保留原值；返回表中最终的元素
+    const Value& InsertOnce(const Key& key, Value value) {
+        Shard& shard = ShardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.entries.emplace(key, std::move(value)).first->second;
+    }
+
+    Value Insert(const Key& key, Value value) { return InsertOnce(key, std::move(value)); }
+
+    template <typename Compute>
+    Value GetOrCompute(const Key& key, Compute&& compute) {
+        Value value;
+        if (Find(key, value)) {
+            return value;
+        }
+        return Insert(key, compute());
+    }
+
+    void Erase(const Key& key) {
+        Shard& shard = ShardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.erase(key);
+    }
+
+    template <typename Predicate>
+    void EraseIf(Predicate&& predicate) {
+        for (Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+                it = predicate(it->first) ? shard.entries.erase(it) : std::next(it);
+            }
+        }
+    }
+
+    void Clear() {
+        for (Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.entries.clear();
+        }
+    }
+
+    // 逐段加锁遍历，visitor(key, value) 在段锁内调用，不能再访问本表
+    template <typename Visitor>
+    void ForEach(Visitor&& visitor) const {
+        for (const Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const auto& entry : shard.entries) {
+                visitor(entry.first, entry.second);
+            }
+        }
+    }
+
+    size_t Size() const {
+        size_t size = 0;
+        for (const Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            size += shard.entries.size();
+        }
+        return size;
+    }
+
+private:
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, Value, Hash> entries;
+    };
+
+    Shard& ShardFor(const Key& key) { return shards_[ShardedHash::Index<Hash>(key)]; }
+    const Shard& ShardFor(const Key& key) const { return shards_[ShardedHash::Index<Hash>(key)]; }
+
+    std::array<Shard, kShardCount> shards_;
+};
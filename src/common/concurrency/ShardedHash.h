@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// ConcurrentMap 与 BoundedConcurrentMap 共用的分段规则：固定 64 个分段，分段下标取乘法散列的高 6 位。
+// 整数键的 std::hash 是恒等映射，直接取模会让分段只由键的低位决定，乘以 2^64 / φ 后高位混合了全部位。
+struct ShardedHash {
+    static constexpr unsigned kShardBits = 6;
+    static constexpr size_t kShardCount = size_t{1} << kShardBits;
+
+    template <typename Hash, typename Key>
+    static size_t Index(const Key& key) {
+        return static_cast<size_t>((static_cast<std::uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ULL) >>
+                                   (64 - kShardBits));
+    }
+};
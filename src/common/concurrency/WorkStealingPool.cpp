@@ -0,0 +1,200 @@
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <string>
+
+namespace {
+
+// 外部线程（非工作线程）的队列下标
+constexpr size_t kExternalThread = static_cast<size_t>(-1);
+// 每个并发单位平均分到的块数，块越多负载越均衡，调度开销也越大
+constexpr size_t kChunksPerThread = 4;
+// 等待任务完成时没有可窃取的任务，短暂休眠后重新检查
+constexpr std::chrono::milliseconds kHelpPollInterval{1};
+
+thread_local size_t current_worker = kExternalThread;
+
+size_t ConfiguredWorkerCount() {
+    if (const char* threads = std::getenv("BAZEL_DEPS_CHECKER_THREADS"); threads != nullptr && threads[0] != '\0') {
+        try {
+            const unsigned long value = std::stoul(threads);
+            return value > 1 ? static_cast<size_t>(value - 1) : 0;
+        } catch (const std::exception&) {
+            // 非法值按默认处理
+        }
+    }
+    const unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 0;
+}
+
+}  // namespace
+
+struct WorkStealingPool::Job {
+    const std::function<void(size_t)>* body;
+    std::atomic<size_t> remaining{0};   // 尚未完成的块数
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    std::exception_ptr error;
+};
+
+WorkStealingPool& WorkStealingPool::Instance() {
+    static WorkStealingPool instance(ConfiguredWorkerCount());
+    return instance;
+}
+
+WorkStealingPool::WorkStealingPool(size_t worker_count) {
+    workers_.reserve(worker_count);
+    for (size_t index = 0; index < worker_count; ++index) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    // 全部队列建好后再启动线程，窃取时不会看到半初始化的 workers_
+    for (size_t index = 0; index < worker_count; ++index) {
+        workers_[index]->thread = std::thread([this, index] { WorkerLoop(index); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void WorkStealingPool::ParallelFor(size_t count, const std::function<void(size_t)>& body, size_t grain) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunk = std::max(grain, count / (Concurrency() * kChunksPerThread));
+    if (workers_.empty() || count <= chunk) {
+        for (size_t index = 0; index < count; ++index) {
+            body(index);
+        }
+        return;
+    }
+
+    Job job;
+    job.body = &body;
+    const size_t chunk_count = (count + chunk - 1) / chunk;
+    job.remaining.store(chunk_count, std::memory_order_relaxed);
+
+    // 工作线程把块放进自己的队列（其他线程来窃取），外部线程按轮转分散到各队列
+    const size_t self = current_worker;
+    size_t queue = self != kExternalThread ? self : next_queue_.fetch_add(1, std::memory_order_relaxed);
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        Worker& worker = *workers_[queue % workers_.size()];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.tasks.push_back(Task{&job, begin, std::min(count, begin + chunk)});
+        }
+        queued_.fetch_add(1, std::memory_order_release);
+        if (self == kExternalThread) {
+            ++queue;
+        }
+    }
+    {
+        // 持锁后再通知，避免工作线程在检查 queued_ 与进入等待之间错过唤醒
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    sleep_cv_.notify_all();
+
+    // 调用线程一边等待一边执行任务（可能属于其他 Job），直到本 Job 的块全部完成
+    while (job.remaining.load(std::memory_order_acquire) != 0) {
+        if (RunOneTask(self)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(job.mutex);
+        job.done_cv.wait_for(lock, kHelpPollInterval,
+                             [&job] { return job.remaining.load(std::memory_order_acquire) == 0; });
+    }
+
+    // 最后一个块递减计数时持有 job.mutex，拿到锁说明它已离开 Execute，job 可以安全销毁
+    std::lock_guard<std::mutex> lock(job.mutex);
+    if (job.error) {
+        std::rethrow_exception(job.error);
+    }
+}
+
+void WorkStealingPool::WorkerLoop(size_t index) {
+    current_worker = index;
+    while (true) {
+        if (RunOneTask(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [this] { return stopping_ || queued_.load(std::memory_order_acquire) != 0; });
+        if (stopping_) {
+            return;
+        }
+    }
+}
+
+bool WorkStealingPool::RunOneTask(size_t self) {
+    Task task;
+    if (!PopTask(self, task)) {
+        return false;
+    }
+    queued_.fetch_sub(1, std::memory_order_acq_rel);
+    Execute(task);
+    return true;
+}
+
+bool WorkStealingPool::PopTask(size_t self, Task& task) {
+    if (self != kExternalThread) {
+        Worker& own = *workers_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    if (queued_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    const size_t start = self != kExternalThread ? self + 1 : 0;
+    for (size_t offset = 0; offset < workers_.size(); ++offset) {
+        const size_t victim = (start + offset) % workers_.size();
+        if (victim == self) {
+            continue;
+        }
+        Worker& worker = *workers_[victim];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.tasks.empty()) {
+            task = worker.tasks.front();
+            worker.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::Execute(const Task& task) {
+    Job& job = *task.job;
+    try {
+        for (size_t index = task.begin; index < task.end; ++index) {
+            (*job.body)(index);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (!job.error) {
+            job.error = std::current_exception();
+        }
+    }
+
+    // 计数在锁内递减：等待方看到 0 之后还要获取一次该锁，确保这里不再访问 job
+    std::lock_guard<std::mutex> lock(job.mutex);
+    if (job.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        job.done_cv.notify_all();
+    }
+}
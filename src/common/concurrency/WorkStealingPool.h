@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 进程内共享的工作窃取线程池：每个工作线程有自己的任务队列，空闲时从其他线程的队列窃取。
+// 自己的任务与窃取的任务都从队首取，各块大致按下标顺序开始执行，调用方可以借此安排执行顺序
+// （例如按逆拓扑序排列目标，让依赖先于依赖者被分析）。ParallelFor 的调用线程同样参与执行，
+// 因此任务内部可以再次调用 ParallelFor 而不会因线程耗尽而死锁。
+//
+// 工作线程数默认为 hardware_concurrency - 1（调用线程补足一个），
+// 可用环境变量 BAZEL_DEPS_CHECKER_THREADS 指定总并发数，1 表示全部在调用线程上串行执行。
+class WorkStealingPool {
+public:
+    static WorkStealingPool& Instance();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    ~WorkStealingPool();
+
+    // 总并发数（工作线程数 + 调用线程）
+    size_t Concurrency() const { return workers_.size() + 1; }
+
+    // 对 [0, count) 的每个下标调用 body，全部完成后返回。区间按 grain 及并发数切块；
+    // body 抛出的第一个异常在所有块结束后于调用线程重新抛出
+    void ParallelFor(size_t count, const std::function<void(size_t)>& body, size_t grain = 1);
+
+private:
+    struct Job;
+    struct Task {
+        Job* job;
+        size_t begin;
+        size_t end;
+    };
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    explicit WorkStealingPool(size_t worker_count);
+
+    void WorkerLoop(size_t index);
+    // 取一个任务执行：先取本线程队列，再从其他队列窃取；没有可执行任务时返回 false
+    bool RunOneTask(size_t self);
+    bool PopTask(size_t self, Task& task);
+    static void Execute(const Task& task);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> queued_{0};          // 所有队列中尚未取走的任务数
+    std::atomic<size_t> next_queue_{0};      // 外部线程提交任务时轮转的起始队列
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    bool stopping_{false};
+};
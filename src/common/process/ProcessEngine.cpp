@@ -0,0 +1,622 @@
+#include "ProcessEngine.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// SIGTERM 之后等待子进程自行退出的时间
+constexpr std::chrono::milliseconds kTerminateGracePeriod{2000};
+// 输出已关闭但尚未被回收的子进程，按此间隔检查退出状态
+constexpr std::chrono::milliseconds kReapInterval{10};
+// 转交给 Run 调用线程但尚未取走的 stdout 上限，超过后暂停读取该子进程的管道，由管道反压子进程
+constexpr size_t kStdoutBacklogLimit = 16 * 1024 * 1024;
+
+void CloseFd(int& fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+std::string DescribeCommand(const std::vector<std::string>& argv) {
+    std::string text;
+    for (const auto& arg : argv) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += arg;
+    }
+    return text;
+}
+
+// 按换行切分后逐行回调；块末尾没有换行的部分（输出的最后一行）同样回调
+void ForEachLine(std::string_view block, const std::function<void(std::string_view)>& on_line) {
+    size_t line_start = 0;
+    while (line_start < block.size()) {
+        const size_t line_end = block.find('\n', line_start);
+        if (line_end == std::string_view::npos) {
+            on_line(block.substr(line_start));
+            return;
+        }
+        on_line(block.substr(line_start, line_end - line_start));
+        line_start = line_end + 1;
+    }
+}
+
+}  // namespace
+
+// 引擎线程与 Run 调用线程之间的 stdout 通道：引擎追加以换行结尾的块，调用线程整批取走后逐行回调
+struct ProcessEngine::StdoutStream {
+    std::mutex mutex;
+    std::condition_variable ready_cv;
+    std::vector<std::string> blocks;
+    size_t buffered_bytes{0};
+    bool closed{false};      // 子进程已结束，不会再有新块
+    bool abandoned{false};   // 调用线程的回调出错，后续输出直接丢弃
+
+    void Push(std::string block) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (abandoned) {
+                return;
+            }
+            buffered_bytes += block.size();
+            blocks.push_back(std::move(block));
+        }
+        ready_cv.notify_one();
+    }
+
+    // 调用线程取走积压的块后会唤醒引擎继续读取
+    bool Backlogged() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !abandoned && buffered_bytes >= kStdoutBacklogLimit;
+    }
+
+    bool Abandoned() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return abandoned;
+    }
+
+    // last_line 是输出末尾没有换行的部分
+    void Close(std::string last_line) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!abandoned && !last_line.empty()) {
+                blocks.push_back(std::move(last_line));
+            }
+            closed = true;
+        }
+        ready_cv.notify_one();
+    }
+};
+
+struct ProcessEngine::Child {
+    ProcessRequest request;
+    std::promise<ProcessResult> promise;
+    ProcessResult result;
+    std::uint64_t cancel_generation{0};
+
+    pid_t pid{-1};
+    int stdout_fd{-1};
+    int stderr_fd{-1};
+    std::string partial_line;
+    std::exception_ptr callback_error;
+    std::shared_ptr<StdoutStream> stdout_stream;   // 非空时 stdout 按块转交给 Run 的调用线程
+
+    Clock::time_point deadline{Clock::time_point::max()};
+    Clock::time_point kill_deadline{Clock::time_point::max()};
+    bool terminate_sent{false};
+    bool kill_sent{false};
+    bool reaped{false};
+};
+
+void CancellationToken::Cancel() {
+    cancelled_->store(true, std::memory_order_release);
+    ProcessEngine::Instance().Wake();
+}
+
+ProcessEngine& ProcessEngine::Instance() {
+    static ProcessEngine instance;
+    return instance;
+}
+
+ProcessEngine::ProcessEngine() {
+    if (::pipe2(wake_pipe_, O_CLOEXEC | O_NONBLOCK) != 0) {
+        throw std::runtime_error("Failed to create process engine wake pipe: " +
+                                 std::string(std::strerror(errno)));
+    }
+    loop_thread_ = std::thread([this] { EventLoop(); });
+}
+
+ProcessEngine::~ProcessEngine() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        ++cancel_generation_;
+    }
+    Wake();
+    if (loop_thread_.joinable()) {
+        loop_thread_.join();
+    }
+    CloseFd(wake_pipe_[0]);
+    CloseFd(wake_pipe_[1]);
+}
+
+std::unique_ptr<ProcessEngine::Child> ProcessEngine::MakeChild(ProcessRequest request) {
+    if (request.argv.empty()) {
+        throw std::invalid_argument("ProcessRequest argv must not be empty");
+    }
+    auto child = std::make_unique<Child>();
+    child->request = std::move(request);
+    return child;
+}
+
+std::future<ProcessResult> ProcessEngine::Submit(ProcessRequest request) {
+    return Enqueue(MakeChild(std::move(request)));
+}
+
+std::future<ProcessResult> ProcessEngine::Enqueue(std::unique_ptr<Child> child) {
+    std::future<ProcessResult> future = child->promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            throw std::runtime_error("ProcessEngine is shutting down");
+        }
+        child->cancel_generation = cancel_generation_;
+        pending_.push_back(std::move(child));
+        ++active_count_;
+    }
+    Wake();
+    return future;
+}
+
+ProcessResult ProcessEngine::Run(ProcessRequest request) {
+    if (request.on_stdout_line) {
+        return RunStreaming(std::move(request));
+    }
+    return Submit(std::move(request)).get();
+}
+
+ProcessResult ProcessEngine::RunStreaming(ProcessRequest request) {
+    const std::function<void(std::string_view)> on_line = std::move(request.on_stdout_line);
+    request.on_stdout_line = nullptr;
+    std::unique_ptr<Child> child = MakeChild(std::move(request));
+    const auto stream = std::make_shared<StdoutStream>();
+    child->stdout_stream = stream;
+    std::future<ProcessResult> future = Enqueue(std::move(child));
+
+    std::exception_ptr callback_error;
+    std::vector<std::string> blocks;
+    bool closed = false;
+    while (!closed) {
+        bool was_backlogged = false;
+        {
+            std::unique_lock<std::mutex> lock(stream->mutex);
+            stream->ready_cv.wait(lock, [&stream] { return !stream->blocks.empty() || stream->closed; });
+            blocks.swap(stream->blocks);
+            was_backlogged = stream->buffered_bytes >= kStdoutBacklogLimit;
+            stream->buffered_bytes = 0;
+            closed = stream->closed;
+        }
+        if (was_backlogged) {
+            // 引擎可能已因积压暂停读取该管道
+            Wake();
+        }
+        if (!callback_error) {
+            try {
+                for (const std::string& block : blocks) {
+                    ForEachLine(block, on_line);
+                }
+            } catch (...) {
+                // 不再消费输出：引擎丢弃后续块并终止子进程，子进程结束后重新抛出
+                callback_error = std::current_exception();
+                {
+                    std::lock_guard<std::mutex> lock(stream->mutex);
+                    stream->abandoned = true;
+                    stream->blocks.clear();
+                    stream->buffered_bytes = 0;
+                }
+                Wake();
+            }
+        }
+        blocks.clear();
+    }
+
+    // 启动失败时 future 中携带异常
+    ProcessResult result = future.get();
+    if (callback_error) {
+        std::rethrow_exception(callback_error);
+    }
+    return result;
+}
+
+void ProcessEngine::CancelAll() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++cancel_generation_;
+    }
+    Wake();
+}
+
+void ProcessEngine::WaitForIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return active_count_ == 0; });
+}
+
+void ProcessEngine::Wake() {
+    const char byte = 1;
+    // 管道满说明已有未处理的唤醒，忽略 EAGAIN
+    [[maybe_unused]] const ssize_t written = ::write(wake_pipe_[1], &byte, 1);
+}
+
+void ProcessEngine::StartChild(std::unique_ptr<Child>& child) {
+    int stdout_pipe[2] = {-1, -1};
+    int stderr_pipe[2] = {-1, -1};
+    if (::pipe2(stdout_pipe, O_CLOEXEC) != 0 ||
+        (!child->request.merge_stderr && ::pipe2(stderr_pipe, O_CLOEXEC) != 0)) {
+        const int error = errno;
+        CloseFd(stdout_pipe[0]);
+        CloseFd(stdout_pipe[1]);
+        throw std::runtime_error("Failed to create pipe: " + std::string(std::strerror(error)));
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, stdout_pipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions,
+                                     child->request.merge_stderr ? stdout_pipe[1] : stderr_pipe[1],
+                                     STDERR_FILENO);
+
+    // 工作目录只作用于子进程：glibc 2.29+ 由 posix_spawn 在 exec 前 chdir，
+    // 其他平台退化为经 /bin/sh 切换目录后 exec 原命令
+    std::vector<std::string> spawn_args;
+    const std::vector<std::string>* command = &child->request.argv;
+    if (!child->request.working_directory.empty()) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+        posix_spawn_file_actions_addchdir_np(&actions, child->request.working_directory.c_str());
+#else
+        spawn_args = {"/bin/sh", "-c", "cd \"$0\" && exec \"$@\"", child->request.working_directory};
+        spawn_args.insert(spawn_args.end(), child->request.argv.begin(), child->request.argv.end());
+        command = &spawn_args;
+#endif
+    }
+
+    // 独立进程组，超时 / 取消时可以连同其子进程一起终止
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t empty_mask;
+    sigemptyset(&empty_mask);
+    sigset_t default_signals;
+    sigemptyset(&default_signals);
+    for (int signal_number : {SIGPIPE, SIGINT, SIGTERM, SIGHUP, SIGQUIT}) {
+        sigaddset(&default_signals, signal_number);
+    }
+    posix_spawnattr_setflags(&attributes,
+                             POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+    posix_spawnattr_setpgroup(&attributes, 0);
+    posix_spawnattr_setsigmask(&attributes, &empty_mask);
+    posix_spawnattr_setsigdefault(&attributes, &default_signals);
+
+    std::vector<char*> argv;
+    argv.reserve(command->size() + 1);
+    for (const auto& arg : *command) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    const int spawn_error = ::posix_spawnp(&child->pid, argv[0], &actions, &attributes, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attributes);
+
+    CloseFd(stdout_pipe[1]);
+    CloseFd(stderr_pipe[1]);
+    if (spawn_error != 0) {
+        CloseFd(stdout_pipe[0]);
+        CloseFd(stderr_pipe[0]);
+        const std::string location = child->request.working_directory.empty()
+                                         ? std::string()
+                                         : " in '" + child->request.working_directory + "'";
+        throw std::runtime_error("Failed to spawn '" + DescribeCommand(child->request.argv) + "'" +
+                                 location + ": " + std::strerror(spawn_error));
+    }
+
+    child->stdout_fd = stdout_pipe[0];
+    child->stderr_fd = stderr_pipe[0];
+    for (int fd : {child->stdout_fd, child->stderr_fd}) {
+        if (fd >= 0) {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        }
+    }
+    if (child->request.timeout.count() > 0) {
+        child->deadline = Clock::now() + child->request.timeout;
+    }
+}
+
+void ProcessEngine::DeliverStdout(Child& child, std::string_view chunk) {
+    if (child.stdout_stream) {
+        // 只转交以换行结尾的部分，不完整的行留到下一次读取
+        const size_t last_newline = chunk.rfind('\n');
+        if (last_newline == std::string_view::npos) {
+            child.partial_line.append(chunk);
+            return;
+        }
+        std::string block = std::move(child.partial_line);
+        block.append(chunk.substr(0, last_newline + 1));
+        child.partial_line.assign(chunk.substr(last_newline + 1));
+        child.stdout_stream->Push(std::move(block));
+        return;
+    }
+    if (!child.request.on_stdout_line) {
+        child.result.stdout_text.append(chunk);
+        return;
+    }
+    if (child.callback_error) {
+        return;
+    }
+
+    try {
+        size_t line_start = 0;
+        while (line_start < chunk.size()) {
+            const size_t line_end = chunk.find('\n', line_start);
+            if (line_end == std::string_view::npos) {
+                child.partial_line.append(chunk.substr(line_start));
+                break;
+            }
+            if (child.partial_line.empty()) {
+                child.request.on_stdout_line(chunk.substr(line_start, line_end - line_start));
+            } else {
+                child.partial_line.append(chunk.substr(line_start, line_end - line_start));
+                child.request.on_stdout_line(child.partial_line);
+                child.partial_line.clear();
+            }
+            line_start = line_end + 1;
+        }
+    } catch (...) {
+        // 回调出错后不再继续消费输出，直接终止子进程
+        child.callback_error = std::current_exception();
+        if (!child.terminate_sent) {
+            ::kill(-child.pid, SIGKILL);
+            child.terminate_sent = true;
+            child.kill_sent = true;
+        }
+    }
+}
+
+void ProcessEngine::ReadAvailable(Child& child, int& fd, bool is_stdout) {
+    char buffer[64 * 1024];
+    while (fd >= 0) {
+        const ssize_t bytes_read = ::read(fd, buffer, sizeof(buffer));
+        if (bytes_read > 0) {
+            const std::string_view chunk(buffer, static_cast<size_t>(bytes_read));
+            if (is_stdout) {
+                DeliverStdout(child, chunk);
+                // 调用线程消费不及时：剩余输出留在管道里，子进程写满管道后阻塞；回收时则必须读完
+                if (!child.reaped && child.stdout_stream && child.stdout_stream->Backlogged()) {
+                    return;
+                }
+            } else {
+                child.result.stderr_text.append(chunk);
+            }
+            continue;
+        }
+        if (bytes_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        }
+        CloseFd(fd);
+    }
+}
+
+void ProcessEngine::FinishChild(Child& child) {
+    CloseFd(child.stdout_fd);
+    CloseFd(child.stderr_fd);
+
+    if (child.stdout_stream) {
+        child.stdout_stream->Close(std::move(child.partial_line));
+        child.promise.set_value(std::move(child.result));
+        return;
+    }
+    if (child.callback_error) {
+        child.promise.set_exception(child.callback_error);
+        return;
+    }
+    if (!child.partial_line.empty() && child.request.on_stdout_line) {
+        try {
+            child.request.on_stdout_line(child.partial_line);
+        } catch (...) {
+            child.promise.set_exception(std::current_exception());
+            return;
+        }
+    }
+    child.promise.set_value(std::move(child.result));
+}
+
+void ProcessEngine::EventLoop() {
+    std::vector<std::unique_ptr<Child>> running;
+    std::vector<pollfd> poll_fds;
+    std::vector<std::pair<Child*, bool>> poll_owners;   // 与 poll_fds[1..] 一一对应：所属子进程、是否 stdout
+
+    while (true) {
+        std::deque<std::unique_ptr<Child>> starting;
+        std::uint64_t cancel_generation = 0;
+        bool stopping = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            starting.swap(pending_);
+            cancel_generation = cancel_generation_;
+            stopping = stopping_;
+        }
+        if (stopping && running.empty() && starting.empty()) {
+            break;
+        }
+
+        size_t finished_count = 0;
+        for (auto& child : starting) {
+            if (child->cancel_generation != cancel_generation) {
+                child->result.cancelled = true;
+                if (child->stdout_stream) {
+                    child->stdout_stream->Close({});
+                }
+                child->promise.set_value(std::move(child->result));
+                ++finished_count;
+                continue;
+            }
+            try {
+                StartChild(child);
+                running.push_back(std::move(child));
+            } catch (...) {
+                if (child->stdout_stream) {
+                    child->stdout_stream->Close({});
+                }
+                child->promise.set_exception(std::current_exception());
+                ++finished_count;
+            }
+        }
+
+        // 超时、取消与强制终止
+        const Clock::time_point now = Clock::now();
+        for (auto& child : running) {
+            if (child->reaped) {
+                continue;
+            }
+            const bool cancelled = child->request.cancel_token.IsCancelled() ||
+                                   child->cancel_generation != cancel_generation;
+            const bool timed_out = now >= child->deadline;
+            if (!child->kill_sent && child->stdout_stream && child->stdout_stream->Abandoned()) {
+                // 与引擎线程上的回调出错一样，直接终止
+                ::kill(-child->pid, SIGKILL);
+                child->terminate_sent = true;
+                child->kill_sent = true;
+            } else if (!child->terminate_sent && (cancelled || timed_out)) {
+                child->result.cancelled = cancelled;
+                child->result.timed_out = !cancelled && timed_out;
+                ::kill(-child->pid, SIGTERM);
+                child->terminate_sent = true;
+                child->kill_deadline = now + kTerminateGracePeriod;
+            } else if (child->terminate_sent && !child->kill_sent && now >= child->kill_deadline) {
+                ::kill(-child->pid, SIGKILL);
+                child->kill_sent = true;
+            }
+        }
+
+        // 回收已退出的子进程：输出已读完，或已发出终止信号（孙进程可能仍持有管道）
+        for (auto& child : running) {
+            if (child->reaped ||
+                (!child->terminate_sent && (child->stdout_fd >= 0 || child->stderr_fd >= 0))) {
+                continue;
+            }
+            int status = 0;
+            const pid_t waited = ::waitpid(child->pid, &status, WNOHANG);
+            if (waited == child->pid || (waited < 0 && errno == ECHILD)) {
+                child->reaped = true;
+                if (waited == child->pid && WIFEXITED(status)) {
+                    child->result.exit_code = WEXITSTATUS(status);
+                } else if (waited == child->pid && WIFSIGNALED(status)) {
+                    child->result.term_signal = WTERMSIG(status);
+                }
+                if (child->stdout_fd >= 0) {
+                    ReadAvailable(*child, child->stdout_fd, true);
+                }
+                if (child->stderr_fd >= 0) {
+                    ReadAvailable(*child, child->stderr_fd, false);
+                }
+            }
+        }
+
+        const size_t before = running.size();
+        for (auto& child : running) {
+            if (child->reaped) {
+                FinishChild(*child);
+            }
+        }
+        running.erase(std::remove_if(running.begin(), running.end(),
+                                     [](const std::unique_ptr<Child>& child) { return child->reaped; }),
+                      running.end());
+        finished_count += before - running.size();
+
+        if (finished_count > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            active_count_ -= finished_count;
+            if (active_count_ == 0) {
+                idle_cv_.notify_all();
+            }
+        }
+
+        // 计算下一次需要醒来的时间
+        Clock::time_point wake_at = Clock::time_point::max();
+        bool awaiting_reap = false;
+        poll_fds.clear();
+        poll_owners.clear();
+        poll_fds.push_back(pollfd{wake_pipe_[0], POLLIN, 0});
+        for (auto& child : running) {
+            // stdout 积压时不再轮询，等调用线程取走后由 Wake 唤醒
+            if (child->stdout_fd >= 0 && !(child->stdout_stream && child->stdout_stream->Backlogged())) {
+                poll_fds.push_back(pollfd{child->stdout_fd, POLLIN, 0});
+                poll_owners.emplace_back(child.get(), true);
+            }
+            if (child->stderr_fd >= 0) {
+                poll_fds.push_back(pollfd{child->stderr_fd, POLLIN, 0});
+                poll_owners.emplace_back(child.get(), false);
+            }
+            if (child->stdout_fd < 0 && child->stderr_fd < 0) {
+                awaiting_reap = true;
+            }
+            if (child->terminate_sent) {
+                awaiting_reap = true;
+                if (!child->kill_sent) {
+                    wake_at = std::min(wake_at, child->kill_deadline);
+                }
+            } else {
+                wake_at = std::min(wake_at, child->deadline);
+            }
+        }
+
+        int timeout_ms = -1;
+        if (awaiting_reap) {
+            timeout_ms = static_cast<int>(kReapInterval.count());
+        }
+        if (wake_at != Clock::time_point::max()) {
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(wake_at - Clock::now());
+            const long long wait_ms = std::max<long long>(0, remaining.count() + 1);
+            const int capped = static_cast<int>(std::min<long long>(wait_ms, INT_MAX));
+            timeout_ms = timeout_ms < 0 ? capped : std::min(timeout_ms, capped);
+        }
+
+        const int ready = ::poll(poll_fds.data(), poll_fds.size(), timeout_ms);
+        if (ready <= 0) {
+            continue;
+        }
+
+        if (poll_fds[0].revents != 0) {
+            char drain[64];
+            while (::read(wake_pipe_[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+
+        for (size_t index = 1; index < poll_fds.size(); ++index) {
+            if (poll_fds[index].revents == 0) {
+                continue;
+            }
+            auto [child, is_stdout] = poll_owners[index - 1];
+            ReadAvailable(*child, is_stdout ? child->stdout_fd : child->stderr_fd, is_stdout);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// 取消令牌：拷贝后共享同一状态，任意线程调用 Cancel() 都会让引擎终止关联的子进程
+class CancellationToken {
+public:
+    CancellationToken() : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void Cancel();
+    bool IsCancelled() const { return cancelled_->load(std::memory_order_acquire); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+struct ProcessRequest {
+    std::vector<std::string> argv;                      // argv[0] 按 PATH 查找，不经过 shell
+    std::string working_directory;                      // 子进程工作目录，空串表示继承；不改变本进程 cwd
+    bool merge_stderr{false};                           // stderr 并入 stdout（等价于 2>&1）
+    std::chrono::milliseconds timeout{0};               // 0 表示不限时
+    CancellationToken cancel_token;
+    // 设置后 stdout 按行回调，不再收集到 stdout_text。经 Run 执行时回调在调用 Run 的线程上执行，
+    // 引擎线程只切分出完整的行成块转交，多个查询的输出解析可以并行；调用方消费不及时时引擎暂停读取该管道。
+    // 经 Submit 提交时回调在引擎线程上执行，需尽快返回，且不能同步等待其他进程
+    std::function<void(std::string_view)> on_stdout_line;
+};
+
+struct ProcessResult {
+    int exit_code{-1};          // 正常退出时的退出码，被信号终止时为 -1
+    int term_signal{0};         // 终止进程的信号
+    bool timed_out{false};
+    bool cancelled{false};
+    std::string stdout_text;
+    std::string stderr_text;
+
+    bool Succeeded() const { return exit_code == 0 && !timed_out && !cancelled; }
+};
+
+// 子进程执行引擎：posix_spawn + pipe2 启动子进程，单个后台线程用 poll 同时管理所有子进程的
+// 输出、超时与取消，不为每条命令占用一个线程。超时或取消时先 SIGTERM 整个进程组，宽限期后 SIGKILL。
+class ProcessEngine {
+public:
+    static ProcessEngine& Instance();
+
+    ProcessEngine(const ProcessEngine&) = delete;
+    ProcessEngine& operator=(const ProcessEngine&) = delete;
+    ~ProcessEngine();
+
+    // 提交命令；启动失败时 future 中携带异常
+    std::future<ProcessResult> Submit(ProcessRequest request);
+
+    // 同步执行；设置了 on_stdout_line 时行回调在本线程上执行，回调抛出的异常会终止子进程并在此重新抛出
+    ProcessResult Run(ProcessRequest request);
+
+    // 终止所有排队与运行中的命令
+    void CancelAll();
+
+    // 阻塞直到没有排队或运行中的命令
+    void WaitForIdle();
+
+    // 唤醒事件循环（取消令牌使用）
+    void Wake();
+
+private:
+    struct Child;
+    struct StdoutStream;
+
+    ProcessEngine();
+
+    static std::unique_ptr<Child> MakeChild(ProcessRequest request);
+    std::future<ProcessResult> Enqueue(std::unique_ptr<Child> child);
+    ProcessResult RunStreaming(ProcessRequest request);
+
+    void EventLoop();
+    void StartChild(std::unique_ptr<Child>& child);
+    void ReadAvailable(Child& child, int& fd, bool is_stdout);
+    void DeliverStdout(Child& child, std::string_view chunk);
+    void FinishChild(Child& child);
+
+    std::mutex mutex_;
+    std::condition_variable idle_cv_;
+    std::deque<std::unique_ptr<Child>> pending_;
+    size_t active_count_{0};
+    std::uint64_t cancel_generation_{0};
+    bool stopping_{false};
+    int wake_pipe_[2]{-1, -1};
+    std::thread loop_thread_;
+};
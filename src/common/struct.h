@@ -19,6 +19,20 @@ enum class ExcuteFuction {
     UNUSED_DEPENDENCY_CHECK,        // 未使用依赖检查
     CYCLIC_DEPENDENCY_DETECTION,    // 循环依赖检测
     BUILD_TIME_ANALYZE,             // 构建时间分析
+    TRANSITIVE_REDUCTION,           // 传递约简（可由其他依赖传递得到的冗余依赖边）
+};
+
+
+enum class CycleReportMode {
+    CYCLES,         // 逐个列出基本环（默认）
+    SCC_SUMMARY,    // 按强连通分量汇总，每个分量给出一组覆盖全部目标的短环
+    FEEDBACK_ARCS   // 删除后整个依赖图无环的近似最小边集，按删除代价排序
+};
+
+
+enum class ParseStrategy {
+    BAZEL_QUERY,        // bazel query 提取（默认）
+    BUILD_FILE_READER   // 直接读取 BUILD 文件，无法求值的包回退到 bazel query
 };
 
 
@@ -246,15 +246,7 @@ private:
         }
         
         try {
-            std::string test_command;
-            if (workspace_path_ != "." && !workspace_path_.empty()) {
-                test_command = "cd \"" + workspace_path_ + "\" && " + bazel_binary_ + " version";
-            } else {
-                test_command = bazel_binary_ + " version";
-            }
-            
-            auto [output, exit_code] = PipeCommandExecutor::executeWithStatus(
-                PipeCommandExecutor::setCommand(test_command));
+            auto [output, exit_code] = ExecuteBazelCommand(bazel_binary_ + " version");
             
             if (exit_code != 0) {
                 last_error_ = "Bazel binary is not executable or not found: " + bazel_binary_;
@@ -285,17 +277,10 @@ private:
         return true;
     }
     
+    // 命令在工作区目录下的子进程中执行，不改变本进程的工作目录
     std::pair<std::string, int> ExecuteBazelCommand(const std::string& command) const {
-        std::string full_command;
-        
-        if (workspace_path_ != "." && !workspace_path_.empty()) {
-            full_command = "cd \"" + workspace_path_ + "\" && " + command;
-        } else {
-            full_command = command;
-        }
-        
-        return PipeCommandExecutor::executeWithStatus(
-            PipeCommandExecutor::setCommand(full_command));
+        const bool use_workspace_dir = workspace_path_ != "." && !workspace_path_.empty();
+        return PipeCommandExecutor::executeWithStatus(command, use_workspace_dir ? workspace_path_ : "");
     }
     
     std::string BuildFullBazelCommand(const std::vector<std::string>& targets,
@@ -1,4 +1,7 @@
 #include "CycleDetector.h"
+#include "concurrency/WorkStealingPool.h"
+#include "graph/FeedbackArcSet.h"
+#include "log/logger.h"
 #include <algorithm>
 #include <memory>
 #include <sstream>
@@ -6,63 +9,338 @@
 #include <unordered_set>
 #include <string_view>
 
+namespace {
+
+std::uint64_t EdgeKey(CycleDetector::TargetId from, CycleDetector::TargetId to) {
+    return (static_cast<std::uint64_t>(from) << 32) | to;
+}
+
+// 反馈边集的边权：源码未引用依赖的边可直接删除，被引用的边需要重构代码
+constexpr std::uint32_t kRemovableEdgeCost = 1;
+constexpr std::uint32_t kNeededEdgeCost = 10;
+
+bool IsCcRule(std::string_view rule_type) {
+    return rule_type.rfind("cc_", 0) == 0;
+}
+
+// 枚举出的环攒够一批后并行分类：批越大并行度越高，暂存的 id 序列也越多
+constexpr size_t kClassifyBatchSize = 1024;
+
+}  // namespace
+
 CycleDetector::CycleDetector(const DependencyGraph& graph,
-                             const std::unordered_map<std::string, BazelTarget>& targets,
-                             const std::string workspace_path) 
-    : workspace_path_(workspace_path), graph_(graph), targets_(targets) {
-    source_analyzer_ = std::make_shared<SourceAnalyzer>(targets_, workspace_path_);
+                             const TargetTable& table,
+                             const std::string workspace_path,
+                             const DependencyGraph::CycleEnumerationOptions& cycle_options)
+    : workspace_path_(workspace_path), graph_(graph), table_(table), cycle_options_(cycle_options) {
+    source_analyzer_ = std::make_shared<SourceAnalyzer>(table_, workspace_path_);
     graph_.SetSourceAnalyzer(source_analyzer_.get());
 }
 
-std::vector<CycleAnalysis> CycleDetector::AnalyzeCycles() {
-    if (cycles_cached_) {
-        return cached_cycles_;
+size_t CycleDetector::CodeLevelResultsBytes(const std::shared_ptr<const CodeLevelResults>& results) {
+    if (!results) {
+        return 0;
     }
+    // 控制块与桶数组，外加每个节点的键值与链表指针
+    size_t bytes = 2 * sizeof(void*) + sizeof(CodeLevelResults) + results->bucket_count() * sizeof(void*);
+    for (const auto& [to, removable] : *results) {
+        bytes += sizeof(CodeLevelResults::value_type) + sizeof(void*) + RemovableDependenciesBytes(removable);
+    }
+    return bytes;
+}
+
+void CycleDetector::InheritCaches(const CycleDetector& previous,
+                                  const TargetTableDelta& delta,
+                                  const std::vector<bool>& affected) {
+    if (source_analyzer_ && previous.source_analyzer_) {
+        source_analyzer_->InheritCaches(*previous.source_analyzer_, delta);
+    }
+
+    // 边级别结果只取决于来源目标可达的子图，来源目标不受影响时整体沿用；整轮分析结果重新计算
+    const auto map_source = [&](TargetId previous_from) {
+        const TargetId from = delta.Map(previous_from);
+        return from != TargetTable::kInvalidId && !affected[from] ? from : TargetTable::kInvalidId;
+    };
+    previous.code_level_cache_.ForEach([&](TargetId previous_from, const auto& results) {
+        const TargetId from = map_source(previous_from);
+        if (from == TargetTable::kInvalidId) {
+            return;
+        }
+        auto buckets = std::make_shared<CodeLevelResults>();
+        for (const auto& [previous_to, removable] : *results) {
+            const TargetId to = delta.Map(previous_to);
+            if (to != TargetTable::kInvalidId) {
+                (*buckets)[to] = removable;
+            }
+        }
+        code_level_cache_.Insert(from, std::move(buckets));
+    });
+    const auto inherit_edges = [&](const auto& from_cache, auto& to_cache) {
+        from_cache.ForEach([&](std::uint64_t key, const auto& value) {
+            const TargetId from = map_source(static_cast<TargetId>(key >> 32));
+            const TargetId to = delta.Map(static_cast<TargetId>(key));
+            if (from != TargetTable::kInvalidId && to != TargetTable::kInvalidId) {
+                to_cache.Insert(EdgeKey(from, to), value);
+            }
+        });
+    };
+    inherit_edges(previous.target_level_cache_, target_level_cache_);
+    inherit_edges(previous.critical_dependency_cache_, critical_dependency_cache_);
+}
+
+std::vector<CycleAnalysis> CycleDetector::AnalyzeCycles() const {
+    std::call_once(cycles_once_, [this] { cached_cycles_ = ComputeCycles(); });
+    return cached_cycles_;
+}
+
+std::vector<ComponentAnalysis> CycleDetector::AnalyzeComponents() const {
+    std::call_once(components_once_, [this] { cached_components_ = ComputeComponents(); });
+    return cached_components_;
+}
+
+FeedbackArcSetAnalysis CycleDetector::AnalyzeFeedbackArcSet() const {
+    std::call_once(feedback_arcs_once_, [this] { cached_feedback_arcs_ = ComputeFeedbackArcSet(); });
+    return cached_feedback_arcs_;
+}
+
+TransitiveReductionAnalysis CycleDetector::AnalyzeTransitiveReduction() const {
+    std::call_once(transitive_reduction_once_, [this] { cached_transitive_reduction_ = ComputeTransitiveReduction(); });
+    return cached_transitive_reduction_;
+}
+
+std::vector<RemovableDependency> CycleDetector::AnalyzeUnusedDependencies() const {
+    std::call_once(unused_once_, [this] { cached_unused_dependencies_ = graph_.FindAllUnusedDependencies(); });
+    return cached_unused_dependencies_;
+}
 
+std::vector<CycleAnalysis> CycleDetector::ComputeCycles() const {
     std::vector<CycleAnalysis> analyses;
-    
-    // 发现所有循环
-    auto cycles = graph_.FindCycles();
-    analyses.reserve(cycles.size());
-    
-    for (const auto& cycle : cycles) {
-        if (cycle.size() >= 2) {
-            analyses.push_back(ClassifyCycle(cycle));
+    std::vector<std::vector<TargetId>> batch;
+    batch.reserve(kClassifyBatchSize);
+
+    // 枚举本身是串行的，开销在分类（源码扫描）上：按批并行分类，不保留完整的环列表；
+    // 分类耗时同样计入枚举的 deadline。自环不作为循环依赖报告
+    cycle_stats_ = graph_.EnumerateCycles(cycle_options_, [&](const std::vector<TargetId>& cycle_ids) {
+        if (cycle_ids.size() < 2) {
+            return true;
+        }
+        batch.push_back(cycle_ids);
+        if (batch.size() == kClassifyBatchSize) {
+            ClassifyCycles(batch, analyses);
+            batch.clear();
         }
+        return true;
+    });
+    ClassifyCycles(batch, analyses);
+
+    if (cycle_stats_.deadline_reached) {
+        LOG_WARN("Cycle enumeration stopped at the time limit after " + std::to_string(cycle_stats_.cycles) +
+                 " cycles; results are incomplete");
+    }
+    if (cycle_stats_.truncated_components > 0) {
+        LOG_WARN("Cycle enumeration reached the per-component limit of " +
+                 std::to_string(cycle_options_.max_cycles_per_component) + " cycles in " +
+                 std::to_string(cycle_stats_.truncated_components) + " strongly connected component(s)");
     }
     
-    // 按循环大小排序，小的优先处理
-    std::sort(analyses.begin(), analyses.end(), 
+    // 按循环大小排序，小的优先处理；同样大小保持 FindCycles 的确定顺序
+    std::stable_sort(analyses.begin(), analyses.end(), 
               [](const CycleAnalysis& a, const CycleAnalysis& b) {
                   return a.cycle.size() < b.cycle.size();
               });
 
-    cached_cycles_ = analyses;
-    cycles_cached_ = true;
-    return cached_cycles_;
+    return analyses;
 }
 
-std::vector<RemovableDependency> CycleDetector::AnalyzeUnusedDependencies() {
-    if (unused_cached_) {
-        return cached_unused_dependencies_;
+std::vector<ComponentAnalysis> CycleDetector::ComputeComponents() const {
+    std::vector<ComponentAnalysis> components;
+    const std::vector<DependencyGraph::ComponentSummary> summaries = graph_.SummarizeComponents(cycle_options_);
+
+    // 所有分量的覆盖环拉平后一起并行分类，避免大分量独占一个线程
+    std::vector<std::vector<TargetId>> covering_cycles;
+    for (const auto& summary : summaries) {
+        covering_cycles.insert(covering_cycles.end(), summary.cycles.begin(), summary.cycles.end());
+    }
+    std::vector<CycleAnalysis> classified;
+    ClassifyCycles(covering_cycles, classified);
+
+    size_t next_cycle = 0;
+    for (const auto& summary : summaries) {
+        ComponentAnalysis component;
+        component.targets.reserve(summary.nodes.size());
+        for (const TargetId node : summary.nodes) {
+            component.targets.emplace_back(table_.Label(node));
+        }
+        component.internal_edges = summary.internal_edges;
+        component.entry_edges = summary.entry_edges;
+        component.exit_edges = summary.exit_edges;
+        component.cycle_rank = summary.internal_edges + 1 - summary.nodes.size();
+        component.truncated = summary.truncated;
+        component.covering_cycles.assign(std::make_move_iterator(classified.begin() + next_cycle),
+                                         std::make_move_iterator(classified.begin() + next_cycle +
+                                                                 summary.cycles.size()));
+        next_cycle += summary.cycles.size();
+        components.push_back(std::move(component));
     }
 
-    cached_unused_dependencies_ = graph_.FindAllUnusedDependencies();
-    unused_cached_ = true;
-    return cached_unused_dependencies_;
+    return components;
+}
+
+FeedbackArcSetAnalysis CycleDetector::ComputeFeedbackArcSet() const {
+    const auto edge_cost = [this](TargetId from, TargetId to) {
+        if (!source_analyzer_) {
+            return kNeededEdgeCost;
+        }
+        try {
+            return source_analyzer_->IsDependencyNeeded(from, to) ? kNeededEdgeCost : kRemovableEdgeCost;
+        } catch (const std::exception& e) {
+            // 无法判断时按需要处理
+            LOG_DEBUG("Source analysis failed for " + std::string(table_.Label(from)) + " -> " +
+                      std::string(table_.Label(to)) + ": " + e.what());
+            return kNeededEdgeCost;
+        }
+    };
+
+    const SccPartition components = graph_.FindStronglyConnectedComponents();
+
+    // 边权需要源码扫描，先收集所有分量内部的边（按 from、to 升序），在线程池上并行算好
+    std::vector<std::uint64_t> internal_edges;
+    for (TargetId node = 0; node < graph_.NodeCount(); ++node) {
+        for (const TargetId dep : graph_.GetDirectDependencyIds(node)) {
+            if (components.component_of[dep] == components.component_of[node]) {
+                internal_edges.push_back(EdgeKey(node, dep));
+            }
+        }
+    }
+    std::vector<std::uint32_t> internal_costs(internal_edges.size(), kNeededEdgeCost);
+    WorkStealingPool::Instance().ParallelFor(internal_edges.size(), [&](size_t index) {
+        const std::uint64_t key = internal_edges[index];
+        internal_costs[index] = edge_cost(static_cast<TargetId>(key >> 32), static_cast<TargetId>(key));
+    });
+
+    const std::vector<FeedbackArc> arcs = FeedbackArcSet::Compute(
+        graph_, components, [&](TargetId from, TargetId to) {
+            const auto it = std::lower_bound(internal_edges.begin(), internal_edges.end(), EdgeKey(from, to));
+            return it != internal_edges.end() && *it == EdgeKey(from, to)
+                       ? internal_costs[it - internal_edges.begin()]
+                       : edge_cost(from, to);
+        });
+
+    FeedbackArcSetAnalysis analysis;
+    std::unordered_set<std::uint32_t> cyclic_components;
+    analysis.edges.reserve(arcs.size());
+    for (const auto& arc : arcs) {
+        FeedbackEdge edge;
+        edge.from_target = std::string(table_.Label(arc.from));
+        edge.to_target = std::string(table_.Label(arc.to));
+        edge.cost = arc.weight;
+        edge.removable = arc.weight == kRemovableEdgeCost;
+        edge.component_size = components.Component(arc.component).size();
+        edge.reason = arc.from == arc.to ? "自依赖"
+                      : edge.removable   ? "源码未引用该依赖的头文件，可直接删除"
+                                         : "源码引用了该依赖，需要抽取接口或调整代码后删除";
+        analysis.total_cost += edge.cost;
+        analysis.removable_edges += edge.removable ? 1 : 0;
+        cyclic_components.insert(arc.component);
+        analysis.edges.push_back(std::move(edge));
+    }
+    analysis.cyclic_components = cyclic_components.size();
+
+    // 代价低的边优先；同代价按 label 排列，保证输出稳定
+    std::sort(analysis.edges.begin(), analysis.edges.end(), [](const FeedbackEdge& a, const FeedbackEdge& b) {
+        if (a.cost != b.cost) {
+            return a.cost < b.cost;
+        }
+        if (a.from_target != b.from_target) {
+            return a.from_target < b.from_target;
+        }
+        return a.to_target < b.to_target;
+    });
+
+    LOG_INFO("Feedback arc set: " + std::to_string(analysis.edges.size()) + " edges (" +
+             std::to_string(analysis.removable_edges) + " removable) break all cycles in " +
+             std::to_string(analysis.cyclic_components) + " components");
+
+    return analysis;
+}
+
+TransitiveReductionAnalysis CycleDetector::ComputeTransitiveReduction() const {
+    const auto is_cc_target = [this](TargetId node) { return table_.IsTarget(node) && IsCcRule(table_.RuleType(node)); };
+    const std::vector<DependencyGraph::RedundantEdge> redundant = graph_.FindTransitivelyRedundantEdges(is_cc_target);
+
+    // 冗余边在图上已确定，是否可删除取决于源码是否直接引用：需要源码扫描，在线程池上并行判断
+    std::vector<std::uint8_t> used_directly(redundant.size(), 1);
+    WorkStealingPool::Instance().ParallelFor(redundant.size(), [&](size_t index) {
+        if (!source_analyzer_) {
+            return;
+        }
+        const auto& edge = redundant[index];
+        try {
+            used_directly[index] = source_analyzer_->IsDependencyNeeded(edge.from, edge.to) ? 1 : 0;
+        } catch (const std::exception& e) {
+            // 无法判断时按直接引用处理
+            LOG_DEBUG("Source analysis failed for " + std::string(table_.Label(edge.from)) + " -> " +
+                      std::string(table_.Label(edge.to)) + ": " + e.what());
+        }
+    });
+
+    TransitiveReductionAnalysis analysis;
+    for (TargetId node = 0; node < table_.TargetCount(); ++node) {
+        if (!is_cc_target(node)) {
+            continue;
+        }
+        for (const TargetId dep : graph_.GetDirectDependencyIds(node)) {
+            analysis.total_edges += is_cc_target(dep) ? 1 : 0;
+        }
+    }
+    analysis.edges.reserve(redundant.size());
+    for (size_t index = 0; index < redundant.size(); ++index) {
+        const auto& edge = redundant[index];
+        TransitiveRedundantEdge redundant_edge;
+        redundant_edge.from_target = std::string(table_.Label(edge.from));
+        redundant_edge.to_target = std::string(table_.Label(edge.to));
+        redundant_edge.via_target = std::string(table_.Label(edge.via));
+        redundant_edge.used_directly = used_directly[index] != 0;
+        redundant_edge.reason = redundant_edge.used_directly
+                                    ? "源码直接引用了该依赖的头文件，strict deps 下需保留"
+                                    : "源码未直接引用，经由 " + redundant_edge.via_target + " 传递可达，可以删除";
+        analysis.keep_for_strict_deps += redundant_edge.used_directly ? 1 : 0;
+        analysis.edges.push_back(std::move(redundant_edge));
+    }
+    analysis.safe_to_drop = analysis.edges.size() - analysis.keep_for_strict_deps;
+
+    // 可删除的边在前；图上的结果已按 (from, to) 的 id 即 label 字典序排列
+    std::stable_partition(analysis.edges.begin(), analysis.edges.end(),
+                          [](const TransitiveRedundantEdge& edge) { return !edge.used_directly; });
+
+    LOG_INFO("Transitive reduction: " + std::to_string(analysis.edges.size()) + " of " +
+             std::to_string(analysis.total_edges) + " cc dependency edges are redundant (" +
+             std::to_string(analysis.safe_to_drop) + " safe to drop)");
+
+    return analysis;
+}
+
+void CycleDetector::ClassifyCycles(const std::vector<std::vector<TargetId>>& cycles,
+                                   std::vector<CycleAnalysis>& analyses) const {
+    const size_t first = analyses.size();
+    analyses.resize(first + cycles.size());
+    WorkStealingPool::Instance().ParallelFor(cycles.size(), [&](size_t index) {
+        analyses[first + index] = ClassifyCycle(ToCyclePath(cycles[index]));
+    });
 }
 
 CycleAnalysis CycleDetector::ClassifyCycle(const std::vector<std::string>& cycle) const {
     CycleAnalysis analysis;
     analysis.cycle = cycle;
-    analysis.cycle_type = DetermineBaseCycleType(cycle);
+    const std::vector<TargetId> cycle_ids = ToLabelIds(cycle);
+    analysis.cycle_type = DetermineBaseCycleType(cycle_ids);
     
     // 设置额外分类标志
-    analysis.contains_test_targets = ContainsTestTargets(cycle);
+    analysis.contains_test_targets = ContainsTestTargets(cycle_ids);
     analysis.contains_external_deps = ContainsExternalDeps(cycle);
     
     // 分析可移除的依赖
-    AnalyzeRemovableDependencies(analysis);
+    AnalyzeRemovableDependencies(analysis, cycle_ids);
     
     // 添加基础建议
     AddTypeSpecificSuggestions(analysis);
@@ -73,19 +351,41 @@ CycleAnalysis CycleDetector::ClassifyCycle(const std::vector<std::string>& cycle
     return analysis;
 }
 
-void CycleDetector::AnalyzeRemovableDependencies(CycleAnalysis& analysis) const {
+std::vector<std::string> CycleDetector::ToCyclePath(const std::vector<TargetId>& cycle_ids) const {
+    std::vector<std::string> cycle;
+    cycle.reserve(cycle_ids.size() + 1);
+    for (const TargetId node : cycle_ids) {
+        cycle.emplace_back(table_.Label(node));
+    }
+    if (cycle_ids.size() > 2) {
+        cycle.emplace_back(table_.Label(cycle_ids.front()));
+    }
+    return cycle;
+}
+
+std::vector<CycleDetector::TargetId> CycleDetector::ToLabelIds(const std::vector<std::string>& cycle) const {
+    std::vector<TargetId> ids;
+    ids.reserve(cycle.size());
+    for (const auto& node : cycle) {
+        ids.push_back(table_.FindLabel(node));
+    }
+    return ids;
+}
+
+void CycleDetector::AnalyzeRemovableDependencies(CycleAnalysis& analysis,
+                                                 const std::vector<TargetId>& cycle_ids) const {
     analysis.removable_dependencies.clear();
     analysis.removable_dependencies.reserve(analysis.cycle.size());
     std::unordered_set<std::string> seen_edges;
     seen_edges.reserve(analysis.cycle.size() * 2 + 1);
 
     // 分析循环中的每条边
-    for (size_t i = 0; i < analysis.cycle.size(); ++i) {
-        const std::string& from = analysis.cycle[i];
-        const std::string& to = analysis.cycle[(i + 1) % analysis.cycle.size()];
+    for (size_t i = 0; i < cycle_ids.size(); ++i) {
+        const TargetId from = cycle_ids[i];
+        const TargetId to = cycle_ids[(i + 1) % cycle_ids.size()];
 
         // 检查目标是否存在
-        if (targets_.find(from) == targets_.end() || targets_.find(to) == targets_.end()) {
+        if (!table_.IsTarget(from) || !table_.IsTarget(to)) {
             continue;
         }
 
@@ -121,105 +421,81 @@ void CycleDetector::AnalyzeRemovableDependencies(CycleAnalysis& analysis) const
 }
 
 std::vector<RemovableDependency> CycleDetector::AnalyzeDependencyAtCodeLevel(
-    const std::string& from, const std::string& to) const {
-    auto from_cache_it = code_level_cache_.find(from);
-    if (from_cache_it != code_level_cache_.end()) {
-        auto to_cache_it = from_cache_it->second.find(to);
-        if (to_cache_it != from_cache_it->second.end()) {
-            return to_cache_it->second;
-        }
-    }
-
-    std::vector<RemovableDependency> results;
-    
+    TargetId from, TargetId to) const {
     if (!source_analyzer_) {
-        return results;
+        return {};
     }
-    
-    try {
-        // 仅做一次 from 级别分析，并将结果按 to_target 分桶缓存。
-        auto removable_deps = source_analyzer_->GetRemovableDependencies(from);
-        auto& from_cache = code_level_cache_[from];
-        from_cache.reserve(removable_deps.size() + 1);
-        for (const auto& dep : removable_deps) {
-            from_cache[dep.to_target].push_back(dep);
-        }
-        auto to_cache_it = from_cache.find(to);
-        if (to_cache_it != from_cache.end()) {
-            return to_cache_it->second;
+
+    std::shared_ptr<const CodeLevelResults> results;
+    if (!code_level_cache_.Find(from, results)) {
+        try {
+            // 仅做一次 from 级别分析，并将结果按 to 分桶缓存；并发未命中时以先写入的结果为准
+            auto buckets = std::make_shared<CodeLevelResults>();
+            for (auto& dep : source_analyzer_->GetRemovableDependencies(from)) {
+                const TargetId dep_id = table_.FindLabel(dep.to_target);
+                (*buckets)[dep_id].push_back(std::move(dep));
+            }
+            results = code_level_cache_.Insert(from, std::move(buckets));
+        } catch (const std::exception& e) {
+            // 源代码分析可能失败，记录错误但不中断流程
+            LOG_WARN("代码级别分析失败 (" + std::string(table_.Label(from)) + " -> " +
+                     std::string(table_.Label(to)) + "): " + e.what());
+            return {};
         }
-        from_cache.emplace(to, std::vector<RemovableDependency>{});
-        
-    } catch (const std::exception& e) {
-        // 源代码分析可能失败，记录错误但不中断流程
-        LOG_WARN("代码级别分析失败 (" + from + " -> " + to + "): " + e.what());
     }
 
-    code_level_cache_[from][to] = results;
-    return code_level_cache_[from][to];
+    const auto bucket_it = results->find(to);
+    if (bucket_it != results->end()) {
+        return bucket_it->second;
+    }
+    return {};
 }
 
 std::vector<RemovableDependency> CycleDetector::AnalyzeDependencyAtTargetLevel(
-    const std::string& from, const std::string& to) const {
-    auto from_cache_it = target_level_cache_.find(from);
-    if (from_cache_it != target_level_cache_.end()) {
-        auto to_cache_it = from_cache_it->second.find(to);
-        if (to_cache_it != from_cache_it->second.end()) {
-            return to_cache_it->second;
-        }
-    }
-
+    TargetId from, TargetId to) const {
+    const std::uint64_t cache_key = EdgeKey(from, to);
     std::vector<RemovableDependency> results;
-    
-    // 检查目标是否存在
-    auto from_it = targets_.find(from);
-    auto to_it = targets_.find(to);
-    if (from_it == targets_.end() || to_it == targets_.end()) {
-        target_level_cache_[from][to] = results;
-        return target_level_cache_[from][to];
+    if (target_level_cache_.Find(cache_key, results)) {
+        return results;
     }
     
-    const auto& from_target = from_it->second;
-    const auto& to_target = to_it->second;
-    
-    // 检查依赖是否真的在deps列表中
-    bool dep_exists = graph_.HasDirectEdge(from, to);
-    if (!dep_exists) {
-        target_level_cache_[from][to] = results;
-        return target_level_cache_[from][to];
+    // 检查目标是否存在，以及依赖是否真的在deps列表中
+    if (!table_.IsTarget(from) || !table_.IsTarget(to) || !graph_.HasDirectEdge(from, to)) {
+        return target_level_cache_.Insert(cache_key, std::move(results));
     }
     
+    const std::string_view from_rule = table_.RuleType(from);
+    const std::string_view to_rule = table_.RuleType(to);
+    
     // 规则类型分析
-    if (from_target.rule_type == "cc_library" && to_target.rule_type == "cc_library") {
+    if (from_rule == "cc_library" && to_rule == "cc_library") {
         // 库到库的依赖，检查是否必要
         if (!IsCriticalDependency(from, to)) {
             RemovableDependency dep;
-            dep.from_target = from;
-            dep.to_target = to;
+            dep.from_target = std::string(table_.Label(from));
+            dep.to_target = std::string(table_.Label(to));
             dep.reason = "Target级别：存在其他依赖路径";
             results.push_back(dep);
         }
     }
     
     // 检查测试依赖
-    if (from_target.rule_type.find("test") != std::string::npos && 
-        to_target.rule_type == "cc_library") {
+    if (from_rule.find("test") != std::string_view::npos && to_rule == "cc_library") {
         // 测试目标依赖库，通常是必要的，但可以检查是否有过度依赖
         RemovableDependency dep;
-        dep.from_target = from;
-        dep.to_target = to;
+        dep.from_target = std::string(table_.Label(from));
+        dep.to_target = std::string(table_.Label(to));
         dep.reason = "Target级别：测试依赖可能过度";
         dep.confidence = ConfidenceLevel::MEDIUM;
         results.push_back(dep);
     }
     
     // 检查二进制目标依赖
-    if (from_target.rule_type == "cc_binary" && to_target.rule_type == "cc_library") {
+    if (from_rule == "cc_binary" && to_rule == "cc_library") {
         // @TODO 
     }
     
-    target_level_cache_[from][to] = results;
-    return target_level_cache_[from][to];
+    return target_level_cache_.Insert(cache_key, std::move(results));
 }
 
 ConfidenceLevel CycleDetector::CalculateConfidence(const RemovableDependency& dep) const {
@@ -237,39 +513,25 @@ ConfidenceLevel CycleDetector::CalculateConfidence(const RemovableDependency& de
     return ConfidenceLevel::LOW;
 }
 
-bool CycleDetector::IsCriticalDependency(const std::string& from, const std::string& to) const {
-    auto from_cache_it = critical_dependency_cache_.find(from);
-    if (from_cache_it != critical_dependency_cache_.end()) {
-        auto to_cache_it = from_cache_it->second.find(to);
-        if (to_cache_it != from_cache_it->second.end()) {
-            return to_cache_it->second;
+bool CycleDetector::IsCriticalDependency(TargetId from, TargetId to) const {
+    return critical_dependency_cache_.GetOrCompute(EdgeKey(from, to), [&]() {
+        // 获取from的所有依赖（除了to）
+        const auto& deps = graph_.GetDirectDependencyIds(from);
+        if (deps.empty()) {
+            return true;
         }
-    }
 
-    // 获取from的所有依赖（除了to）
-    const auto& deps = graph_.GetDirectDependencies(from);
-    if (deps.empty()) {
-        critical_dependency_cache_[from][to] = true;
-        return true;
-    }
-
-    // 如果to只能通过直接依赖到达，那么这个依赖可能是关键的
-    bool has_alternative_path = false;
-    for (const auto& dep : deps) {
-        if (dep != to) {
-            const auto& dep_transitive = graph_.GetTransitiveDependencies(dep);
-            if (dep_transitive.find(to) != dep_transitive.end()) {
-                has_alternative_path = true;
-                break;
+        // 如果to只能通过直接依赖到达，那么这个依赖可能是关键的
+        for (const TargetId dep : deps) {
+            if (dep != to && graph_.IsTransitiveDependency(dep, to)) {
+                return false;
             }
         }
-    }
-
-    critical_dependency_cache_[from][to] = !has_alternative_path;
-    return critical_dependency_cache_[from][to];
+        return true;
+    });
 }
 
-CycleType CycleDetector::DetermineBaseCycleType(const std::vector<std::string>& cycle) const {
+CycleType CycleDetector::DetermineBaseCycleType(const std::vector<TargetId>& cycle) const {
     if (IsDirectCycle(cycle)) {
         return CycleType::DIRECT_CYCLE;
     } else if (IsDiamondDependency(cycle)) {
@@ -293,25 +555,24 @@ void CycleDetector::ApplyAdditionalClassifications(CycleAnalysis& analysis) cons
     }
 }
 
-bool CycleDetector::IsDirectCycle(const std::vector<std::string>& cycle) const {
+bool CycleDetector::IsDirectCycle(const std::vector<TargetId>& cycle) const {
     if (cycle.size() != 2) return false;
     
-    const auto& a = cycle[0];
-    const auto& b = cycle[1];
+    const TargetId a = cycle[0];
+    const TargetId b = cycle[1];
 
     return graph_.HasDirectEdge(a, b) && graph_.HasDirectEdge(b, a);
 }
 
-bool CycleDetector::IsDiamondDependency(const std::vector<std::string>& cycle) const {
+bool CycleDetector::IsDiamondDependency(const std::vector<TargetId>& cycle) const {
     if (cycle.size() < 4) return false;
     
     // 检查是否存在多个路径到达同一个节点
-    for (const auto& node : cycle) {
-        const auto& deps = graph_.GetTransitiveDependencies(node);
+    for (const TargetId node : cycle) {
         int reachable_count = 0;
         
-        for (const auto& other : cycle) {
-            if (node != other && deps.find(other) != deps.end()) {
+        for (const TargetId other : cycle) {
+            if (node != other && graph_.IsTransitiveDependency(node, other)) {
                 ++reachable_count;
             }
         }
@@ -347,16 +608,15 @@ std::string CycleDetector::ExtractCommonInterface(const std::vector<std::string>
         : base_path + ":" + package_name + "_interface";
 }
 
-bool CycleDetector::ContainsTestTargets(const std::vector<std::string>& cycle) const {
-    return std::any_of(cycle.begin(), cycle.end(), [this](const std::string& target) {
-        auto it = targets_.find(target);
-        if (it != targets_.end()) {
-            const auto& target_info = it->second;
-            return target_info.rule_type.find("test") != std::string::npos ||
-                   target_info.name.find("_test") != std::string::npos ||
-                   target_info.name.find("test_") != std::string::npos;
+bool CycleDetector::ContainsTestTargets(const std::vector<TargetId>& cycle) const {
+    return std::any_of(cycle.begin(), cycle.end(), [this](TargetId target) {
+        if (!table_.IsTarget(target)) {
+            return false;
         }
-        return false;
+        const std::string_view name = table_.Name(target);
+        return table_.RuleType(target).find("test") != std::string_view::npos ||
+               name.find("_test") != std::string_view::npos ||
+               name.find("test_") != std::string_view::npos;
     });
 }
 
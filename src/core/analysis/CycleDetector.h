@@ -5,9 +5,12 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
+#include <mutex>
+#include <cstdint>
 
 #include "graph/DependencyGraph.h"
 #include "analysis/SourceAnalyzer.h"
+#include "concurrency/BoundedConcurrentMap.h"
 
 // 循环类型枚举
 enum class CycleType {
@@ -27,6 +30,52 @@ struct CycleAnalysis {
     std::vector<std::string> suggested_fixes;  // 建议的修复方案
 };
 
+// 强连通分量分析结果（SCC 报告模式）
+struct ComponentAnalysis {
+    std::vector<std::string> targets;            // 分量内的目标
+    size_t internal_edges{0};                    // 分量内部的依赖边
+    size_t entry_edges{0};                       // 从分量外指向分量的边
+    size_t exit_edges{0};                        // 从分量指向外部的边
+    size_t cycle_rank{0};                        // 独立环数（内部边数 - 节点数 + 1）
+    std::vector<CycleAnalysis> covering_cycles;  // 一组短环，分量内每个目标至少出现在其中一个
+    bool truncated{false};                       // 达到环数上限或超时，部分目标未被覆盖
+};
+
+// 反馈边集中的一条边：删除报告中的全部边后依赖图无环
+struct FeedbackEdge {
+    std::string from_target;
+    std::string to_target;
+    std::uint32_t cost{0};       // 删除代价：源码未引用依赖的头文件时最低
+    bool removable{false};       // 源码未引用该依赖，可直接从 deps 中删除
+    size_t component_size{0};    // 所在强连通分量的目标数
+    std::string reason;
+};
+
+// 打破全部循环的近似最小反馈边集（FAS 报告模式）
+struct FeedbackArcSetAnalysis {
+    std::vector<FeedbackEdge> edges;   // 按代价升序
+    size_t total_cost{0};
+    size_t removable_edges{0};
+    size_t cyclic_components{0};
+};
+
+// 传递约简中的一条冗余依赖：from 经由另一个直接依赖 via 已能传递到达 to
+struct TransitiveRedundantEdge {
+    std::string from_target;
+    std::string to_target;
+    std::string via_target;
+    bool used_directly{false};   // 源码直接引用了 to 的头文件，strict deps 下需保留
+    std::string reason;
+};
+
+// cc 依赖图的传递约简（TRANSITIVE_REDUCTION 模式）
+struct TransitiveReductionAnalysis {
+    std::vector<TransitiveRedundantEdge> edges;   // 可删除的在前，同类按 label 排列
+    size_t total_edges{0};                        // 参与约简的 cc 目标之间的直接依赖边数
+    size_t safe_to_drop{0};
+    size_t keep_for_strict_deps{0};
+};
+
 inline std::ostream& operator<<(std::ostream& os, CycleType type) {
     switch (type) {
         case CycleType::DIRECT_CYCLE: 
@@ -48,46 +97,88 @@ inline std::ostream& operator<<(std::ostream& os, CycleType type) {
     return os;
 }
 
+// 循环与未使用依赖分析。构造完成后只读：各项整轮分析在首次调用时计算一次（并发的首次调用只有一个线程计算，
+// 其余等待其结果），边级别缓存为分段加锁的并发表，因此同一个实例可被多个请求线程同时查询
 class CycleDetector {
 public:
-    // 构造函数，接受依赖图和目标映射
-    CycleDetector(const DependencyGraph& graph, const std::unordered_map<std::string, BazelTarget>& targets, const std::string workspace_path);
+    using TargetId = TargetTable::Id;
+
+    // 构造函数，接受依赖图和全工作区目标表；cycle_options 限定环枚举的规模与耗时
+    CycleDetector(const DependencyGraph& graph, const TargetTable& table, const std::string workspace_path,
+                  const DependencyGraph::CycleEnumerationOptions& cycle_options = {});
     
-    // 分析所有循环依赖
-    std::vector<CycleAnalysis> AnalyzeCycles();
+    // 分析所有循环依赖：环由 DependencyGraph::EnumerateCycles 流式产生，按批在共享线程池上并行分类，
+    // 结果顺序与串行分类一致
+    std::vector<CycleAnalysis> AnalyzeCycles() const;
+
+    // 按强连通分量汇总循环依赖，不做逐环枚举，耗时随图规模近线性增长
+    std::vector<ComponentAnalysis> AnalyzeComponents() const;
+
+    // 近似最小反馈边集：按边是否被源码需要加权，源码未引用的边代价最低
+    FeedbackArcSetAnalysis AnalyzeFeedbackArcSet() const;
+
+    // cc 依赖图的传递约简：冗余边按源码是否直接引用依赖分为可删除与 strict deps 下需保留两类
+    TransitiveReductionAnalysis AnalyzeTransitiveReduction() const;
+
+    // 环枚举的统计（是否因上限或超时而截断）；AnalyzeCycles 返回后有效
+    const DependencyGraph::CycleEnumerationStats& GetCycleEnumerationStats() const { return cycle_stats_; }
     
     // 分析未使用依赖
-    std::vector<RemovableDependency> AnalyzeUnusedDependencies();
+    std::vector<RemovableDependency> AnalyzeUnusedDependencies() const;
+
+    // 增量更新时从上一版本迁移边级别缓存与源码分析缓存。affected 为本版本图上的受影响节点
+    // （DependencyGraph::ApplyDelta 的返回值）；须在实例被共享之前调用
+    void InheritCaches(const CycleDetector& previous, const TargetTableDelta& delta, const std::vector<bool>& affected);
 private:
-    // 分类单个循环
+    // 代码级分析结果：依赖 label id -> 该边上的可移除依赖
+    using CodeLevelResults = std::unordered_map<TargetId, std::vector<RemovableDependency>>;
+    // 代码级结果持有的堆内存（估算），供有界缓存记账
+    static size_t CodeLevelResultsBytes(const std::shared_ptr<const CodeLevelResults>& results);
+
+    // 各项整轮分析的实际计算，只在对应的 call_once 中调用
+    std::vector<CycleAnalysis> ComputeCycles() const;
+    std::vector<ComponentAnalysis> ComputeComponents() const;
+    FeedbackArcSetAnalysis ComputeFeedbackArcSet() const;
+    TransitiveReductionAnalysis ComputeTransitiveReduction() const;
+
+    // 分类单个循环；可在多个线程上并发调用
     CycleAnalysis ClassifyCycle(const std::vector<std::string>& cycle) const;
+
+    // 在共享线程池上并行分类一批环，结果按输入顺序追加到 analyses
+    void ClassifyCycles(const std::vector<std::vector<TargetId>>& cycles, std::vector<CycleAnalysis>& analyses) const;
     
     // 分析循环中的可移除依赖
-    void AnalyzeRemovableDependencies(CycleAnalysis& analysis) const;
+    void AnalyzeRemovableDependencies(CycleAnalysis& analysis, const std::vector<TargetId>& cycle_ids) const;
     
     // 代码级别的依赖分析
-    std::vector<RemovableDependency> AnalyzeDependencyAtCodeLevel(const std::string& from, const std::string& to) const;
+    std::vector<RemovableDependency> AnalyzeDependencyAtCodeLevel(TargetId from, TargetId to) const;
     
     // Target级别的依赖分析
-    std::vector<RemovableDependency> AnalyzeDependencyAtTargetLevel(const std::string& from, const std::string& to) const;
+    std::vector<RemovableDependency> AnalyzeDependencyAtTargetLevel(TargetId from, TargetId to) const;
     
     // 计算依赖移除的置信度
     ConfidenceLevel CalculateConfidence(const RemovableDependency& dep) const;
     
     // 检查依赖是否关键（无可替代路径）
-    bool IsCriticalDependency(const std::string& from, const std::string& to) const;
+    bool IsCriticalDependency(TargetId from, TargetId to) const;
     
     // 确定循环的基本类型
-    CycleType DetermineBaseCycleType(const std::vector<std::string>& cycle) const;
+    CycleType DetermineBaseCycleType(const std::vector<TargetId>& cycle) const;
+
+    // 将 id 形式的环转为报告中的路径：两节点环为 [a, b]，更长的环回到起点
+    std::vector<std::string> ToCyclePath(const std::vector<TargetId>& cycle_ids) const;
+
+    // 将循环路径上的 label 转为 label id（不在表中的节点为 kInvalidId）
+    std::vector<TargetId> ToLabelIds(const std::vector<std::string>& cycle) const;
     
     // 检查是否为直接循环（双向依赖）
-    bool IsDirectCycle(const std::vector<std::string>& cycle) const;
+    bool IsDirectCycle(const std::vector<TargetId>& cycle) const;
     
     // 检查是否为菱形依赖
-    bool IsDiamondDependency(const std::vector<std::string>& cycle) const;
+    bool IsDiamondDependency(const std::vector<TargetId>& cycle) const;
     
     // 检查循环是否包含测试目标
-    bool ContainsTestTargets(const std::vector<std::string>& cycle) const;
+    bool ContainsTestTargets(const std::vector<TargetId>& cycle) const;
     
     // 检查循环是否包含外部依赖
     bool ContainsExternalDeps(const std::vector<std::string>& cycle) const;
@@ -107,20 +198,28 @@ private:
 private:
     const std::string workspace_path_;                          // 工作区路径
     const DependencyGraph& graph_;                              // 依赖图引用
-    const std::unordered_map<std::string, BazelTarget>& targets_;  // 目标映射引用
+    const TargetTable& table_;                                  // 目标表引用
+    const DependencyGraph::CycleEnumerationOptions cycle_options_;  // 环枚举上限
+    mutable DependencyGraph::CycleEnumerationStats cycle_stats_;
     std::shared_ptr<SourceAnalyzer> source_analyzer_;           // 源代码分析器
-    // 整轮分析级缓存：同一个 SDK 请求里 cycle/unused/多格式输出会复用这里的结果
-    mutable bool cycles_cached_{false};
-    mutable bool unused_cached_{false};
+    // 整轮分析级缓存：共享同一依赖上下文的请求与多格式输出复用这里的结果，由 call_once 保证只计算一次；
+    // 计算抛出异常时 once_flag 不置位，下一次调用重新计算
+    mutable std::once_flag cycles_once_;
+    mutable std::once_flag unused_once_;
+    mutable std::once_flag components_once_;
+    mutable std::once_flag feedback_arcs_once_;
+    mutable std::once_flag transitive_reduction_once_;
     mutable std::vector<CycleAnalysis> cached_cycles_;
+    mutable std::vector<ComponentAnalysis> cached_components_;
+    mutable FeedbackArcSetAnalysis cached_feedback_arcs_;
+    mutable TransitiveReductionAnalysis cached_transitive_reduction_;
     mutable std::vector<RemovableDependency> cached_unused_dependencies_;
-    // 边级别缓存：避免同一条边反复做代码级/target级判断
-    mutable std::unordered_map<
-        std::string,
-        std::unordered_map<std::string, std::vector<RemovableDependency>>> code_level_cache_;
-    mutable std::unordered_map<
-        std::string,
-        std::unordered_map<std::string, std::vector<RemovableDependency>>> target_level_cache_;
-    mutable std::unordered_map<std::string, std::unordered_map<std::string, bool>>
-        critical_dependency_cache_;
+    // 边级别缓存：避免同一条边反复做代码级/target级判断，并行分类时各线程共享。
+    // 代码级按来源目标整体缓存（一次源码扫描得到该目标所有出边的结果），其余键为 from/to 拼成的 64 位整数
+    // 三张表都受全局缓存预算约束，条目被淘汰后按需重新计算
+    mutable BoundedConcurrentMap<TargetId, std::shared_ptr<const CodeLevelResults>> code_level_cache_{
+        "cycle.code_level", &CodeLevelResultsBytes};
+    mutable BoundedConcurrentMap<std::uint64_t, std::vector<RemovableDependency>> target_level_cache_{
+        "cycle.target_level", &RemovableDependenciesBytes};
+    mutable BoundedConcurrentMap<std::uint64_t, bool> critical_dependency_cache_{"cycle.critical_dependency"};
 }; 
@@ -29,22 +29,46 @@ bool IsLikelyHeaderInclude(const std::string& include_name) {
     return ext == ".h" || ext == ".hh" || ext == ".hpp" || ext == ".hxx" || ext == ".inl" || ext == ".inc";
 }
 
+std::uint64_t DependencyKey(SourceAnalyzer::TargetId target, SourceAnalyzer::TargetId dependency) {
+    return (static_cast<std::uint64_t>(target) << 32) | dependency;
+}
+
+// 超出短字符串缓冲区的部分才占用堆内存
+size_t StringHeapBytes(const std::string& value) {
+    return value.capacity() > sizeof(std::string) - 1 ? value.capacity() + 1 : 0;
+}
+
 }  // namespace
 
-SourceAnalyzer::SourceAnalyzer(const std::unordered_map<std::string, BazelTarget>& targets, const std::string workspace_path) 
-    : workspace_path_(workspace_path), targets_(targets) {
-    for (const auto& [target_name, target] : targets_) {
-        for (const auto& hdr : target.hdrs) {
-            const std::string extension = GetFileExtension(hdr);
-            if (IsHeaderFileExtension(extension)) {
-                provided_header_to_targets_[GetFileName(hdr)].insert(target_name);
-            }
+size_t RemovableDependenciesBytes(const std::vector<RemovableDependency>& dependencies) {
+    size_t bytes = dependencies.capacity() * sizeof(RemovableDependency);
+    for (const auto& dependency : dependencies) {
+        bytes += StringHeapBytes(dependency.from_target) + StringHeapBytes(dependency.to_target) +
+                 StringHeapBytes(dependency.reason);
+    }
+    return bytes;
+}
+
+SourceAnalyzer::SourceAnalyzer(const TargetTable& table, const std::string workspace_path) 
+    : workspace_path_(workspace_path), table_(table), file_caches_(std::make_shared<FileCaches>()) {
+    const auto index_header = [&](TargetId target, TargetId file_id) {
+        const std::string file(table_.File(file_id));
+        if (!IsHeaderFileExtension(GetFileExtension(file))) {
+            return;
         }
-        for (const auto& src : target.srcs) {
-            const std::string extension = GetFileExtension(src);
-            if (IsHeaderFileExtension(extension)) {
-                provided_header_to_targets_[GetFileName(src)].insert(target_name);
-            }
+        // 按 id 升序遍历目标，provider 列表天然有序，只需去掉同一目标的重复项
+        auto& providers = provided_header_to_targets_[GetFileName(file)];
+        if (providers.empty() || providers.back() != target) {
+            providers.push_back(target);
+        }
+    };
+
+    for (TargetId target = 0; target < table_.TargetCount(); ++target) {
+        for (const TargetId hdr : table_.Hdrs(target)) {
+            index_header(target, hdr);
+        }
+        for (const TargetId src : table_.Srcs(target)) {
+            index_header(target, src);
         }
     }
 }
@@ -54,17 +78,20 @@ SourceAnalyzer::~SourceAnalyzer() {
 }
 
 void SourceAnalyzer::AnalyzeTarget(const std::string& target_name) {
-    auto target_it = targets_.find(target_name);
-    if (target_it == targets_.end()) {
+    const TargetId target = table_.FindTarget(target_name);
+    if (target == TargetTable::kInvalidId) {
         LOG_WARN("Target not found: " + target_name);
         return;
     }
+    EnsureTargetAnalyzed(target);
+}
 
-    const auto& target = target_it->second;
+void SourceAnalyzer::AnalyzeTarget(TargetId target) {
     TargetAnalysis analysis;
     
     // 首先收集目标提供的头文件
-    for (const auto& hdrs : target.hdrs) {
+    for (const TargetId hdr_id : table_.Hdrs(target)) {
+        const std::string hdrs(table_.File(hdr_id));
         std::string extension = GetFileExtension(hdrs);
         if (IsHeaderFileExtension(extension)) {
             analysis.provided_headers.insert(GetFileName(hdrs));
@@ -78,7 +105,8 @@ void SourceAnalyzer::AnalyzeTarget(const std::string& target_name) {
     }
     
     // 分析所有源文件
-    for (const auto& src : target.srcs) {
+    for (const TargetId src_id : table_.Srcs(target)) {
+        const std::string src(table_.File(src_id));
         std::string extension = GetFileExtension(src);
         if (IsSourceFileExtension(extension)) {
             SourceInfo src_info;
@@ -97,10 +125,13 @@ void SourceAnalyzer::AnalyzeTarget(const std::string& target_name) {
         }
     }
     
-    // 缓存分析结果
-    std::lock_guard<std::mutex> lock(analysis_mutex_);
-    target_analysis_[target_name] = std::move(analysis);
-    analyzed_targets_.insert(target_name);
+    // 缓存分析结果；EnsureTargetAnalyzed 保证同一目标只有一个线程走到这里
+    target_analysis_.InsertOnce(target, std::make_shared<const TargetAnalysis>(std::move(analysis)));
+}
+
+const TargetAnalysis* SourceAnalyzer::FindTargetAnalysis(TargetId target) const {
+    const auto* analysis = target_analysis_.FindRef(target);
+    return analysis != nullptr ? analysis->get() : nullptr;
 }
 
 void SourceAnalyzer::RecursivelyAnalyzeHeaderIncludes([[maybe_unused]] const std::string& source_file,
@@ -123,12 +154,8 @@ const std::unordered_set<std::string>& SourceAnalyzer::GetRecursiveHeaderInclude
         return empty_set;
     }
 
-    {
-        std::lock_guard<std::mutex> lock(analysis_mutex_);
-        auto cache_it = recursive_header_includes_cache_.find(header_path);
-        if (cache_it != recursive_header_includes_cache_.end()) {
-            return cache_it->second;
-        }
+    if (const auto* cached = file_caches_->recursive_header_includes_cache.FindRef(header_path)) {
+        return *cached;
     }
 
     std::unordered_set<std::string> visited_headers;
@@ -163,27 +190,15 @@ const std::unordered_set<std::string>& SourceAnalyzer::GetRecursiveHeaderInclude
         }
     }
 
-    std::lock_guard<std::mutex> lock(analysis_mutex_);
-    auto [inserted_it, _] =
-        recursive_header_includes_cache_.emplace(header_path, std::move(aggregate_includes));
-    return inserted_it->second;
+    // 并发计算同一头文件时结果相同，先写入的保留
+    return file_caches_->recursive_header_includes_cache.InsertOnce(header_path, std::move(aggregate_includes));
 }
 
 std::string SourceAnalyzer::FindHeaderPath(const std::string& header_name) {
-    {
-        std::lock_guard<std::mutex> lock(analysis_mutex_);
-        auto cache_it = header_path_cache_.find(header_name);
-        if (cache_it != header_path_cache_.end()) {
-            return cache_it->second;
-        }
-    }
-
-    const std::string resolved_path = ResolveWorkspacePath(header_name);
-    {
-        std::lock_guard<std::mutex> lock(analysis_mutex_);
-        header_path_cache_[header_name] = resolved_path;
+    if (const std::string* cached = file_caches_->header_path_cache.FindRef(header_name)) {
+        return *cached;
     }
-    return resolved_path;
+    return file_caches_->header_path_cache.InsertOnce(header_name, ResolveWorkspacePath(header_name));
 }
 
 std::string SourceAnalyzer::ResolveWorkspacePath(const std::string& file_path) const {
@@ -191,12 +206,8 @@ std::string SourceAnalyzer::ResolveWorkspacePath(const std::string& file_path) c
         return "";
     }
 
-    {
-        std::lock_guard<std::mutex> lock(analysis_mutex_);
-        const auto cache_it = resolved_path_cache_.find(file_path);
-        if (cache_it != resolved_path_cache_.end()) {
-            return cache_it->second;
-        }
+    if (const std::string* cached = file_caches_->resolved_path_cache.FindRef(file_path)) {
+        return *cached;
     }
 
     const fs::path input_path(file_path);
@@ -212,11 +223,7 @@ std::string SourceAnalyzer::ResolveWorkspacePath(const std::string& file_path) c
         }
     }
 
-    {
-        std::lock_guard<std::mutex> lock(analysis_mutex_);
-        resolved_path_cache_[file_path] = resolved_path;
-    }
-    return resolved_path;
+    return file_caches_->resolved_path_cache.InsertOnce(file_path, std::move(resolved_path));
 }
 
 bool SourceAnalyzer::ParseSourceFile(const std::string& file_path, SourceInfo& result) {
@@ -241,16 +248,12 @@ bool SourceAnalyzer::ParseIncludesFromFile(
         return false;
     }
 
-    {
-        std::lock_guard<std::mutex> lock(analysis_mutex_);
-        auto cache_it = parsed_includes_cache_.find(resolved_path);
-        if (cache_it != parsed_includes_cache_.end()) {
-            includes = cache_it->second;
-            if (file_name.empty()) {
-                file_name = GetFileName(resolved_path);
-            }
-            return true;
+    if (const auto* cached = file_caches_->parsed_includes_cache.FindRef(resolved_path)) {
+        includes = *cached;
+        if (file_name.empty()) {
+            file_name = GetFileName(resolved_path);
         }
+        return true;
     }
 
     std::ifstream file(resolved_path);
@@ -272,12 +275,7 @@ bool SourceAnalyzer::ParseIncludesFromFile(
         ExtractIncludesFromLine(line, parsed_includes);
     }
 
-    {
-        std::lock_guard<std::mutex> lock(analysis_mutex_);
-        parsed_includes_cache_[resolved_path] = parsed_includes;
-    }
-
-    includes = std::move(parsed_includes);
+    includes = file_caches_->parsed_includes_cache.InsertOnce(resolved_path, std::move(parsed_includes));
     if (file_name.empty()) {
         file_name = GetFileName(resolved_path);
     }
@@ -304,16 +302,20 @@ void SourceAnalyzer::ExtractIncludesFromLine(const std::string& line, std::unord
 }
 
 bool SourceAnalyzer::IsHeaderUsed(const std::string& target_name, const std::string& header_path) {
-    EnsureTargetAnalyzed(target_name);
+    const TargetId target = table_.FindTarget(target_name);
+    if (target == TargetTable::kInvalidId) {
+        LOG_WARN("Target not found: " + target_name);
+        return false;
+    }
+    EnsureTargetAnalyzed(target);
     
-    std::lock_guard<std::mutex> lock(analysis_mutex_);
-    auto it = target_analysis_.find(target_name);
-    if (it == target_analysis_.end()) {
+    const TargetAnalysis* analysis = FindTargetAnalysis(target);
+    if (analysis == nullptr) {
         return false;
     }
 
-    return it->second.included_header_names.find(GetFileName(header_path)) !=
-           it->second.included_header_names.end();
+    return analysis->included_header_names.find(GetFileName(header_path)) !=
+           analysis->included_header_names.end();
 }
 
 bool SourceAnalyzer::IsDependencyNeeded(const std::string& target_name, const std::string& dependency) {
@@ -323,75 +325,90 @@ bool SourceAnalyzer::IsDependencyNeeded(const std::string& target_name, const st
         return false;
     }
 
-    const std::string cache_key = target_name + '\n' + dependency;
-    {
-        std::lock_guard<std::mutex> lock(analysis_mutex_);
-        auto cache_it = dependency_needed_cache_.find(cache_key);
-        if (cache_it != dependency_needed_cache_.end()) {
-            return cache_it->second;
-        }
+    const TargetId target = table_.FindTarget(target_name);
+    if (target == TargetTable::kInvalidId) {
+        LOG_WARN("Target not found: " + target_name);
+        return false;
     }
-    
-    EnsureTargetAnalyzed(target_name);
-
-    std::lock_guard<std::mutex> lock(analysis_mutex_);
-    const auto target_it = target_analysis_.find(target_name);
-    if (target_it == target_analysis_.end()) {
-        dependency_needed_cache_[cache_key] = false;
+    // 表中没有的 label 不可能提供头文件
+    const TargetId dependency_id = table_.FindLabel(dependency);
+    if (dependency_id == TargetTable::kInvalidId) {
         return false;
     }
+    return IsDependencyNeeded(target, dependency_id);
+}
 
-    const auto& target_header_names = target_it->second.included_header_names;
-    if (target_header_names.empty()) {
-        LOG_DEBUG("Target " + target_name + " includes no headers");
-        dependency_needed_cache_[cache_key] = false;
+bool SourceAnalyzer::IsDependencyNeeded(TargetId target, TargetId dependency) {
+    if (target == dependency) {
+        LOG_DEBUG("Self-dependency detected: " + std::string(table_.Label(target)));
+        // 自依赖不应该存在
         return false;
     }
 
-    LOG_DEBUG("Checking if " + target_name + " needs " + dependency);
-    LOG_DEBUG("Target includes " + std::to_string(target_header_names.size()) + " headers");
-    for (const auto& included_header : target_header_names) {
-        const auto provider_it = provided_header_to_targets_.find(included_header);
-        if (provider_it != provided_header_to_targets_.end() &&
-            provider_it->second.find(dependency) != provider_it->second.end()) {
-            LOG_DEBUG("Target " + target_name + " uses header " + included_header + " from " + dependency);
-            dependency_needed_cache_[cache_key] = true;
-            return true;
+    const std::uint64_t cache_key = DependencyKey(target, dependency);
+    bool needed = false;
+    if (dependency_needed_cache_.Find(cache_key, needed)) {
+        return needed;
+    }
+    
+    EnsureTargetAnalyzed(target);
+
+    const TargetAnalysis* analysis = FindTargetAnalysis(target);
+    if (analysis == nullptr) {
+        return dependency_needed_cache_.Insert(cache_key, false);
+    }
+
+    const auto& target_header_names = analysis->included_header_names;
+    if (target_header_names.empty()) {
+        LOG_DEBUG("Target " + std::string(table_.Label(target)) + " includes no headers");
+        return dependency_needed_cache_.Insert(cache_key, false);
+    }
+
+    // 依赖不是工作区目标（外部依赖等）时不会出现在 provider 索引里
+    if (table_.IsTarget(dependency)) {
+        for (const auto& included_header : target_header_names) {
+            const auto provider_it = provided_header_to_targets_.find(included_header);
+            if (provider_it != provided_header_to_targets_.end() &&
+                std::binary_search(provider_it->second.begin(), provider_it->second.end(), dependency)) {
+                LOG_DEBUG("Target " + std::string(table_.Label(target)) + " uses header " +
+                          included_header + " from " + std::string(table_.Label(dependency)));
+                return dependency_needed_cache_.Insert(cache_key, true);
+            }
         }
     }
 
-    LOG_DEBUG("Dependency " + dependency + " is NOT needed by " + target_name);
-    dependency_needed_cache_[cache_key] = false;
-    return false;
+    LOG_DEBUG("Dependency " + std::string(table_.Label(dependency)) + " is NOT needed by " +
+              std::string(table_.Label(target)));
+    return dependency_needed_cache_.Insert(cache_key, false);
 }
 
 std::vector<RemovableDependency> SourceAnalyzer::GetRemovableDependencies(const std::string& target_name) {
-    {
-        std::lock_guard<std::mutex> lock(analysis_mutex_);
-        auto cache_it = removable_dependencies_cache_.find(target_name);
-        if (cache_it != removable_dependencies_cache_.end()) {
-            return cache_it->second;
-        }
+    const TargetId target = table_.FindTarget(target_name);
+    if (target == TargetTable::kInvalidId) {
+        LOG_WARN("Target not found: " + target_name);
+        return {};
     }
+    return GetRemovableDependencies(target);
+}
 
+std::vector<RemovableDependency> SourceAnalyzer::GetRemovableDependencies(TargetId target) {
     std::vector<RemovableDependency> removable_deps;
-    
-    auto target_it = targets_.find(target_name);
-    if (target_it == targets_.end()) {
-        LOG_WARN("Target not found: " + target_name);
+    if (removable_dependencies_cache_.Find(target, removable_deps)) {
         return removable_deps;
     }
-    
-    const auto& target = target_it->second;
+
+    const std::string target_name(table_.Label(target));
+    const auto deps = table_.Deps(target);
     
     LOG_DEBUG("Checking removable dependencies for target: " + target_name);
-    LOG_DEBUG("Target has " + std::to_string(target.deps.size()) + " dependencies");
+    LOG_DEBUG("Target has " + std::to_string(deps.size()) + " dependencies");
     
-    for (const auto& dep : target.deps) {
+    for (const TargetId dep_id : deps) {
+        const std::string dep(table_.Label(dep_id));
         LOG_DEBUG("Checking dependency: " + dep);
         
         // 避免自依赖检查
-        if (dep == target_name) {
+        if (dep_id == target) {
             LOG_DEBUG("Found self-dependency: " + target_name + " -> " + dep);
             removable_deps.push_back({
                 target_name,
@@ -402,7 +419,7 @@ std::vector<RemovableDependency> SourceAnalyzer::GetRemovableDependencies(const
             continue;
         }
         
-        if (!IsDependencyNeeded(target_name, dep)) {
+        if (!IsDependencyNeeded(target, dep_id)) {
             LOG_INFO("Found removable dependency: " + target_name + " -> " + dep);
             removable_deps.push_back({
                 target_name,
@@ -415,11 +432,7 @@ std::vector<RemovableDependency> SourceAnalyzer::GetRemovableDependencies(const
         }
     }
 
-    {
-        std::lock_guard<std::mutex> lock(analysis_mutex_);
-        removable_dependencies_cache_[target_name] = removable_deps;
-    }
-    return removable_deps;
+    return removable_dependencies_cache_.Insert(target, std::move(removable_deps));
 }
 
 std::string SourceAnalyzer::Trim(const std::string& str) const {
@@ -469,18 +482,23 @@ bool SourceAnalyzer::IsHeaderFileExtension(const std::string& ext) const {
     return header_extensions.find(ext) != header_extensions.end();
 }
 
-void SourceAnalyzer::EnsureTargetAnalyzed(const std::string& target_name) {
+void SourceAnalyzer::EnsureTargetAnalyzed(TargetId target) {
+    // 已分析的目标只查一次分段表，不经过 analysis_mutex_
+    if (FindTargetAnalysis(target) != nullptr) {
+        return;
+    }
+
     bool should_analyze = false;
     {
         std::unique_lock<std::mutex> lock(analysis_mutex_);
-        while (analyzed_targets_.find(target_name) == analyzed_targets_.end()) {
-            if (analyzing_targets_.insert(target_name).second) {
+        while (FindTargetAnalysis(target) == nullptr) {
+            if (analyzing_targets_.insert(target).second) {
                 should_analyze = true;
                 break;
             }
             analysis_cv_.wait(lock, [&]() {
-                return analyzed_targets_.find(target_name) != analyzed_targets_.end() ||
-                       analyzing_targets_.find(target_name) == analyzing_targets_.end();
+                return FindTargetAnalysis(target) != nullptr ||
+                       analyzing_targets_.find(target) == analyzing_targets_.end();
             });
         }
         if (!should_analyze) {
@@ -489,57 +507,55 @@ void SourceAnalyzer::EnsureTargetAnalyzed(const std::string& target_name) {
     }
 
     try {
-        AnalyzeTarget(target_name);
+        AnalyzeTarget(target);
     } catch (...) {
         std::lock_guard<std::mutex> lock(analysis_mutex_);
-        analyzing_targets_.erase(target_name);
+        analyzing_targets_.erase(target);
         analysis_cv_.notify_all();
         throw;
     }
 
     {
         std::lock_guard<std::mutex> lock(analysis_mutex_);
-        analyzing_targets_.erase(target_name);
+        analyzing_targets_.erase(target);
     }
     analysis_cv_.notify_all();
 }
 
 const std::unordered_set<std::string>& SourceAnalyzer::GetTargetIncludedHeaders(const std::string& target_name) {
-    EnsureTargetAnalyzed(target_name);
-    
-    std::lock_guard<std::mutex> lock(analysis_mutex_);
-    auto it = target_analysis_.find(target_name);
-    if (it != target_analysis_.end()) {
-        return it->second.included_headers;
-    }
-    
     // 返回空集合的引用
     static const std::unordered_set<std::string> empty_set;
-    return empty_set;
+    const TargetId target = table_.FindTarget(target_name);
+    if (target == TargetTable::kInvalidId) {
+        return empty_set;
+    }
+    EnsureTargetAnalyzed(target);
+    
+    const TargetAnalysis* analysis = FindTargetAnalysis(target);
+    return analysis != nullptr ? analysis->included_headers : empty_set;
 }
 
 const std::unordered_set<std::string>& SourceAnalyzer::GetTargetProvidedHeaders(const std::string& target_name) {
-    EnsureTargetAnalyzed(target_name);
-    
-    std::lock_guard<std::mutex> lock(analysis_mutex_);
-    auto it = target_analysis_.find(target_name);
-    if (it != target_analysis_.end()) {
-        return it->second.provided_headers;
-    }
-    
     // 返回空集合的引用
     static const std::unordered_set<std::string> empty_set;
-    return empty_set;
+    const TargetId target = table_.FindTarget(target_name);
+    if (target == TargetTable::kInvalidId) {
+        return empty_set;
+    }
+    EnsureTargetAnalyzed(target);
+    
+    const TargetAnalysis* analysis = FindTargetAnalysis(target);
+    return analysis != nullptr ? analysis->provided_headers : empty_set;
 }
 
 std::vector<std::string> SourceAnalyzer::GetTargetSourceFiles(const std::string& target_name) const {
     std::vector<std::string> paths;
-    auto it = targets_.find(target_name);
-    if (it != targets_.end()) {
-        for (const auto& src : it->second.srcs) {
-            std::string ext = GetFileExtension(src);
-            if (IsSourceFileExtension(ext)) {
-                paths.push_back(src);
+    const TargetId target = table_.FindTarget(target_name);
+    if (target != TargetTable::kInvalidId) {
+        for (const TargetId src_id : table_.Srcs(target)) {
+            std::string src(table_.File(src_id));
+            if (IsSourceFileExtension(GetFileExtension(src))) {
+                paths.push_back(std::move(src));
             }
         }
     }
@@ -548,12 +564,12 @@ std::vector<std::string> SourceAnalyzer::GetTargetSourceFiles(const std::string&
 
 std::vector<std::string> SourceAnalyzer::GetTargetHeaderFiles(const std::string& target_name) const {
     std::vector<std::string> paths;
-    auto it = targets_.find(target_name);
-    if (it != targets_.end()) {
-        for (const auto& hdr : it->second.hdrs) {
-            std::string ext = GetFileExtension(hdr);
-            if (IsHeaderFileExtension(ext)) {
-                paths.push_back(hdr);
+    const TargetId target = table_.FindTarget(target_name);
+    if (target != TargetTable::kInvalidId) {
+        for (const TargetId hdr_id : table_.Hdrs(target)) {
+            std::string hdr(table_.File(hdr_id));
+            if (IsHeaderFileExtension(GetFileExtension(hdr))) {
+                paths.push_back(std::move(hdr));
             }
         }
     }
@@ -562,33 +578,67 @@ std::vector<std::string> SourceAnalyzer::GetTargetHeaderFiles(const std::string&
 
 void SourceAnalyzer::ClearCache() {
     std::lock_guard<std::mutex> lock(analysis_mutex_);
-    target_analysis_.clear();
-    analyzed_targets_.clear();
+    target_analysis_.Clear();
     analyzing_targets_.clear();
-    header_path_cache_.clear();
-    resolved_path_cache_.clear();
-    parsed_includes_cache_.clear();
+    // 文件级缓存可能与其他版本的分析器共享，换一份新的而不是清空
+    file_caches_ = std::make_shared<FileCaches>();
     warned_unreadable_files_.clear();
-    recursive_header_includes_cache_.clear();
-    dependency_needed_cache_.clear();
-    removable_dependencies_cache_.clear();
+    dependency_needed_cache_.Clear();
+    removable_dependencies_cache_.Clear();
     analysis_cv_.notify_all();
 }
 
 void SourceAnalyzer::ClearTargetCache(const std::string& target_name) {
+    const TargetId target = table_.FindTarget(target_name);
+    if (target == TargetTable::kInvalidId) {
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(analysis_mutex_);
-    target_analysis_.erase(target_name);
-    analyzed_targets_.erase(target_name);
-    analyzing_targets_.erase(target_name);
-    removable_dependencies_cache_.erase(target_name);
-
-    const std::string target_prefix = target_name + '\n';
-    for (auto it = dependency_needed_cache_.begin(); it != dependency_needed_cache_.end();) {
-        if (it->first.rfind(target_prefix, 0) == 0) {
-            it = dependency_needed_cache_.erase(it);
-        } else {
-            ++it;
+    target_analysis_.Erase(target);
+    analyzing_targets_.erase(target);
+    removable_dependencies_cache_.Erase(target);
+    dependency_needed_cache_.EraseIf([target](std::uint64_t key) { return (key >> 32) == target; });
+    analysis_cv_.notify_all();
+}
+
+void SourceAnalyzer::InheritCaches(const SourceAnalyzer& previous, const TargetTableDelta& delta) {
+    // 文件级缓存只与文件内容有关，只改动 BUILD 时全部有效，直接共享
+    file_caches_ = previous.file_caches_;
+
+    // 目标级结果只取决于目标自身的 srcs / hdrs，(target, dependency) 判定还取决于依赖提供的头文件
+    size_t inherited_targets = 0;
+    previous.target_analysis_.ForEach([&](TargetId previous_target, const auto& analysis) {
+        const TargetId target = delta.Map(previous_target);
+        if (table_.IsTarget(target) && !delta.IsChanged(target)) {
+            target_analysis_.InsertOnce(target, analysis);
+            ++inherited_targets;
+        }
+    });
+    previous.dependency_needed_cache_.ForEach([&](std::uint64_t key, bool needed) {
+        const TargetId target = delta.Map(static_cast<TargetId>(key >> 32));
+        const TargetId dependency = delta.Map(static_cast<TargetId>(key));
+        if (table_.IsTarget(target) && dependency != TargetTable::kInvalidId && !delta.IsChanged(target) &&
+            !delta.IsChanged(dependency)) {
+            dependency_needed_cache_.Insert(DependencyKey(target, dependency), needed);
         }
+    });
+    previous.removable_dependencies_cache_.ForEach(
+        [&](TargetId previous_target, const std::vector<RemovableDependency>& removable) {
+            const TargetId target = delta.Map(previous_target);
+            if (!table_.IsTarget(target) || delta.IsChanged(target)) {
+                return;
+            }
+            const auto deps = table_.Deps(target);
+            if (std::none_of(deps.begin(), deps.end(), [&](TargetId dep) { return delta.IsChanged(dep); })) {
+                removable_dependencies_cache_.Insert(target, removable);
+            }
+        });
+
+    {
+        std::scoped_lock lock(analysis_mutex_, previous.analysis_mutex_);
+        warned_unreadable_files_ = previous.warned_unreadable_files_;
     }
-    analysis_cv_.notify_all();
+    LOG_INFO("Source analysis reused for " + std::to_string(inherited_targets) + " of " +
+             std::to_string(table_.TargetCount()) + " targets");
 }
@@ -8,9 +8,14 @@
 #include <stack>
 #include <set>
 #include <condition_variable>
+#include <cstdint>
+#include <memory>
 
 #include "log/logger.h"
 #include "struct.h"
+#include "concurrency/BoundedConcurrentMap.h"
+#include "concurrency/ConcurrentMap.h"
+#include "graph/TargetTable.h"
 
 // 源文件信息结构
 struct SourceInfo {
@@ -41,10 +46,18 @@ struct RemovableDependency {
     ConfidenceLevel confidence;             // 置信度
 };
 
+// 可移除依赖列表持有的堆内存（估算），供有界缓存记账
+size_t RemovableDependenciesBytes(const std::vector<RemovableDependency>& dependencies);
+
+// 源码分析器。各类缓存是分段加锁的并发表，并行分析时查询互不阻塞：目标分析结果与文件级缓存只插入一次、地址稳定，
+// 依赖判定与可移除依赖两张备忘表受全局缓存预算约束，被淘汰后重新计算；
+// analysis_mutex_ 只用于保证同一目标只被分析一次。ClearCache / ClearTargetCache 不能与查询并发调用
 class SourceAnalyzer {
 public:
-    // 构造函数，接收目标映射
-    explicit SourceAnalyzer(const std::unordered_map<std::string, BazelTarget>& targets, const std::string workspace_path);
+    using TargetId = TargetTable::Id;
+
+    // 构造函数，接收全工作区目标表
+    explicit SourceAnalyzer(const TargetTable& table, const std::string workspace_path);
     
     // 析构函数
     ~SourceAnalyzer();
@@ -57,9 +70,12 @@ public:
     
     // 检查依赖是否被需要（正确的逻辑：检查目标是否使用了依赖提供的头文件）
     bool IsDependencyNeeded(const std::string& target_name, const std::string& dependency);
+    // id 版本：target 为目标下标，dependency 为 label id
+    bool IsDependencyNeeded(TargetId target, TargetId dependency);
     
     // 获取目标的可移除依赖列表
     std::vector<RemovableDependency> GetRemovableDependencies(const std::string& target_name);
+    std::vector<RemovableDependency> GetRemovableDependencies(TargetId target);
     
     // 获取目标包含的所有头文件
     const std::unordered_set<std::string>& GetTargetIncludedHeaders(const std::string& target_name);
@@ -78,10 +94,20 @@ public:
     
     // 清空指定目标的缓存
     void ClearTargetCache(const std::string& target_name);
+
+    // 增量更新时从上一版本的分析器继承缓存：文件级缓存直接共享，目标级缓存跳过 delta 中的变更目标。
+    // 前提是两版本之间只有 BUILD / 全局输入变化、源文件未变；须在分析器被共享之前调用
+    void InheritCaches(const SourceAnalyzer& previous, const TargetTableDelta& delta);
     
 private:
     // 确保目标已分析
-    void EnsureTargetAnalyzed(const std::string& target_name);
+    void EnsureTargetAnalyzed(TargetId target);
+
+    // 分析单个目标（id 版本）
+    void AnalyzeTarget(TargetId target);
+
+    // 查找目标分析结果；未分析时返回 nullptr
+    const TargetAnalysis* FindTargetAnalysis(TargetId target) const;
     
     // 解析源文件
     bool ParseSourceFile(const std::string& file_path, SourceInfo& result);
@@ -121,28 +147,32 @@ private:
     bool IsHeaderFileExtension(const std::string& ext) const;
     
 private:
+    // 文件级缓存：只取决于工作区文件内容，增量更新时新旧两个版本的分析器共享同一份
+    struct FileCaches {
+        ConcurrentMap<std::string, std::string> header_path_cache;
+        // 文件路径解析缓存：原始路径 -> 解析后的可访问路径（可能为空字符串）
+        ConcurrentMap<std::string, std::string> resolved_path_cache;
+        // 文件级 include 解析缓存
+        ConcurrentMap<std::string, std::unordered_set<std::string>> parsed_includes_cache;
+        // 递归头文件闭包缓存：header path -> recursive includes
+        ConcurrentMap<std::string, std::unordered_set<std::string>> recursive_header_includes_cache;
+    };
+
     const std::string workspace_path_;   // 工作区路径
-    const std::unordered_map<std::string, BazelTarget>& targets_;  // 目标映射引用
-    // target -> 聚合后的查询结果；不再长期保存逐文件明细对象
-    std::unordered_map<std::string, TargetAnalysis> target_analysis_;
-    std::unordered_set<std::string> analyzed_targets_;
-    // 反向索引：header basename -> provider targets
-    std::unordered_map<std::string, std::unordered_set<std::string>> provided_header_to_targets_;
-    std::unordered_map<std::string, std::string> header_path_cache_;
-    // 文件路径解析缓存：原始路径 -> 解析后的可访问路径（可能为空字符串）
-    mutable std::unordered_map<std::string, std::string> resolved_path_cache_;
-    // 文件级 include 解析缓存
-    std::unordered_map<std::string, std::unordered_set<std::string>> parsed_includes_cache_;
-    // 打不开的文件只告警一次，避免刷日志
-    std::unordered_set<std::string> warned_unreadable_files_;
-    // 递归头文件闭包缓存：header path -> recursive includes
-    std::unordered_map<std::string, std::unordered_set<std::string>> recursive_header_includes_cache_;
-    // target -> dependency 判定缓存
-    std::unordered_map<std::string, bool> dependency_needed_cache_;
+    const TargetTable& table_;           // 目标表引用
+    // target id -> 聚合后的查询结果；不再长期保存逐文件明细对象，增量更新时按 id 映射共享
+    ConcurrentMap<TargetId, std::shared_ptr<const TargetAnalysis>> target_analysis_;
+    // 反向索引：header basename -> provider target id（升序），构造后只读
+    std::unordered_map<std::string, std::vector<TargetId>> provided_header_to_targets_;
+    std::shared_ptr<FileCaches> file_caches_;
+    // (target, dependency) 判定缓存，键为两个 id 拼成的 64 位整数；与下面的可移除依赖缓存一样可重新计算，受全局缓存预算约束
+    BoundedConcurrentMap<std::uint64_t, bool> dependency_needed_cache_{"source.dependency_needed"};
     // target 级可移除依赖缓存
-    std::unordered_map<std::string, std::vector<RemovableDependency>> removable_dependencies_cache_;
-    // 避免并发重复分析同一个 target
-    std::unordered_set<std::string> analyzing_targets_;
+    BoundedConcurrentMap<TargetId, std::vector<RemovableDependency>> removable_dependencies_cache_{
+        "source.removable_dependencies", &RemovableDependenciesBytes};
+    // 以下由 analysis_mutex_ 保护：正在分析的 target（避免并发重复分析），打不开的文件只告警一次
+    std::unordered_set<TargetId> analyzing_targets_;
+    std::unordered_set<std::string> warned_unreadable_files_;
     std::condition_variable analysis_cv_;
     mutable std::mutex analysis_mutex_;
 };
@@ -1,319 +1,722 @@
 #include "DependencyGraph.h"
+#include "concurrency/WorkStealingPool.h"
+#include "log/logger.h"
 #include <algorithm>
-#include <cctype>
+#include <chrono>
 #include <cstdint>
-#include <sstream>
+#include <limits>
+#include <mutex>
+#include <utility>
 #include <vector>
 
-DependencyGraph::DependencyGraph(const std::unordered_map<std::string, BazelTarget>& targets)
-    : source_analyzer_(nullptr), graph_targets_(targets) {
-    BuildGraph();
-    BuildReverseDependencies();
-}
+namespace {
 
-void DependencyGraph::SetSourceAnalyzer(SourceAnalyzer* source_analyzer) const {
-    source_analyzer_ = source_analyzer;
+// 传递闭包的内存上限；超出时退回到按需遍历
+constexpr size_t kMaxClosureBytes = 512ULL * 1024 * 1024;
+
+constexpr std::uint32_t kUnvisited = std::numeric_limits<std::uint32_t>::max();
+
+std::uint64_t EdgeKey(DependencyGraph::NodeId from, DependencyGraph::NodeId to) {
+    return (static_cast<std::uint64_t>(from) << 32) | to;
 }
 
-void DependencyGraph::BuildGraph() {
-    graph_.clear();
-    adjacency_set_.clear();
-    node_names_.clear();
-    node_ids_.clear();
-    adjacency_ids_.clear();
-    graph_.reserve(graph_targets_.size());
-    adjacency_set_.reserve(graph_targets_.size());
-    node_names_.reserve(graph_targets_.size());
-    node_ids_.reserve(graph_targets_.size());
-    
-    for (const auto& [name, target] : graph_targets_) {
-        const size_t from_id = GetOrCreateNodeId(name);
-        std::vector<std::string> dependencies;
-        std::unordered_set<std::string> dependency_set;
-        dependencies.reserve(target.deps.size());
-        dependency_set.reserve(target.deps.size());
-        
-        for (const auto& dep : target.deps) {
-            std::string simplified_dep = SimplifyDependencyName(dep);
-            if (!simplified_dep.empty() && simplified_dep.find("@") == std::string::npos) {
-                const auto [_, inserted] = dependency_set.insert(simplified_dep);
-                if (!inserted) {
+// 每走这么多步检查一次截止时间，避免在稠密分量上频繁读时钟
+constexpr std::uint32_t kDeadlineCheckInterval = 4096;
+
+// 单个强连通分量内的 Johnson 基本环枚举。节点为分量内的局部下标。每一轮先求不小于 start 的节点
+// 导出子图的强连通分量，直接跳到其中含环分量的最小节点 s，只在 s 所在的分量内找经过 s 的环，
+// 然后令 start = s + 1。每个基本环恰好在以其最小节点为起点时输出一次，不需要签名去重；
+// 不在任何含环分量中的起点整段跳过，总代价为 O((n + e)(c + 1))，c 为输出的环数。
+// 分量划分、CIRCUIT 与 UNBLOCK 都用显式栈展开，不受环长度限制。
+class ComponentCycleEnumerator {
+public:
+    ComponentCycleEnumerator(const std::vector<std::uint32_t>& offsets,
+                             const std::vector<std::uint32_t>& edges,
+                             std::chrono::steady_clock::time_point deadline)
+        : offsets_(offsets),
+          edges_(edges),
+          deadline_(deadline),
+          blocked_(offsets.size() - 1, 0),
+          blocked_by_(offsets.size() - 1),
+          member_mark_(offsets.size() - 1, 0),
+          index_(offsets.size() - 1, kUnvisited),
+          lowlink_(offsets.size() - 1, 0),
+          on_stack_(offsets.size() - 1, 0) {}
+
+    // on_cycle 收到从起点开始、不含闭合节点的局部下标序列；返回 false 时停止。
+    // 完整枚举返回 true
+    template <typename OnCycle>
+    bool Run(OnCycle&& on_cycle) {
+        const auto node_count = static_cast<std::uint32_t>(offsets_.size() - 1);
+        std::uint32_t start = 0;
+        while (start < node_count) {
+            if (std::chrono::steady_clock::now() >= deadline_) {
+                deadline_reached_ = true;
+                return false;
+            }
+            const std::uint32_t least = NextCyclicComponent(start);
+            if (least == kUnvisited) {
+                break;
+            }
+            if (!Circuit(least, on_cycle)) {
+                return false;
+            }
+            start = least + 1;
+        }
+        return true;
+    }
+
+    bool DeadlineReached() const { return deadline_reached_; }
+
+private:
+    struct Frame {
+        std::uint32_t node;
+        std::uint32_t next_edge;
+        bool found;   // 从该节点出发已找到回到起点的路径
+    };
+
+    bool InComponent(std::uint32_t node) const { return member_mark_[node] == mark_; }
+
+    // 迭代 Tarjan 求 {start..n} 导出子图的强连通分量，返回含环分量（至少两个节点或带自环）中的最小节点，
+    // 并把该分量标记为当前分量、清空其阻塞状态；不存在时返回 kUnvisited
+    std::uint32_t NextCyclicComponent(std::uint32_t start) {
+        const auto node_count = static_cast<std::uint32_t>(offsets_.size() - 1);
+        std::fill(index_.begin() + start, index_.end(), kUnvisited);
+        std::uint32_t next_index = 0;
+        std::uint32_t least = kUnvisited;
+        members_.clear();
+
+        for (std::uint32_t root = start; root < node_count; ++root) {
+            if (index_[root] != kUnvisited) {
+                continue;
+            }
+            const auto visit = [&](std::uint32_t node) {
+                index_[node] = lowlink_[node] = next_index++;
+                tarjan_stack_.push_back(node);
+                on_stack_[node] = 1;
+                frames_.push_back(Frame{node, offsets_[node], false});
+            };
+            visit(root);
+            while (!frames_.empty()) {
+                Frame& frame = frames_.back();
+                const std::uint32_t node = frame.node;
+                if (frame.next_edge < offsets_[node + 1]) {
+                    const std::uint32_t next = edges_[frame.next_edge++];
+                    if (next < start) {
+                        continue;
+                    }
+                    if (next == node) {
+                        frame.found = true;   // 自环
+                    } else if (index_[next] == kUnvisited) {
+                        visit(next);
+                    } else if (on_stack_[next]) {
+                        lowlink_[node] = std::min(lowlink_[node], index_[next]);
+                    }
+                    continue;
+                }
+
+                const bool self_loop = frame.found;
+                frames_.pop_back();
+                if (!frames_.empty()) {
+                    const std::uint32_t parent = frames_.back().node;
+                    lowlink_[parent] = std::min(lowlink_[parent], lowlink_[node]);
+                }
+                if (lowlink_[node] != index_[node]) {
                     continue;
                 }
-                const size_t to_id = GetOrCreateNodeId(simplified_dep);
-                adjacency_ids_[from_id].push_back(to_id);
-                dependencies.push_back(std::move(simplified_dep));
+                // 弹出以 node 为根的分量
+                const auto it = std::find(tarjan_stack_.rbegin(), tarjan_stack_.rend(), node);
+                const auto first = tarjan_stack_.begin() + (tarjan_stack_.rend() - it - 1);
+                const bool cyclic = tarjan_stack_.end() - first > 1 || self_loop;
+                const std::uint32_t component_least = *std::min_element(first, tarjan_stack_.end());
+                if (cyclic && component_least < least) {
+                    least = component_least;
+                    members_.assign(first, tarjan_stack_.end());
+                }
+                for (auto member = first; member != tarjan_stack_.end(); ++member) {
+                    on_stack_[*member] = 0;
+                }
+                tarjan_stack_.erase(first, tarjan_stack_.end());
             }
         }
-        
-        graph_[name] = std::move(dependencies);
-        adjacency_set_[name] = std::move(dependency_set);
+
+        ++mark_;
+        for (const std::uint32_t member : members_) {
+            member_mark_[member] = mark_;
+            blocked_[member] = 0;
+            blocked_by_[member].clear();
+        }
+        return least;
     }
-}
 
-void DependencyGraph::BuildReverseDependencies() {
-    reverse_deps_cache_.clear();
-    reverse_deps_cache_.reserve(graph_.size());
-    
-    // 构建反向依赖关系图
-    for (const auto& [target, deps] : graph_) {
-        for (const auto& dep : deps) {
-            reverse_deps_cache_[dep].insert(target);
+    template <typename OnCycle>
+    bool Circuit(std::uint32_t start, OnCycle& on_cycle) {
+        path_.assign(1, start);
+        blocked_[start] = 1;
+        frames_.assign(1, Frame{start, offsets_[start], false});
+
+        while (!frames_.empty()) {
+            if (++steps_ % kDeadlineCheckInterval == 0 && std::chrono::steady_clock::now() >= deadline_) {
+                deadline_reached_ = true;
+                return false;
+            }
+
+            Frame& frame = frames_.back();
+            if (frame.next_edge < offsets_[frame.node + 1]) {
+                const std::uint32_t next = edges_[frame.next_edge++];
+                if (next == start) {
+                    frame.found = true;
+                    if (!on_cycle(path_)) {
+                        return false;
+                    }
+                } else if (InComponent(next) && !blocked_[next]) {
+                    blocked_[next] = 1;
+                    path_.push_back(next);
+                    frames_.push_back(Frame{next, offsets_[next], false});
+                }
+                continue;
+            }
+
+            const Frame finished = frame;
+            frames_.pop_back();
+            path_.pop_back();
+            if (finished.found) {
+                Unblock(finished.node);
+                if (!frames_.empty()) {
+                    frames_.back().found = true;
+                }
+            } else {
+                // 暂时走不通：任一后继解除阻塞时再解除该节点
+                for (std::uint32_t edge = offsets_[finished.node]; edge < offsets_[finished.node + 1]; ++edge) {
+                    const std::uint32_t next = edges_[edge];
+                    if (!InComponent(next)) {
+                        continue;
+                    }
+                    auto& waiting = blocked_by_[next];
+                    if (std::find(waiting.begin(), waiting.end(), finished.node) == waiting.end()) {
+                        waiting.push_back(finished.node);
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    void Unblock(std::uint32_t node) {
+        unblock_stack_.assign(1, node);
+        while (!unblock_stack_.empty()) {
+            const std::uint32_t current = unblock_stack_.back();
+            unblock_stack_.pop_back();
+            blocked_[current] = 0;
+            for (const std::uint32_t waiting : blocked_by_[current]) {
+                if (blocked_[waiting]) {
+                    unblock_stack_.push_back(waiting);
+                }
+            }
+            blocked_by_[current].clear();
         }
     }
+
+    const std::vector<std::uint32_t>& offsets_;
+    const std::vector<std::uint32_t>& edges_;
+    const std::chrono::steady_clock::time_point deadline_;
+    std::vector<std::uint8_t> blocked_;
+    std::vector<std::vector<std::uint32_t>> blocked_by_;
+    // 当前起点所在分量：member_mark_[v] == mark_ 的节点
+    std::vector<std::uint32_t> member_mark_;
+    std::uint32_t mark_{0};
+    std::vector<std::uint32_t> members_;
+    // Tarjan 工作数组
+    std::vector<std::uint32_t> index_;
+    std::vector<std::uint32_t> lowlink_;
+    std::vector<std::uint8_t> on_stack_;
+    std::vector<std::uint32_t> tarjan_stack_;
+    std::vector<std::uint32_t> path_;
+    std::vector<Frame> frames_;
+    std::vector<std::uint32_t> unblock_stack_;
+    std::uint64_t steps_{0};
+    bool deadline_reached_{false};
+};
+
+}  // namespace
+
+DependencyGraph::DependencyGraph(const TargetTable& table)
+    : source_analyzer_(nullptr), table_(table) {
+    BuildGraph();
 }
 
-std::string DependencyGraph::SimplifyDependencyName(const std::string& dep) const {
-    const size_t first_space = dep.find_first_of(" \t\n");
-    if (first_space == std::string::npos) {
-        return dep;
-    }
+DependencyGraph::DependencyGraph(const TargetTable& table,
+                                 std::vector<std::uint32_t> forward_offsets,
+                                 std::vector<NodeId> forward_edges,
+                                 std::optional<SccPartition> components)
+    : source_analyzer_(nullptr),
+      table_(table),
+      forward_offsets_(std::move(forward_offsets)),
+      forward_edges_(std::move(forward_edges)),
+      stored_components_(std::move(components)) {
+    BuildReverseEdges();
+}
 
-    std::string result;
-    result.reserve(dep.size());
-    for (char ch : dep) {
-        if (ch != ' ' && ch != '\t' && ch != '\n') {
-            result.push_back(ch);
+void DependencyGraph::SetSourceAnalyzer(SourceAnalyzer* source_analyzer) const {
+    source_analyzer_ = source_analyzer;
+}
+
+std::vector<bool> DependencyGraph::ApplyDelta(const DependencyGraph& previous, const TargetTableDelta& delta) {
+    // 受影响节点：从变更节点沿反向边 BFS，代价与祖先集合的规模成正比
+    std::vector<bool> affected(NodeCount(), false);
+    std::vector<NodeId> queue;
+    for (const NodeId node : delta.changed_ids) {
+        if (!affected[node]) {
+            affected[node] = true;
+            queue.push_back(node);
         }
     }
-    return result;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        for (const NodeId parent : GetReverseDependencyIds(queue[head])) {
+            if (!affected[parent]) {
+                affected[parent] = true;
+                queue.push_back(parent);
+            }
+        }
+    }
+
+    // “传递依赖是否需要”只取决于 target 的可达范围与沿途目标的源码，未受影响的 target 可直接沿用
+    size_t inherited = 0;
+    previous.dependency_need_cache_.ForEach([&](std::uint64_t key, bool needed) {
+        const NodeId target = delta.Map(static_cast<NodeId>(key >> 32));
+        const NodeId dependency = delta.Map(static_cast<NodeId>(key));
+        if (target == TargetTable::kInvalidId || dependency == TargetTable::kInvalidId || affected[target]) {
+            return;
+        }
+        dependency_need_cache_.Insert(EdgeKey(target, dependency), needed);
+        ++inherited;
+    });
+
+    LOG_INFO("Dependency graph delta: " + std::to_string(delta.added.size()) + " added, " +
+             std::to_string(delta.removed.size()) + " removed, " + std::to_string(delta.changed.size()) +
+             " changed targets; " + std::to_string(queue.size()) + " of " + std::to_string(NodeCount()) +
+             " nodes affected, " + std::to_string(inherited) + " dependency checks reused");
+    return affected;
 }
 
-size_t DependencyGraph::GetOrCreateNodeId(const std::string& node_name) {
-    const auto it = node_ids_.find(node_name);
-    if (it != node_ids_.end()) {
-        return it->second;
-    }
+void DependencyGraph::BuildGraph() {
+    const size_t node_count = table_.LabelCount();
+    forward_offsets_.assign(1, 0);
+    forward_offsets_.reserve(node_count + 1);
+    forward_edges_.clear();
+
+    size_t declared_edges = 0;
+    for (NodeId target = 0; target < table_.TargetCount(); ++target) {
+        declared_edges += table_.Deps(target).size();
+    }
+    forward_edges_.reserve(declared_edges);
+
+    // 只有工作区目标有出边；过滤外部依赖后排序去重
+    for (NodeId target = 0; target < table_.TargetCount(); ++target) {
+        const size_t begin = forward_edges_.size();
+        for (const NodeId dep : table_.Deps(target)) {
+            const std::string_view dep_label = table_.Label(dep);
+            if (!dep_label.empty() && dep_label.find('@') == std::string_view::npos) {
+                forward_edges_.push_back(dep);
+            }
+        }
+        const auto first = forward_edges_.begin() + static_cast<std::ptrdiff_t>(begin);
+        std::sort(first, forward_edges_.end());
+        forward_edges_.erase(std::unique(first, forward_edges_.end()), forward_edges_.end());
+        forward_offsets_.push_back(static_cast<std::uint32_t>(forward_edges_.size()));
+    }
+    forward_offsets_.resize(node_count + 1, static_cast<std::uint32_t>(forward_edges_.size()));
+    forward_edges_.shrink_to_fit();
+    BuildReverseEdges();
+}
 
-    const size_t new_id = node_names_.size();
-    node_names_.push_back(node_name);
-    node_ids_.emplace(node_name, new_id);
-    adjacency_ids_.emplace_back();
-    return new_id;
+void DependencyGraph::BuildReverseEdges() {
+    // 反向 CSR：先统计入度做前缀和，再按来源 id 递增顺序回填
+    const size_t node_count = NodeCount();
+    reverse_offsets_.assign(node_count + 1, 0);
+    for (const NodeId dep : forward_edges_) {
+        ++reverse_offsets_[dep + 1];
+    }
+    for (size_t node = 0; node < node_count; ++node) {
+        reverse_offsets_[node + 1] += reverse_offsets_[node];
+    }
+    reverse_edges_.resize(forward_edges_.size());
+    std::vector<std::uint32_t> fill_positions(reverse_offsets_.begin(), reverse_offsets_.end() - 1);
+    for (NodeId node = 0; node < node_count; ++node) {
+        for (const NodeId dep : GetDirectDependencyIds(node)) {
+            reverse_edges_[fill_positions[dep]++] = node;
+        }
+    }
 }
 
-size_t DependencyGraph::GetNodeId(const std::string& node_name) const {
-    const auto it = node_ids_.find(node_name);
-    return it == node_ids_.end() ? static_cast<size_t>(-1) : it->second;
+size_t DependencyGraph::MemoryBytes() const {
+    return sizeof(std::uint32_t) * (forward_offsets_.capacity() + reverse_offsets_.capacity()) +
+           sizeof(NodeId) * (forward_edges_.capacity() + reverse_edges_.capacity());
 }
 
 std::vector<std::vector<std::string>> DependencyGraph::FindCycles() const {
+    return FindCycles(CycleEnumerationOptions());
+}
+
+std::vector<std::vector<std::string>> DependencyGraph::FindCycles(const CycleEnumerationOptions& options,
+                                                                  CycleEnumerationStats* stats) const {
     std::vector<std::vector<std::string>> cycles;
-    std::unordered_map<std::string, int> color;
-    std::unordered_map<std::string, std::string> parent;
-    std::set<std::string> cycle_signatures;
-    color.reserve(graph_.size());
-    parent.reserve(graph_.size());
-
-    const auto components = FindStronglyConnectedComponents();
-    for (const auto& component : components) {
-        if (component.empty()) {
-            continue;
+    const CycleEnumerationStats result = EnumerateCycles(options, [&](const std::vector<NodeId>& cycle) {
+        std::vector<std::string> labels;
+        labels.reserve(cycle.size() + 1);
+        for (const NodeId node : cycle) {
+            labels.emplace_back(table_.Label(node));
+        }
+        if (cycle.size() > 2) {
+            labels.emplace_back(table_.Label(cycle.front()));
         }
+        cycles.push_back(std::move(labels));
+        return true;
+    });
+    if (stats) {
+        *stats = result;
+    }
+    return cycles;
+}
 
-        if (component.size() == 1) {
-            const auto only_node_it = component.begin();
-            auto graph_it = graph_.find(*only_node_it);
-            if (graph_it == graph_.end() ||
-                std::find(graph_it->second.begin(), graph_it->second.end(), *only_node_it) ==
-                    graph_it->second.end()) {
-                continue;
-            }
-            std::vector<std::string> self_cycle = {*only_node_it};
-            const std::string signature = CanonicalizeCycle(self_cycle);
-            if (cycle_signatures.insert(signature).second) {
-                cycles.push_back(std::move(self_cycle));
-            }
+DependencyGraph::CycleEnumerationStats DependencyGraph::EnumerateCycles(
+    const CycleEnumerationOptions& options,
+    const std::function<bool(const std::vector<NodeId>&)>& on_cycle) const {
+    CycleEnumerationStats stats;
+    const auto deadline = std::chrono::steady_clock::now() + options.deadline;
+
+    const SccPartition components = FindStronglyConnectedComponents();
+    std::vector<std::uint32_t> local_index(NodeCount(), 0);
+    std::vector<std::uint32_t> local_offsets;
+    std::vector<std::uint32_t> local_edges;
+    std::vector<NodeId> cycle;
+
+    for (size_t index = 0; index < components.Count(); ++index) {
+        const NodeSpan component = components.Component(index);
+        if (component.size() == 1 && !HasDirectEdge(component[0], component[0])) {
             continue;
         }
+        ++stats.cyclic_components;
 
-        if (component.size() == 2) {
-            auto it = component.begin();
-            const std::string first = *it;
-            ++it;
-            const std::string second = *it;
-            if (HasDirectEdge(first, second) && HasDirectEdge(second, first)) {
-                std::vector<std::string> cycle = {first, second};
-                const std::string signature = CanonicalizeCycle(cycle);
-                if (cycle_signatures.insert(signature).second) {
-                    cycles.push_back(std::move(cycle));
+        // 分量内的局部 CSR：局部下标与全局 id 同序，邻居仍然有序
+        const auto component_id = static_cast<std::uint32_t>(index);
+        for (std::uint32_t local = 0; local < component.size(); ++local) {
+            local_index[component[local]] = local;
+        }
+        local_offsets.assign(1, 0);
+        local_edges.clear();
+        for (const NodeId node : component) {
+            for (const NodeId dep : GetDirectDependencyIds(node)) {
+                if (components.component_of[dep] == component_id) {
+                    local_edges.push_back(local_index[dep]);
                 }
-                continue;
             }
+            local_offsets.push_back(static_cast<std::uint32_t>(local_edges.size()));
         }
 
-        for (const auto& node : component) {
-            if (color[node] == 0) {
-                FindCyclesDFS(node, color, parent, cycles, cycle_signatures, &component);
+        size_t component_cycles = 0;
+        bool budget_reached = false;
+        ComponentCycleEnumerator enumerator(local_offsets, local_edges, deadline);
+        enumerator.Run([&](const std::vector<std::uint32_t>& path) {
+            cycle.clear();
+            for (const std::uint32_t local : path) {
+                cycle.push_back(component[local]);
+            }
+            ++stats.cycles;
+            if (!on_cycle(cycle)) {
+                stats.stopped = true;
+                return false;
             }
+            ++component_cycles;
+            if (options.max_cycles_per_component != 0 && component_cycles >= options.max_cycles_per_component) {
+                budget_reached = true;
+                return false;
+            }
+            return true;
+        });
+
+        if (stats.stopped) {
+            break;
+        }
+        if (enumerator.DeadlineReached()) {
+            stats.deadline_reached = true;
+            break;
+        }
+        if (budget_reached) {
+            ++stats.truncated_components;
         }
     }
-
-    return cycles;
+    return stats;
 }
 
-void DependencyGraph::FindCyclesDFS(
-    const std::string& node,
-    std::unordered_map<std::string, int>& color,
-    std::unordered_map<std::string, std::string>& parent,
-    std::vector<std::vector<std::string>>& cycles,
-    std::set<std::string>& cycle_signatures,
-    const std::unordered_set<std::string>* allowed_nodes) const {
-    
-    color[node] = 1; 
-    
-    auto it = graph_.find(node);
-    if (it != graph_.end()) {
-        for (const auto& neighbor : it->second) {
-            if (allowed_nodes && allowed_nodes->find(neighbor) == allowed_nodes->end()) {
+std::vector<DependencyGraph::ComponentSummary> DependencyGraph::SummarizeComponents(
+    const CycleEnumerationOptions& options) const {
+    std::vector<ComponentSummary> summaries;
+    const auto deadline = std::chrono::steady_clock::now() + options.deadline;
+    bool deadline_reached = false;
+
+    const SccPartition components = FindStronglyConnectedComponents();
+    // 工作数组按节点分配一次；每个节点只属于一个分量，无需在分量之间清零
+    std::vector<NodeId> out_parent(NodeCount(), TargetTable::kInvalidId);  // 根出发的 BFS 树
+    std::vector<NodeId> in_next(NodeCount(), TargetTable::kInvalidId);     // 回到根的 BFS 树
+    std::vector<std::uint32_t> path_mark(NodeCount(), kUnvisited);
+    std::vector<std::uint8_t> covered(NodeCount(), 0);
+    std::vector<NodeId> queue;
+    std::vector<NodeId> out_path;
+
+    for (size_t index = 0; index < components.Count(); ++index) {
+        const NodeSpan component = components.Component(index);
+        if (component.size() < 2) {
+            continue;
+        }
+        const auto component_id = static_cast<std::uint32_t>(index);
+        const auto in_component = [&](NodeId node) { return components.component_of[node] == component_id; };
+
+        ComponentSummary summary;
+        summary.nodes.assign(component.begin(), component.end());
+        for (const NodeId node : component) {
+            for (const NodeId dep : GetDirectDependencyIds(node)) {
+                if (in_component(dep)) {
+                    ++summary.internal_edges;
+                } else {
+                    ++summary.exit_edges;
+                }
+            }
+            for (const NodeId depender : GetReverseDependencyIds(node)) {
+                if (!in_component(depender)) {
+                    ++summary.entry_edges;
+                }
+            }
+        }
+
+        // 以最小 id 为根，在分量内各做一次正向与反向 BFS
+        const NodeId root = component[0];
+        const auto build_tree = [&](std::vector<NodeId>& link, bool forward) {
+            link[root] = root;
+            queue.assign(1, root);
+            for (size_t head = 0; head < queue.size(); ++head) {
+                const NodeId node = queue[head];
+                for (const NodeId next : forward ? GetDirectDependencyIds(node) : GetReverseDependencyIds(node)) {
+                    if (in_component(next) && link[next] == TargetTable::kInvalidId) {
+                        link[next] = node;
+                        queue.push_back(next);
+                    }
+                }
+            }
+        };
+        build_tree(out_parent, true);
+        build_tree(in_next, false);
+
+        // 对每个尚未覆盖的节点 v：取根到 v 的树路径 P 与 v 回到根的树路径 Q，
+        // Q 上第一个落在 P 中的节点 x 与 v 之间的两段拼成经过 v 的基本环。
+        // 单个环的代价与两条树路径长度成正比，已覆盖的节点不再处理
+        for (std::uint32_t position = 0; position < component.size(); ++position) {
+            const NodeId node = component[position];
+            if (covered[node]) {
                 continue;
             }
-            if (color[neighbor] == 0) {
-                parent[neighbor] = node;
-                FindCyclesDFS(neighbor, color, parent, cycles, cycle_signatures, allowed_nodes);
-            } else if (color[neighbor] == 1) {
-                std::vector<std::string> cycle;
-                std::string current = node;
-                
-                while (current != neighbor) {
-                    cycle.push_back(current);
-                    const auto parent_it = parent.find(current);
-                    if (parent_it == parent.end()) {
-                        cycle.clear();
-                        break;
+            if (deadline_reached || std::chrono::steady_clock::now() >= deadline) {
+                deadline_reached = true;
+                summary.truncated = true;
+                break;
+            }
+            if (options.max_cycles_per_component != 0 &&
+                summary.cycles.size() >= options.max_cycles_per_component) {
+                summary.truncated = true;
+                break;
+            }
+
+            NodeId tail = node;
+            if (node == root) {
+                // 根：取 BFS 深度最浅的分量内前驱 u，环为根到 u 的树路径加边 u -> 根
+                tail = TargetTable::kInvalidId;
+                size_t best_depth = std::numeric_limits<size_t>::max();
+                for (const NodeId depender : GetReverseDependencyIds(root)) {
+                    if (depender == root || !in_component(depender)) {
+                        continue;
+                    }
+                    size_t depth = 0;
+                    for (NodeId current = depender; current != root; current = out_parent[current]) {
+                        ++depth;
+                    }
+                    if (depth < best_depth) {
+                        best_depth = depth;
+                        tail = depender;
                     }
-                    current = parent_it->second;
                 }
-                if (cycle.empty()) {
-                    continue;
+            }
+
+            out_path.clear();
+            for (NodeId current = tail; ; current = out_parent[current]) {
+                out_path.push_back(current);
+                path_mark[current] = position;
+                if (current == root) {
+                    break;
                 }
-                cycle.push_back(neighbor);
-                cycle.push_back(node);
-                
-                std::reverse(cycle.begin(), cycle.end());
-                const std::string signature = CanonicalizeCycle(cycle);
-                if (cycle_signatures.insert(signature).second) {
-                    cycles.push_back(std::move(cycle));
+            }
+            std::reverse(out_path.begin(), out_path.end());
+
+            std::vector<NodeId> cycle;
+            if (node == root) {
+                cycle = out_path;
+            } else {
+                NodeId join = in_next[node];
+                std::vector<NodeId> back_path;
+                while (path_mark[join] != position) {
+                    back_path.push_back(join);
+                    join = in_next[join];
                 }
+                const auto join_it = std::find(out_path.begin(), out_path.end(), join);
+                cycle.assign(join_it, out_path.end());
+                cycle.insert(cycle.end(), back_path.begin(), back_path.end());
+            }
+
+            std::rotate(cycle.begin(), std::min_element(cycle.begin(), cycle.end()), cycle.end());
+            for (const NodeId member : cycle) {
+                covered[member] = 1;
             }
+            summary.cycles.push_back(std::move(cycle));
         }
+        summaries.push_back(std::move(summary));
+    }
+
+    if (deadline_reached) {
+        LOG_WARN("Component summary stopped at the time limit; some strongly connected components are only partially covered");
     }
-    
-    color[node] = 2; 
+    std::stable_sort(summaries.begin(), summaries.end(), [](const ComponentSummary& a, const ComponentSummary& b) {
+        return a.nodes.size() > b.nodes.size();
+    });
+    return summaries;
 }
 
-std::vector<std::unordered_set<std::string>> DependencyGraph::FindStronglyConnectedComponents() const {
-    std::vector<std::unordered_set<std::string>> components;
-    std::unordered_map<std::string, int> index_map;
-    std::unordered_map<std::string, int> low_link;
-    std::vector<std::string> stack;
-    std::unordered_set<std::string> on_stack;
-    int current_index = 0;
+SccPartition DependencyGraph::FindStronglyConnectedComponents() const {
+    if (stored_components_) {
+        return *stored_components_;
+    }
+    const size_t node_count = NodeCount();
+    SccPartition components;
+    components.component_of.assign(node_count, kUnvisited);
+    components.nodes.reserve(node_count);
+
+    // 全部工作数组一次性分配；已访问但尚未归入分量的节点即在 Tarjan 栈上
+    std::vector<std::uint32_t> index_map(node_count, kUnvisited);
+    std::vector<std::uint32_t> low_link(node_count, 0);
+    std::vector<NodeId> stack;
+    std::vector<std::pair<NodeId, std::uint32_t>> call_stack;
+    stack.reserve(node_count);
+    call_stack.reserve(node_count);
+    std::uint32_t current_index = 0;
+
+    const auto visit = [&](NodeId node) {
+        index_map[node] = current_index;
+        low_link[node] = current_index;
+        ++current_index;
+        stack.push_back(node);
+        call_stack.emplace_back(node, forward_offsets_[node]);
+    };
+
+    for (NodeId root = 0; root < node_count; ++root) {
+        if (index_map[root] != kUnvisited) {
+            continue;
+        }
+        visit(root);
+
+        while (!call_stack.empty()) {
+            const NodeId node = call_stack.back().first;
+            std::uint32_t& next_edge = call_stack.back().second;
+            if (next_edge < forward_offsets_[node + 1]) {
+                const NodeId neighbor = forward_edges_[next_edge++];
+                if (index_map[neighbor] == kUnvisited) {
+                    visit(neighbor);
+                } else if (components.component_of[neighbor] == kUnvisited) {
+                    low_link[node] = std::min(low_link[node], index_map[neighbor]);
+                }
+                continue;
+            }
 
-    index_map.reserve(graph_.size());
-    low_link.reserve(graph_.size());
-    stack.reserve(graph_.size());
-    on_stack.reserve(graph_.size());
+            call_stack.pop_back();
+            if (!call_stack.empty()) {
+                const NodeId caller = call_stack.back().first;
+                low_link[caller] = std::min(low_link[caller], low_link[node]);
+            }
+            if (low_link[node] != index_map[node]) {
+                continue;
+            }
 
-    for (const auto& [node, _] : graph_) {
-        if (index_map.find(node) == index_map.end()) {
-            FindStronglyConnectedComponentsDFS(
-                node, current_index, index_map, low_link, stack, on_stack, components);
+            const auto component = static_cast<std::uint32_t>(components.Count());
+            const size_t begin = components.nodes.size();
+            NodeId current;
+            do {
+                current = stack.back();
+                stack.pop_back();
+                components.component_of[current] = component;
+                components.nodes.push_back(current);
+            } while (current != node);
+            std::sort(components.nodes.begin() + static_cast<std::ptrdiff_t>(begin), components.nodes.end());
+            components.offsets.push_back(static_cast<std::uint32_t>(components.nodes.size()));
         }
     }
 
     return components;
 }
 
-void DependencyGraph::FindStronglyConnectedComponentsDFS(
-    const std::string& node,
-    int& current_index,
-    std::unordered_map<std::string, int>& index_map,
-    std::unordered_map<std::string, int>& low_link,
-    std::vector<std::string>& stack,
-    std::unordered_set<std::string>& on_stack,
-    std::vector<std::unordered_set<std::string>>& components) const {
-    index_map[node] = current_index;
-    low_link[node] = current_index;
-    ++current_index;
-    stack.push_back(node);
-    on_stack.insert(node);
-
-    auto graph_it = graph_.find(node);
-    if (graph_it != graph_.end()) {
-        for (const auto& neighbor : graph_it->second) {
-            if (index_map.find(neighbor) == index_map.end()) {
-                FindStronglyConnectedComponentsDFS(
-                    neighbor, current_index, index_map, low_link, stack, on_stack, components);
-                low_link[node] = std::min(low_link[node], low_link[neighbor]);
-            } else if (on_stack.find(neighbor) != on_stack.end()) {
-                low_link[node] = std::min(low_link[node], index_map[neighbor]);
-            }
-        }
-    }
-
-    if (low_link[node] != index_map[node]) {
-        return;
-    }
-
-    std::unordered_set<std::string> component;
-    while (!stack.empty()) {
-        std::string current = std::move(stack.back());
-        stack.pop_back();
-        on_stack.erase(current);
-        component.insert(current);
-        if (current == node) {
-            break;
-        }
-    }
-    components.push_back(std::move(component));
+bool DependencyGraph::HasDirectEdge(const std::string& from, const std::string& to) const {
+    const NodeId from_id = table_.FindLabel(from);
+    const NodeId to_id = table_.FindLabel(to);
+    return from_id != TargetTable::kInvalidId && to_id != TargetTable::kInvalidId &&
+           HasDirectEdge(from_id, to_id);
 }
 
-bool DependencyGraph::HasDirectEdge(const std::string& from, const std::string& to) const {
-    auto adjacency_it = adjacency_set_.find(from);
-    if (adjacency_it == adjacency_set_.end()) {
-        return false;
-    }
-    return adjacency_it->second.find(to) != adjacency_it->second.end();
+bool DependencyGraph::HasDirectEdge(NodeId from, NodeId to) const {
+    const NodeSpan deps = GetDirectDependencyIds(from);
+    return std::binary_search(deps.begin(), deps.end(), to);
 }
 
-const std::unordered_set<std::string>& DependencyGraph::GetTransitiveDependencies(
-    const std::string& target) const {
-    return GetTransitiveDependenciesRef(target);
+std::vector<std::string> DependencyGraph::GetTransitiveDependencies(const std::string& target) const {
+    std::vector<std::string> transitive_deps;
+    const NodeId target_id = table_.FindLabel(target);
+    if (target_id == TargetTable::kInvalidId) {
+        return transitive_deps;
+    }
+
+    const std::vector<NodeId> transitive_ids = GetTransitiveDependencyIds(target_id);
+    transitive_deps.reserve(transitive_ids.size());
+    for (const NodeId dep_id : transitive_ids) {
+        transitive_deps.emplace_back(table_.Label(dep_id));
+    }
+    return transitive_deps;
 }
 
 std::vector<std::string> DependencyGraph::FindUnusedDependencies(const std::string& target) const {
     std::vector<std::string> unused_deps;
-    
-    auto it = graph_.find(target);
-    if (it == graph_.end()) {
+
+    const NodeId target_id = table_.FindTarget(target);
+    if (target_id == TargetTable::kInvalidId) {
         return unused_deps;
     }
-    
-    // 预分配内存
-    unused_deps.reserve(it->second.size());
-    
-    // 使用源码分析器进行精确分析
-    if (source_analyzer_) {
-        for (const auto& direct_dep : it->second) {
-            if (!IsDependencyTrulyNeeded(target, direct_dep)) {
-                unused_deps.push_back(direct_dep);
-            }
-        }
-    } else {
-        // 使用简单的依赖图分析
-        for (const auto& declared_dep : it->second) {
-            if (!IsDependencyUsed(declared_dep, target)) {
-                unused_deps.push_back(declared_dep);
-            }
-        }
+
+    const std::vector<NodeId> unused_ids = FindUnusedDependencyIds(target_id);
+    unused_deps.reserve(unused_ids.size());
+    for (const NodeId dep_id : unused_ids) {
+        unused_deps.emplace_back(table_.Label(dep_id));
     }
-    
     return unused_deps;
 }
 
-bool DependencyGraph::IsDependencyTrulyNeeded(const std::string& target, 
-                                            const std::string& dependency) const {
+std::vector<DependencyGraph::NodeId> DependencyGraph::FindUnusedDependencyIds(NodeId target) const {
+    std::vector<NodeId> unused_ids;
+    for (const NodeId dep_id : GetDirectDependencyIds(target)) {
+        // 有源码分析器时做精确分析，否则退回到依赖图分析
+        const bool needed = source_analyzer_ ? IsDependencyTrulyNeeded(target, dep_id)
+                                             : IsDependencyUsed(dep_id, target);
+        if (!needed) {
+            unused_ids.push_back(dep_id);
+        }
+    }
+    return unused_ids;
+}
+
+bool DependencyGraph::IsDependencyTrulyNeeded(NodeId target, NodeId dependency) const {
     // 直接检查目标是否使用了依赖中的头文件
     if (!source_analyzer_->IsDependencyNeeded(target, dependency)) {
         // 目标没有直接使用这个依赖
@@ -325,231 +728,227 @@ bool DependencyGraph::IsDependencyTrulyNeeded(const std::string& target,
     return true;
 }
 
-bool DependencyGraph::IsDependencyNeededByTransitiveDeps(const std::string& target,
-                                                       const std::string& dependency) const {
-    const auto target_cache_it = dependency_need_cache_.find(target);
-    if (target_cache_it != dependency_need_cache_.end()) {
-        const auto cached_it = target_cache_it->second.find(dependency);
-        if (cached_it != target_cache_it->second.end()) {
-            return cached_it->second;
-        }
-    }
-
+bool DependencyGraph::IsDependencyNeededByTransitiveDeps(NodeId target, NodeId dependency) const {
     // 检查目标的直接依赖是否依赖这个库
-    auto target_deps_it = graph_.find(target);
-    if (target_deps_it == graph_.end()) {
+    if (!table_.IsTarget(target)) {
         return false;
     }
-    
-    for (const auto& direct_dep : target_deps_it->second) {
-        if (direct_dep == dependency) continue;
-        
-        // 获取直接依赖的传递依赖
-        const auto& transitive_deps = GetTransitiveDependenciesRef(direct_dep);
-        if (transitive_deps.find(dependency) != transitive_deps.end()) {
-            // 检查这个直接依赖是否真正需要该依赖
-            if (source_analyzer_) {
-                if (source_analyzer_->IsDependencyNeeded(direct_dep, dependency)) {
-                    // 直接依赖真正需要这个依赖，所以目标需要传递声明
-                    dependency_need_cache_[target][dependency] = true;
-                    return true;
-                }
+
+    return dependency_need_cache_.GetOrCompute(EdgeKey(target, dependency), [&]() {
+        for (const NodeId direct_dep : GetDirectDependencyIds(target)) {
+            if (direct_dep == dependency) continue;
+
+            // 直接依赖的传递依赖中包含该依赖时，检查这个直接依赖是否真正需要它
+            if (IsTransitiveDependency(direct_dep, dependency) && source_analyzer_ &&
+                source_analyzer_->IsDependencyNeeded(direct_dep, dependency)) {
+                // 直接依赖真正需要这个依赖，所以目标需要传递声明
+                return true;
             }
         }
-    }
-    
-    dependency_need_cache_[target][dependency] = false;
-    return false;
+        return false;
+    });
 }
 
-bool DependencyGraph::IsDependencyUsed(const std::string& dependency, 
-                                     const std::string& exclude_target) const {
-    // 使用缓存的反向依赖关系来快速检查
-    auto reverse_it = reverse_deps_cache_.find(dependency);
-    if (reverse_it == reverse_deps_cache_.end()) {
-        // 没有其他目标依赖它
-        return false;
-    }
-    
-    const auto& reverse_deps = reverse_it->second;
-    
+bool DependencyGraph::IsDependencyUsed(NodeId dependency, NodeId exclude_target) const {
     // 检查是否有除了exclude_target之外的其他目标依赖它
-    for (const auto& depender : reverse_deps) {
+    for (const NodeId depender : GetReverseDependencyIds(dependency)) {
         if (depender != exclude_target) {
             return true;
         }
     }
-    
+
     return false;
 }
 
-const std::unordered_set<std::string>& DependencyGraph::GetReverseDependencies(
-    const std::string& target) const {
-    auto it = reverse_deps_cache_.find(target);
-    if (it != reverse_deps_cache_.end()) {
-        return it->second;
+std::vector<std::string> DependencyGraph::GetReverseDependencies(const std::string& target) const {
+    std::vector<std::string> dependers;
+    const NodeId target_id = table_.FindLabel(target);
+    if (target_id == TargetTable::kInvalidId) {
+        return dependers;
     }
-    return empty_dependency_set_;
-}
 
-const std::vector<std::string>& DependencyGraph::GetDirectDependencies(const std::string& target) const {
-    static const std::vector<std::string> empty_deps;
-    
-    auto it = graph_.find(target);
-    if (it != graph_.end()) {
-        return it->second;
+    const NodeSpan reverse_deps = GetReverseDependencyIds(target_id);
+    dependers.reserve(reverse_deps.size());
+    for (const NodeId depender : reverse_deps) {
+        dependers.emplace_back(table_.Label(depender));
     }
-    
-    return empty_deps;
+    return dependers;
 }
 
-std::vector<RemovableDependency> DependencyGraph::FindAllUnusedDependencies() const {
-    std::vector<RemovableDependency> all_unused_deps;
-    
-    size_t total_deps = 0;
-    for (const auto& [_, deps] : graph_) {
-        total_deps += deps.size();
-    }
-
-     // 假设25%的依赖是未使用的
-    all_unused_deps.reserve(total_deps / 4);
-    
-    for (const auto& [target_name, _] : graph_) {
-        std::vector<std::string> unused_deps = FindUnusedDependencies(target_name);
-        if (!unused_deps.empty()) {
-            const size_t current_size = all_unused_deps.size();
-            all_unused_deps.resize(current_size + unused_deps.size());
-            
-            auto it = all_unused_deps.begin() + current_size;
-            for (const auto& unused_dep : unused_deps) {
-                it->from_target = target_name;
-                it->to_target = unused_dep;
-                it->reason = "Dependency is not used by source code";
-                it->confidence = source_analyzer_ ? ConfidenceLevel::HIGH : ConfidenceLevel::MEDIUM;
-                ++it;
-            }
-        }
-    }
-    
-    // 压缩
-    if (all_unused_deps.capacity() > all_unused_deps.size() * 1.5) {
-        all_unused_deps.shrink_to_fit();
-    }
-    
-    return all_unused_deps;
-}
-
-std::vector<std::string> DependencyGraph::FindTransitiveRedundantDependencies(const std::string& target) const {
-    std::vector<std::string> redundant_deps;
-    
-    auto it = graph_.find(target);
-    if (it == graph_.end()) {
-        return redundant_deps;
-    }
-    
-    // 检查每个直接依赖是否可以被省略
-    for (const auto& direct_dep : it->second) {
-        // 检查这个直接依赖是否已经通过其他路径成为传递依赖
-        for (const auto& other_dep : it->second) {
-            if (other_dep == direct_dep) continue;
-            
-            // 获取其他依赖的传递依赖
-            const auto& other_transitive = GetTransitiveDependenciesRef(other_dep);
-            if (other_transitive.find(direct_dep) != other_transitive.end()) {
-                // 这个依赖已经通过其他路径传递了
-                // 使用源码分析器进一步确认
-                if (source_analyzer_) {
-                    if (!source_analyzer_->IsDependencyNeeded(target, direct_dep) &&
-                        !IsDependencyNeededByTransitiveDeps(target, direct_dep)) {
-                        // 目标不需要这个依赖，可以省略
-                        redundant_deps.push_back(direct_dep);
-                    }
-                } else {
-                    // 如果没有源码分析器，基于依赖图判断
-                    redundant_deps.push_back(direct_dep);
-                }
-                break;
-            }
-        }
+std::vector<std::string> DependencyGraph::GetDirectDependencies(const std::string& target) const {
+    std::vector<std::string> dependencies;
+    const NodeId target_id = table_.FindLabel(target);
+    if (target_id == TargetTable::kInvalidId) {
+        return dependencies;
     }
-    
-    return redundant_deps;
-}
 
-const std::unordered_set<std::string>& DependencyGraph::GetTransitiveDependenciesRef(
-    const std::string& target) const {
-    auto cache_it = transitive_deps_cache_.find(target);
-    if (cache_it != transitive_deps_cache_.end()) {
-        return cache_it->second;
+    const NodeSpan deps = GetDirectDependencyIds(target_id);
+    dependencies.reserve(deps.size());
+    for (const NodeId dep : deps) {
+        dependencies.emplace_back(table_.Label(dep));
     }
+    return dependencies;
+}
 
-    const size_t target_id = GetNodeId(target);
-    if (target_id == static_cast<size_t>(-1) || target_id >= adjacency_ids_.size()) {
-        return empty_dependency_set_;
+std::vector<RemovableDependency> DependencyGraph::FindAllUnusedDependencies() const {
+    // 逆拓扑序调度：分量按 Tarjan 完成顺序编号，依赖先于依赖者开始扫描。扫描一个目标时
+    // IsDependencyNeededByTransitiveDeps 会分析它的直接依赖，这些分析多半已由依赖自己的扫描完成
+    const SccPartition components = FindStronglyConnectedComponents();
+    std::vector<NodeId> schedule;
+    schedule.reserve(table_.TargetCount());
+    for (const NodeId node : components.nodes) {
+        if (table_.IsTarget(node)) {
+            schedule.push_back(node);
+        }
     }
 
-    std::unordered_set<std::string> transitive_deps;
-    transitive_deps.reserve(adjacency_ids_[target_id].size() * 2 + 1);
+    // 每个目标写自己的槽位，合并时按 label id 顺序拼接，结果与线程数无关
+    std::vector<std::vector<NodeId>> unused_by_target(table_.TargetCount());
+    WorkStealingPool::Instance().ParallelFor(schedule.size(), [&](size_t index) {
+        const NodeId target = schedule[index];
+        unused_by_target[target] = FindUnusedDependencyIds(target);
+    });
 
-    std::vector<size_t> traversal_queue;
-    traversal_queue.reserve(adjacency_ids_[target_id].size() * 2 + 1);
-    std::vector<std::uint8_t> visited_ids(node_names_.size(), 0);
+    size_t unused_count = 0;
+    for (const auto& unused_ids : unused_by_target) {
+        unused_count += unused_ids.size();
+    }
+    std::vector<RemovableDependency> all_unused_deps;
+    all_unused_deps.reserve(unused_count);
 
-    for (const size_t dep_id : adjacency_ids_[target_id]) {
-        if (dep_id >= visited_ids.size() || visited_ids[dep_id] != 0) {
+    // 按 label id（即 label 字典序）输出，顺序稳定
+    for (NodeId target = 0; target < table_.TargetCount(); ++target) {
+        if (unused_by_target[target].empty()) {
             continue;
         }
-        visited_ids[dep_id] = 1;
-        traversal_queue.push_back(dep_id);
+        const std::string target_name(table_.Label(target));
+        for (const NodeId unused_dep : unused_by_target[target]) {
+            RemovableDependency dep;
+            dep.from_target = target_name;
+            dep.to_target = std::string(table_.Label(unused_dep));
+            dep.reason = "Dependency is not used by source code";
+            dep.confidence = source_analyzer_ ? ConfidenceLevel::HIGH : ConfidenceLevel::MEDIUM;
+            all_unused_deps.push_back(std::move(dep));
+        }
     }
 
-    size_t cursor = 0;
-    while (cursor < traversal_queue.size()) {
-        const size_t current = traversal_queue[cursor++];
-        if (current >= node_names_.size()) {
-            continue;
-        }
-        transitive_deps.insert(node_names_[current]);
+    return all_unused_deps;
+}
 
-        if (current >= adjacency_ids_.size()) {
-            continue;
-        }
+std::vector<DependencyGraph::RedundantEdge> DependencyGraph::FindTransitivelyRedundantEdges(
+    const std::function<bool(NodeId)>& include) const {
+    const SccPartition components = FindStronglyConnectedComponents();
+    const auto& component_of = components.component_of;
 
-        for (const size_t dep_id : adjacency_ids_[current]) {
-            if (dep_id < visited_ids.size() && visited_ids[dep_id] == 0) {
-                visited_ids[dep_id] = 1;
-                traversal_queue.push_back(dep_id);
+    std::vector<std::vector<RedundantEdge>> redundant_by_target(table_.TargetCount());
+    WorkStealingPool::Instance().ParallelFor(table_.TargetCount(), [&](size_t index) {
+        const auto from = static_cast<NodeId>(index);
+        if (!include(from)) {
+            return;
+        }
+        std::vector<NodeId> candidates;
+        for (const NodeId dep : GetDirectDependencyIds(from)) {
+            if (component_of[dep] != component_of[from] && include(dep)) {
+                candidates.push_back(dep);
             }
         }
+        // 能到达 to 的依赖在拓扑序上更靠前（分量编号更大），按分量编号降序检查时它一定先被处理；
+        // 同一分量内的两个依赖互相可达，按 id 保留较小的一个
+        std::sort(candidates.begin(), candidates.end(), [&](NodeId lhs, NodeId rhs) {
+            return component_of[lhs] != component_of[rhs] ? component_of[lhs] > component_of[rhs] : lhs < rhs;
+        });
+
+        // 冗余依赖能到达的节点，保留下来的依赖也都能到达，因此只需与已保留的依赖比较
+        std::vector<NodeId> kept;
+        auto& redundant = redundant_by_target[from];
+        for (const NodeId to : candidates) {
+            const auto via = std::find_if(kept.begin(), kept.end(),
+                                          [&](NodeId kept_dep) { return IsTransitiveDependency(kept_dep, to); });
+            if (via != kept.end()) {
+                redundant.push_back(RedundantEdge{from, to, *via});
+            } else {
+                kept.push_back(to);
+            }
+        }
+        std::sort(redundant.begin(), redundant.end(),
+                  [](const RedundantEdge& lhs, const RedundantEdge& rhs) { return lhs.to < rhs.to; });
+    });
+
+    std::vector<RedundantEdge> redundant_edges;
+    for (auto& redundant : redundant_by_target) {
+        redundant_edges.insert(redundant_edges.end(), redundant.begin(), redundant.end());
     }
+    return redundant_edges;
+}
 
-    auto [inserted_it, _] = transitive_deps_cache_.emplace(target, std::move(transitive_deps));
-    return inserted_it->second;
+const TransitiveClosure& DependencyGraph::GetTransitiveClosure() const {
+    // 并行的环分类会同时查询可达性，闭包只构建一次，其他线程等待构建完成
+    std::call_once(closure_once_, [this]() {
+        const auto start = std::chrono::steady_clock::now();
+        closure_ = std::make_unique<TransitiveClosure>(
+            TransitiveClosure::Build(*this, FindStronglyConnectedComponents(), kMaxClosureBytes));
+        const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        if (closure_->Complete()) {
+            LOG_INFO("Transitive closure: " + std::to_string(closure_->ComponentCount()) + " components, " +
+                     std::to_string(closure_->MemoryBytes() / 1024) + " KiB, " +
+                     std::to_string(elapsed_ms) + " ms");
+        } else {
+            LOG_WARN("Transitive closure exceeds " + std::to_string(kMaxClosureBytes >> 20) +
+                     " MiB, falling back to per-query graph traversal");
+        }
+    });
+    return *closure_;
 }
 
-std::string DependencyGraph::CanonicalizeCycle(const std::vector<std::string>& cycle) const {
-    if (cycle.empty()) {
-        return "";
-    }
+const ReachabilityIndex& DependencyGraph::GetReachabilityIndex() const {
+    std::call_once(reachability_once_, [this]() {
+        const auto start = std::chrono::steady_clock::now();
+        reachability_ = std::make_unique<ReachabilityIndex>(
+            ReachabilityIndex::Build(*this, FindStronglyConnectedComponents()));
+        const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        LOG_INFO("Reachability index: " + std::to_string(reachability_->ComponentCount()) + " components, " +
+                 std::to_string(reachability_->MemoryBytes() / 1024) + " KiB, " +
+                 std::to_string(elapsed_ms) + " ms");
+    });
+    return *reachability_;
+}
 
-    std::vector<std::string> normalized = cycle;
-    if (normalized.size() > 1 && normalized.front() == normalized.back()) {
-        normalized.pop_back();
+std::vector<DependencyGraph::NodeId> DependencyGraph::GetTransitiveDependencyIds(NodeId node) const {
+    if (node >= NodeCount()) {
+        return {};
     }
+    const TransitiveClosure& closure = GetTransitiveClosure();
+    return closure.Complete() ? closure.Descendants(node) : CollectTransitiveDependencies(node);
+}
 
-    if (normalized.empty()) {
-        return "";
+bool DependencyGraph::IsTransitiveDependency(NodeId from, NodeId to) const {
+    if (from >= NodeCount() || to >= NodeCount()) {
+        return false;
     }
+    return GetReachabilityIndex().Reaches(from, to);
+}
 
-    auto min_it = std::min_element(normalized.begin(), normalized.end());
-    std::rotate(normalized.begin(), min_it, normalized.end());
+std::vector<DependencyGraph::NodeId> DependencyGraph::CollectTransitiveDependencies(NodeId node) const {
+    const NodeSpan direct_deps = GetDirectDependencyIds(node);
+    std::vector<NodeId> traversal_queue(direct_deps.begin(), direct_deps.end());
+    std::vector<std::uint8_t> visited_ids(NodeCount(), 0);
+    for (const NodeId dep_id : direct_deps) {
+        visited_ids[dep_id] = 1;
+    }
 
-    std::ostringstream os;
-    for (size_t index = 0; index < normalized.size(); ++index) {
-        if (index > 0) {
-            os << "->";
+    size_t cursor = 0;
+    while (cursor < traversal_queue.size()) {
+        const NodeId current = traversal_queue[cursor++];
+        for (const NodeId dep_id : GetDirectDependencyIds(current)) {
+            if (visited_ids[dep_id] == 0) {
+                visited_ids[dep_id] = 1;
+                traversal_queue.push_back(dep_id);
+            }
         }
-        os << normalized[index];
     }
-    return os.str();
+
+    std::sort(traversal_queue.begin(), traversal_queue.end());
+    return traversal_queue;
 }
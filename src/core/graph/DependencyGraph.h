@@ -5,110 +5,207 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
-#include <queue>
 #include <set>
-#include <fstream>
 #include <string_view>
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
 
 #include "analysis/SourceAnalyzer.h"
+#include "concurrency/BoundedConcurrentMap.h"
+#include "graph/ReachabilityIndex.h"
+#include "graph/TargetTable.h"
+#include "graph/TransitiveClosure.h"
 
+// 依赖图：节点为 TargetTable 的 label id，边以压缩稀疏行（CSR）形式存放正向与反向两份，
+// 每个节点的邻居按 id 升序排列。所有内部算法只在 id 上运行，label 字符串只出现在对外接口上。
+// 构建（含 SetSourceAnalyzer）完成后图结构只读，const 接口可被多个线程并发调用：
+// 可达性索引与传递闭包各由 call_once 构建，依赖判定缓存为分段加锁、受内存预算约束的并发表。
 class DependencyGraph {
 public:
-    explicit DependencyGraph(const std::unordered_map<std::string, BazelTarget>& targets);
-    
+    using NodeId = TargetTable::Id;
+    using NodeSpan = TargetTable::IdSpan;
+
+    // 节点 id 即 TargetTable 的 label id，图只引用目标表，不复制 label 字符串
+    explicit DependencyGraph(const TargetTable& table);
+
     // 禁用拷贝和移动
     DependencyGraph(const DependencyGraph&) = delete;
     DependencyGraph& operator=(const DependencyGraph&) = delete;
-    
-    // 图分析功能
+
+    // 基本环枚举的上限：每个强连通分量最多输出的环数（0 表示不限）与整体的墙钟时间
+    struct CycleEnumerationOptions {
+        size_t max_cycles_per_component{1000};
+        std::chrono::milliseconds deadline{std::chrono::seconds(30)};
+    };
+
+    struct CycleEnumerationStats {
+        size_t cycles{0};                 // 已输出的环数
+        size_t cyclic_components{0};      // 含环的分量数（含已枚举到的自环）
+        size_t truncated_components{0};   // 达到每分量上限而提前结束的分量数
+        bool deadline_reached{false};     // 超时后剩余分量不再枚举
+        bool stopped{false};              // 回调要求停止
+    };
+
+    // 强连通分量摘要：分量规模、内外边数，以及一组覆盖分量内全部节点的基本环
+    struct ComponentSummary {
+        std::vector<NodeId> nodes;                  // 按 id 升序
+        size_t internal_edges{0};
+        size_t entry_edges{0};                      // 分量外 -> 分量内
+        size_t exit_edges{0};                       // 分量内 -> 分量外
+        std::vector<std::vector<NodeId>> cycles;    // 从最小 id 开始、不含闭合节点
+        bool truncated{false};                      // 达到环数上限或超时，部分节点未被覆盖
+    };
+
+    // 图分析功能：环形式与 CycleDetector 约定一致，自环为 [x]，两节点环为 [a, b]，
+    // 更长的环从最小 id 开始并回到起点
     std::vector<std::vector<std::string>> FindCycles() const;
+    std::vector<std::vector<std::string>> FindCycles(const CycleEnumerationOptions& options,
+                                                     CycleEnumerationStats* stats = nullptr) const;
 
-    // 获取传递依赖
-    const std::unordered_set<std::string>& GetTransitiveDependencies(const std::string& target) const;
+    // Johnson 算法逐个分量枚举基本环，每个环恰好输出一次（从环上最小 id 开始、不含闭合节点），
+    // 边枚举边交给 on_cycle；on_cycle 返回 false 时停止
+    CycleEnumerationStats EnumerateCycles(
+        const CycleEnumerationOptions& options,
+        const std::function<bool(const std::vector<NodeId>&)>& on_cycle) const;
+
+    // 汇总所有非平凡强连通分量（至少两个节点），按分量规模降序。每个分量只做一次正向和一次反向 BFS，
+    // 经过未覆盖节点的环由两棵 BFS 树上的路径拼出，代价与环长成正比；
+    // 环数受 max_cycles_per_component 限制，整体受 deadline 限制
+    std::vector<ComponentSummary> SummarizeComponents(const CycleEnumerationOptions& options) const;
+
+    // 获取传递依赖（按 label id 排序）
+    std::vector<std::string> GetTransitiveDependencies(const std::string& target) const;
 
     // 查找未使用的依赖
     std::vector<std::string> FindUnusedDependencies(const std::string& target) const;
 
-    // 查找所有未使用依赖
+    // 查找所有未使用依赖：目标按逆拓扑序在共享线程池上并行扫描，结果按 label id 排列，与串行扫描一致
     std::vector<RemovableDependency> FindAllUnusedDependencies() const;
-    
-    // 获取直接依赖
-    const std::vector<std::string>& GetDirectDependencies(const std::string& target) const;
+
+    // 传递约简中的一条冗余边：from 的另一个直接依赖 via 已能到达 to
+    struct RedundantEdge {
+        NodeId from;
+        NodeId to;
+        NodeId via;
+    };
+
+    // 传递约简：删除后可达关系不变的直接依赖边，按 (from, to) 升序。只考虑 include 为真的目标之间的边，
+    // via 也取自这些目标；两端在同一强连通分量内的边不参与（环内的约简不唯一，由循环报告处理）。
+    // 每个目标的直接依赖按拓扑序从近到远检查，只与已保留的依赖比较可达性；目标在共享线程池上并行处理
+    std::vector<RedundantEdge> FindTransitivelyRedundantEdges(const std::function<bool(NodeId)>& include) const;
+
+    // 获取直接依赖（已过滤外部依赖并去重，按 label id 排序）
+    std::vector<std::string> GetDirectDependencies(const std::string& target) const;
 
     // 检查是否存在直接边
     bool HasDirectEdge(const std::string& from, const std::string& to) const;
-    
-    // 未使用依赖检测相关
-    const std::unordered_set<std::string>& GetReverseDependencies(const std::string& target) const;
 
-    // 设置源码分析器
+    // 反向依赖：直接依赖 target 的目标
+    std::vector<std::string> GetReverseDependencies(const std::string& target) const;
+
+    // 设置源码分析器；须在图被共享给其他线程之前调用
     void SetSourceAnalyzer(SourceAnalyzer* source_analyzer) const;
+
+    // 增量更新：本图已由新版本目标表构建，delta 为 TargetTable::Diff(上一版本的表, 本图的表)。
+    // 从 previous 迁移未受影响 target 的依赖判定缓存，返回受影响节点（变更节点及其全部祖先）的标记，
+    // 按本图 id 索引，供 CycleDetector / SourceAnalyzer 迁移各自的缓存。须在图被共享给其他线程之前调用
+    std::vector<bool> ApplyDelta(const DependencyGraph& previous, const TargetTableDelta& delta);
+
+    // 以下为 id 接口，供 CycleDetector 等内部分析直接使用
+    const TargetTable& GetTargetTable() const { return table_; }
+    size_t NodeCount() const { return forward_offsets_.size() - 1; }
+    size_t EdgeCount() const { return forward_edges_.size(); }
+    // 邻居区间按 id 升序
+    NodeSpan GetDirectDependencyIds(NodeId node) const {
+        return MakeSpan(forward_offsets_, forward_edges_, node);
+    }
+    NodeSpan GetReverseDependencyIds(NodeId node) const {
+        return MakeSpan(reverse_offsets_, reverse_edges_, node);
+    }
+    // 在有序邻居上二分查找，O(log d)
+    bool HasDirectEdge(NodeId from, NodeId to) const;
+    // 传递依赖（按 id 升序）
+    std::vector<NodeId> GetTransitiveDependencyIds(NodeId node) const;
+    // 查询可达性索引，绝大多数情况下常数时间
+    bool IsTransitiveDependency(NodeId from, NodeId to) const;
+    // 首次使用时构建的可达性索引，内存与图规模成线性关系
+    const ReachabilityIndex& GetReachabilityIndex() const;
+    // 首次使用时构建的传递闭包，只用于枚举传递依赖
+    const TransitiveClosure& GetTransitiveClosure() const;
+    // 强连通分量（迭代 Tarjan，显式栈，不受依赖链深度限制），覆盖全部节点；
+    // 从带分量的快照还原时直接返回快照中的划分
+    SccPartition FindStronglyConnectedComponents() const;
+
+    // 图结构本身占用的内存（不含按需生成的缓存）
+    size_t MemoryBytes() const;
 private:
+    // 快照写出正向 CSR，并经下面的构造函数还原
+    friend class GraphSnapshot;
+
+    // 由快照还原：正向 CSR 已按 id 升序去重，反向 CSR 在此线性重建
+    DependencyGraph(const TargetTable& table,
+                    std::vector<std::uint32_t> forward_offsets,
+                    std::vector<NodeId> forward_edges,
+                    std::optional<SccPartition> components);
+
+    static NodeSpan MakeSpan(const std::vector<std::uint32_t>& offsets,
+                             const std::vector<NodeId>& edges,
+                             NodeId node) {
+        if (node + 1 >= offsets.size()) {
+            return NodeSpan();
+        }
+        return NodeSpan(edges.data() + offsets[node], offsets[node + 1] - offsets[node]);
+    }
+
     // 源代码分析器，仅用于未使用依赖的代码级判定
     mutable SourceAnalyzer* source_analyzer_;
 
-    // 目标名称到 BazelTarget 的只读映射
-    const std::unordered_map<std::string, BazelTarget>& graph_targets_;
+    // 全工作区目标表（只读）
+    const TargetTable& table_;
 
-    // 字符串级依赖图：保留对外接口和报告生成所需的 target 名称
-    std::unordered_map<std::string, std::vector<std::string>> graph_;
-    // 直接边快速查找：避免高频 direct-edge 判断退化成线性扫描
-    std::unordered_map<std::string, std::unordered_set<std::string>> adjacency_set_;
-    // 节点 ID 索引：为内部 BFS / 后续图算法优化提供整数邻接表
-    std::vector<std::string> node_names_;
-    std::unordered_map<std::string, size_t> node_ids_;
-    std::vector<std::vector<size_t>> adjacency_ids_;
+    // 正向 CSR：节点 i 的依赖为 forward_edges_[forward_offsets_[i], forward_offsets_[i + 1])
+    std::vector<std::uint32_t> forward_offsets_{0};
+    std::vector<NodeId> forward_edges_;
+    // 反向 CSR：节点 i 的依赖者，构建时按来源 id 顺序填充，天然有序
+    std::vector<std::uint32_t> reverse_offsets_{0};
+    std::vector<NodeId> reverse_edges_;
+    // 快照中预先计算的强连通分量
+    std::optional<SccPartition> stored_components_;
 
-    // 反向依赖关系缓存：dependency -> dependers
-    mutable std::unordered_map<std::string, std::unordered_set<std::string>> reverse_deps_cache_;
+    // SCC 缩点后的传递闭包，首次查询时构建；超出内存预算时为不完整状态，查询退回到图遍历
+    mutable std::unique_ptr<TransitiveClosure> closure_;
+    mutable std::once_flag closure_once_;
+    // 缩点 DAG 上的可达性标签，首次判定传递依赖时构建
+    mutable std::unique_ptr<ReachabilityIndex> reachability_;
+    mutable std::once_flag reachability_once_;
+    // (target, dependency) 粒度的“传递依赖是否真正需要”缓存，键为两个 id 拼成的 64 位整数；
+    // 并行扫描未使用依赖时各线程共享，受全局缓存预算约束
+    mutable BoundedConcurrentMap<std::uint64_t, bool> dependency_need_cache_{"graph.dependency_need"};
 
-    // 传递依赖缓存：target -> all reachable dependency names
-    mutable std::unordered_map<std::string, std::unordered_set<std::string>> transitive_deps_cache_;
-    mutable std::unordered_set<std::string> empty_dependency_set_;
-    // target + dependency 粒度的“传递依赖是否真正需要”缓存
-    mutable std::unordered_map<std::string, std::unordered_map<std::string, bool>> dependency_need_cache_;
-    
-    // 构建依赖图
+    // 构建正向与反向 CSR
     void BuildGraph();
+    // 由正向 CSR 填充反向 CSR
+    void BuildReverseEdges();
+
+    // 闭包不可用时的逐次遍历
+    std::vector<NodeId> CollectTransitiveDependencies(NodeId node) const;
+
+    // 单个目标的未使用直接依赖（按 id 升序），可在多个线程上并发调用
+    std::vector<NodeId> FindUnusedDependencyIds(NodeId target) const;
 
-    // 构建反向依赖关系缓存
-    void BuildReverseDependencies();
-
-    // 简化依赖名称
-    std::string SimplifyDependencyName(const std::string& dep) const;
-    size_t GetOrCreateNodeId(const std::string& node_name);
-    size_t GetNodeId(const std::string& node_name) const;
-    const std::unordered_set<std::string>& GetTransitiveDependenciesRef(const std::string& target) const;
-    
-    // 循环检测相关
-    void FindCyclesDFS(
-        const std::string& node,
-        std::unordered_map<std::string, int>& color,
-        std::unordered_map<std::string, std::string>& parent,
-        std::vector<std::vector<std::string>>& cycles,
-        std::set<std::string>& cycle_signatures,
-        const std::unordered_set<std::string>* allowed_nodes = nullptr) const;
-    std::string CanonicalizeCycle(const std::vector<std::string>& cycle) const;
-    std::vector<std::unordered_set<std::string>> FindStronglyConnectedComponents() const;
-    void FindStronglyConnectedComponentsDFS(
-        const std::string& node,
-        int& current_index,
-        std::unordered_map<std::string, int>& index_map,
-        std::unordered_map<std::string, int>& low_link,
-        std::vector<std::string>& stack,
-        std::unordered_set<std::string>& on_stack,
-        std::vector<std::unordered_set<std::string>>& components) const;
     // 检查依赖是否被使用
-    bool IsDependencyUsed(const std::string& dependency, const std::string& exclude_target) const;
+    bool IsDependencyUsed(NodeId dependency, NodeId exclude_target) const;
 
     // 检查传递依赖是否真正需要
-    bool IsDependencyTrulyNeeded(const std::string& target, const std::string& dependency) const;
+    bool IsDependencyTrulyNeeded(NodeId target, NodeId dependency) const;
 
     // 检查依赖是否被传递依赖需要
-    bool IsDependencyNeededByTransitiveDeps(const std::string& target, const std::string& dependency) const;
-
-    // 查找传递冗余依赖
-    std::vector<std::string> FindTransitiveRedundantDependencies(const std::string& target) const;
+    bool IsDependencyNeededByTransitiveDeps(NodeId target, NodeId dependency) const;
 };
 
 #endif
@@ -0,0 +1,349 @@
+#include "FeedbackArcSet.h"
+
+#include "graph/DependencyGraph.h"
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+namespace {
+
+// 一个强连通分量的局部图：节点为分量内下标，边按来源分组（CSR），反向索引指回正向边的下标
+struct ComponentGraph {
+    std::vector<std::uint32_t> out_offsets{0};
+    std::vector<std::uint32_t> out_targets;
+    std::vector<std::uint32_t> out_weights;
+    std::vector<std::uint32_t> in_offsets;
+    std::vector<std::uint32_t> in_edges;     // 正向边下标
+    std::vector<std::uint32_t> in_sources;   // 对应正向边的来源节点
+
+    std::uint32_t NodeCount() const { return static_cast<std::uint32_t>(out_offsets.size() - 1); }
+};
+
+void BuildReverseIndex(ComponentGraph& graph) {
+    const std::uint32_t node_count = graph.NodeCount();
+    graph.in_offsets.assign(node_count + 1, 0);
+    for (const std::uint32_t target : graph.out_targets) {
+        ++graph.in_offsets[target + 1];
+    }
+    for (std::uint32_t node = 0; node < node_count; ++node) {
+        graph.in_offsets[node + 1] += graph.in_offsets[node];
+    }
+    graph.in_edges.resize(graph.out_targets.size());
+    graph.in_sources.resize(graph.out_targets.size());
+    std::vector<std::uint32_t> cursor(graph.in_offsets.begin(), graph.in_offsets.end() - 1);
+    for (std::uint32_t node = 0; node < node_count; ++node) {
+        for (std::uint32_t edge = graph.out_offsets[node]; edge < graph.out_offsets[node + 1]; ++edge) {
+            const std::uint32_t slot = cursor[graph.out_targets[edge]]++;
+            graph.in_edges[slot] = edge;
+            graph.in_sources[slot] = node;
+        }
+    }
+}
+
+// Eades–Lin–Smyth 贪心：返回每个节点在线性序中的位置
+std::vector<double> GreedyOrder(const ComponentGraph& graph) {
+    const std::uint32_t node_count = graph.NodeCount();
+    std::vector<std::uint32_t> in_degree(node_count, 0);
+    std::vector<std::uint32_t> out_degree(node_count, 0);
+    std::vector<std::int64_t> delta(node_count, 0);   // 剩余出权 - 剩余入权
+    for (std::uint32_t node = 0; node < node_count; ++node) {
+        for (std::uint32_t edge = graph.out_offsets[node]; edge < graph.out_offsets[node + 1]; ++edge) {
+            const std::uint32_t target = graph.out_targets[edge];
+            ++out_degree[node];
+            ++in_degree[target];
+            delta[node] += graph.out_weights[edge];
+            delta[target] -= graph.out_weights[edge];
+        }
+    }
+
+    // 堆中条目为 (delta 快照, 节点)，快照与当前值不符的条目视为过期；同分时取较小下标
+    using Entry = std::pair<std::int64_t, std::uint32_t>;
+    const auto lower_priority = [](const Entry& a, const Entry& b) {
+        return a.first != b.first ? a.first < b.first : a.second > b.second;
+    };
+    std::priority_queue<Entry, std::vector<Entry>, decltype(lower_priority)> heap(lower_priority);
+    std::vector<std::uint32_t> sinks;
+    std::vector<std::uint32_t> sources;
+    for (std::uint32_t node = 0; node < node_count; ++node) {
+        heap.emplace(delta[node], node);
+        if (out_degree[node] == 0) {
+            sinks.push_back(node);
+        } else if (in_degree[node] == 0) {
+            sources.push_back(node);
+        }
+    }
+
+    std::vector<std::uint8_t> removed(node_count, 0);
+    std::vector<std::uint32_t> head;   // 从前往后
+    std::vector<std::uint32_t> tail;   // 从后往前
+    head.reserve(node_count);
+
+    const auto remove = [&](std::uint32_t node) {
+        removed[node] = 1;
+        for (std::uint32_t edge = graph.out_offsets[node]; edge < graph.out_offsets[node + 1]; ++edge) {
+            const std::uint32_t target = graph.out_targets[edge];
+            if (removed[target]) {
+                continue;
+            }
+            delta[target] += graph.out_weights[edge];
+            heap.emplace(delta[target], target);
+            if (--in_degree[target] == 0) {
+                sources.push_back(target);
+            }
+        }
+        for (std::uint32_t index = graph.in_offsets[node]; index < graph.in_offsets[node + 1]; ++index) {
+            const std::uint32_t source = graph.in_sources[index];
+            if (removed[source]) {
+                continue;
+            }
+            delta[source] -= graph.out_weights[graph.in_edges[index]];
+            heap.emplace(delta[source], source);
+            if (--out_degree[source] == 0) {
+                sinks.push_back(source);
+            }
+        }
+    };
+
+    std::uint32_t remaining = node_count;
+    while (remaining > 0) {
+        if (!sinks.empty()) {
+            const std::uint32_t node = sinks.back();
+            sinks.pop_back();
+            if (!removed[node]) {
+                remove(node);
+                tail.push_back(node);
+                --remaining;
+            }
+            continue;
+        }
+        if (!sources.empty()) {
+            const std::uint32_t node = sources.back();
+            sources.pop_back();
+            if (!removed[node]) {
+                remove(node);
+                head.push_back(node);
+                --remaining;
+            }
+            continue;
+        }
+        const auto [node_delta, node] = heap.top();
+        heap.pop();
+        if (removed[node] || node_delta != delta[node]) {
+            continue;
+        }
+        remove(node);
+        head.push_back(node);
+        --remaining;
+    }
+
+    head.insert(head.end(), tail.rbegin(), tail.rend());
+    std::vector<double> position(node_count, 0.0);
+    for (std::uint32_t index = 0; index < head.size(); ++index) {
+        position[head[index]] = static_cast<double>(index);
+    }
+    return position;
+}
+
+// DFS 逆后序：只有 DFS 树上的回边是逆向边，适合大部分依赖沿同一方向、只有少数回边的分量。
+// 根按出权减入权从大到小尝试，最像源点的节点先作为根
+std::vector<double> DepthFirstOrder(const ComponentGraph& graph) {
+    const std::uint32_t node_count = graph.NodeCount();
+    std::vector<std::int64_t> delta(node_count, 0);
+    for (std::uint32_t node = 0; node < node_count; ++node) {
+        for (std::uint32_t edge = graph.out_offsets[node]; edge < graph.out_offsets[node + 1]; ++edge) {
+            delta[node] += graph.out_weights[edge];
+            delta[graph.out_targets[edge]] -= graph.out_weights[edge];
+        }
+    }
+    std::vector<std::uint32_t> roots(node_count);
+    for (std::uint32_t node = 0; node < node_count; ++node) {
+        roots[node] = node;
+    }
+    std::stable_sort(roots.begin(), roots.end(),
+                     [&delta](std::uint32_t a, std::uint32_t b) { return delta[a] > delta[b]; });
+
+    std::vector<std::uint8_t> visited(node_count, 0);
+    std::vector<std::uint32_t> finished;
+    finished.reserve(node_count);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> call_stack;
+    for (const std::uint32_t root : roots) {
+        if (visited[root]) {
+            continue;
+        }
+        visited[root] = 1;
+        call_stack.emplace_back(root, graph.out_offsets[root]);
+        while (!call_stack.empty()) {
+            const std::uint32_t node = call_stack.back().first;
+            std::uint32_t& next_edge = call_stack.back().second;
+            if (next_edge < graph.out_offsets[node + 1]) {
+                const std::uint32_t target = graph.out_targets[next_edge++];
+                if (!visited[target]) {
+                    visited[target] = 1;
+                    call_stack.emplace_back(target, graph.out_offsets[target]);
+                }
+                continue;
+            }
+            finished.push_back(node);
+            call_stack.pop_back();
+        }
+    }
+
+    std::vector<double> position(node_count, 0.0);
+    for (std::uint32_t index = 0; index < node_count; ++index) {
+        position[finished[index]] = static_cast<double>(node_count - 1 - index);
+    }
+    return position;
+}
+
+// 局部搜索：把节点移到使其关联的逆向边权重之和最小的位置。只有节点与邻居的相对次序影响这些边，
+// 因此候选位置只需考虑邻居位置之间的空隙，移动后取空隙中点，不改变其他节点的位置。
+// 返回本轮是否有改进
+bool SiftNodes(const ComponentGraph& graph, std::vector<double>& position) {
+    struct Neighbor {
+        double position;
+        std::int64_t out_weight;   // node -> 邻居的边权：node 排在邻居之后时计入代价
+        std::int64_t in_weight;    // 邻居 -> node 的边权：node 排在邻居之前时计入代价
+    };
+
+    bool improved = false;
+    std::vector<Neighbor> neighbors;
+    const std::uint32_t node_count = graph.NodeCount();
+    for (std::uint32_t node = 0; node < node_count; ++node) {
+        neighbors.clear();
+        for (std::uint32_t edge = graph.out_offsets[node]; edge < graph.out_offsets[node + 1]; ++edge) {
+            neighbors.push_back(Neighbor{position[graph.out_targets[edge]], graph.out_weights[edge], 0});
+        }
+        for (std::uint32_t index = graph.in_offsets[node]; index < graph.in_offsets[node + 1]; ++index) {
+            neighbors.push_back(
+                Neighbor{position[graph.in_sources[index]], 0, graph.out_weights[graph.in_edges[index]]});
+        }
+        if (neighbors.empty()) {
+            continue;
+        }
+        std::sort(neighbors.begin(), neighbors.end(),
+                  [](const Neighbor& a, const Neighbor& b) { return a.position < b.position; });
+
+        // 当前代价
+        std::int64_t current = 0;
+        for (const auto& neighbor : neighbors) {
+            if (neighbor.position < position[node]) {
+                current += neighbor.out_weight;
+            } else if (neighbor.position > position[node]) {
+                current += neighbor.in_weight;
+            }
+        }
+
+        // 从最左侧开始扫描：位于全部邻居之前时，所有入边都是逆向边
+        std::int64_t cost = 0;
+        for (const auto& neighbor : neighbors) {
+            cost += neighbor.in_weight;
+        }
+        std::int64_t best = cost;
+        size_t best_gap = 0;   // 第 best_gap 个不同位置之前的空隙
+        for (size_t index = 0; index < neighbors.size();) {
+            const double key = neighbors[index].position;
+            for (; index < neighbors.size() && neighbors[index].position == key; ++index) {
+                cost += neighbors[index].out_weight - neighbors[index].in_weight;
+            }
+            if (cost < best) {
+                best = cost;
+                best_gap = index;
+            }
+        }
+        if (best >= current) {
+            continue;
+        }
+
+        double target;
+        if (best_gap == 0) {
+            target = neighbors.front().position - 1.0;
+        } else if (best_gap == neighbors.size()) {
+            target = neighbors.back().position + 1.0;
+        } else {
+            const double left = neighbors[best_gap - 1].position;
+            const double right = neighbors[best_gap].position;
+            target = left + (right - left) / 2;
+            if (target <= left || target >= right) {
+                continue;   // 浮点精度耗尽，放弃这次移动
+            }
+        }
+        position[node] = target;
+        improved = true;
+    }
+    return improved;
+}
+
+std::int64_t BackwardCost(const ComponentGraph& graph, const std::vector<double>& position) {
+    std::int64_t cost = 0;
+    for (std::uint32_t node = 0; node < graph.NodeCount(); ++node) {
+        for (std::uint32_t edge = graph.out_offsets[node]; edge < graph.out_offsets[node + 1]; ++edge) {
+            if (position[graph.out_targets[edge]] < position[node]) {
+                cost += graph.out_weights[edge];
+            }
+        }
+    }
+    return cost;
+}
+
+}  // namespace
+
+std::vector<FeedbackArc> FeedbackArcSet::Compute(const DependencyGraph& graph,
+                                                 const SccPartition& components,
+                                                 const EdgeWeight& weight) {
+    std::vector<FeedbackArc> arcs;
+    std::vector<std::uint32_t> local_index(graph.NodeCount(), 0);
+
+    for (std::uint32_t component = 0; component < components.Count(); ++component) {
+        const TargetTable::IdSpan nodes = components.Component(component);
+        if (nodes.size() == 1) {
+            if (graph.HasDirectEdge(nodes[0], nodes[0])) {
+                arcs.push_back(FeedbackArc{nodes[0], nodes[0], weight(nodes[0], nodes[0]), component});
+            }
+            continue;
+        }
+
+        for (std::uint32_t local = 0; local < nodes.size(); ++local) {
+            local_index[nodes[local]] = local;
+        }
+        ComponentGraph local_graph;
+        for (const NodeId node : nodes) {
+            for (const NodeId dep : graph.GetDirectDependencyIds(node)) {
+                if (dep == node) {
+                    arcs.push_back(FeedbackArc{node, node, weight(node, node), component});
+                } else if (components.component_of[dep] == component) {
+                    local_graph.out_targets.push_back(local_index[dep]);
+                    local_graph.out_weights.push_back(weight(node, dep));
+                }
+            }
+            local_graph.out_offsets.push_back(static_cast<std::uint32_t>(local_graph.out_targets.size()));
+        }
+        BuildReverseIndex(local_graph);
+
+        std::vector<double> position;
+        std::int64_t best_cost = -1;
+        for (std::vector<double> candidate : {GreedyOrder(local_graph), DepthFirstOrder(local_graph)}) {
+            for (int pass = 0; pass < kLocalSearchPasses; ++pass) {
+                if (!SiftNodes(local_graph, candidate)) {
+                    break;
+                }
+            }
+            const std::int64_t cost = BackwardCost(local_graph, candidate);
+            if (best_cost < 0 || cost < best_cost) {
+                best_cost = cost;
+                position = std::move(candidate);
+            }
+        }
+
+        for (std::uint32_t local = 0; local < nodes.size(); ++local) {
+            for (std::uint32_t edge = local_graph.out_offsets[local]; edge < local_graph.out_offsets[local + 1];
+                 ++edge) {
+                const std::uint32_t target = local_graph.out_targets[edge];
+                if (position[target] < position[local]) {
+                    arcs.push_back(FeedbackArc{nodes[local], nodes[target], local_graph.out_weights[edge], component});
+                }
+            }
+        }
+    }
+    return arcs;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "graph/TargetTable.h"
+#include "graph/TransitiveClosure.h"
+
+class DependencyGraph;
+
+// 反馈弧集中的一条边：删除集合中的全部边后依赖图无环
+struct FeedbackArc {
+    TargetTable::Id from;
+    TargetTable::Id to;
+    std::uint32_t weight;
+    std::uint32_t component;   // 所在强连通分量（SccPartition 编号）
+};
+
+// 加权最小反馈弧集的近似解。每个强连通分量独立求解：
+// 先用 Eades–Lin–Smyth 贪心得到线性序（反复摘除汇点与源点，否则摘除出权减入权最大的节点），
+// 另以 DFS 逆后序作为第二个初始序（适合只有少数回边的分量），两者各自做局部搜索——
+// 逐个节点把它移到使自身关联逆向边权重最小的位置——取代价较低者，最终序中的逆向边即为反馈弧集。
+// 贪心阶段用带惰性删除的堆，局部搜索每轮对每个节点的邻居排序一次，总体 O(E log V)。
+class FeedbackArcSet {
+public:
+    using NodeId = TargetTable::Id;
+    using EdgeWeight = std::function<std::uint32_t(NodeId from, NodeId to)>;
+
+    // 局部搜索的最大轮数；某一轮没有任何改进时提前结束
+    static constexpr int kLocalSearchPasses = 4;
+
+    // 返回的边按分量、来源 id 排列；自环总在集合中
+    static std::vector<FeedbackArc> Compute(const DependencyGraph& graph,
+                                            const SccPartition& components,
+                                            const EdgeWeight& weight);
+};
@@ -0,0 +1,486 @@
+#include "GraphSnapshot.h"
+
+#include "graph/DependencyGraph.h"
+#include "log/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <optional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kGraphMagic[8] = {'B', 'D', 'C', 'G', 'R', 'A', 'P', 'H'};
+// 同时作为字节序标记：在不同字节序机器上读出的值不同，快照自然失效
+constexpr std::uint32_t kEndianMarker = 0x01020304u;
+constexpr size_t kHeaderBytes = 64;
+constexpr size_t kSectionAlignment = 8;
+constexpr std::uint32_t kHasComponents = 1u << 0;
+
+// 文件头各字段的偏移
+constexpr size_t kVersionOffset = 12;
+constexpr size_t kFingerprintOffset = 16;
+constexpr size_t kChecksumOffset = 24;
+constexpr size_t kTargetCountOffset = 32;
+constexpr size_t kLabelCountOffset = 36;
+constexpr size_t kStringCountOffset = 40;
+constexpr size_t kFlagsOffset = 44;
+constexpr size_t kEdgeCountOffset = 48;
+constexpr size_t kSectionCountOffset = 56;
+
+enum Section : size_t {
+    kKey,
+    kLabelBytes,
+    kLabelOffsets,
+    kLabelHashes,
+    kLabelSlots,
+    kStringBytes,
+    kStringOffsets,
+    kStringHashes,
+    kStringSlots,
+    kNameIds,
+    kPathIds,
+    kRuleTypeIds,
+    kDepOffsets,
+    kDepIds,
+    kSrcOffsets,
+    kSrcIds,
+    kHdrOffsets,
+    kHdrIds,
+    kEdgeOffsets,
+    kEdges,
+    kComponents,
+    kSectionCount,
+};
+
+constexpr size_t kSectionEntryBytes = 16;   // (偏移, 长度)，各 8 字节
+
+template <typename T>
+void StoreAt(std::string& buffer, size_t offset, T value) {
+    std::memcpy(buffer.data() + offset, &value, sizeof(value));
+}
+
+template <typename T>
+T LoadAt(const unsigned char* data, size_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(value));
+    return value;
+}
+
+// 按 8 字节一组混合的校验和，只用于发现损坏与截断
+std::uint64_t Checksum(const unsigned char* data, size_t size) {
+    std::uint64_t hash = 1469598103934665603ULL ^ size;
+    size_t position = 0;
+    for (; position + 8 <= size; position += 8) {
+        hash = (hash ^ LoadAt<std::uint64_t>(data, position)) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 32;
+    }
+    for (; position < size; ++position) {
+        hash = (hash ^ data[position]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+class GraphWriter {
+public:
+    GraphWriter() : buffer_(kHeaderBytes + kSectionCount * kSectionEntryBytes, '\0') {}
+
+    void BeginSection(size_t section) {
+        buffer_.resize((buffer_.size() + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment, '\0');
+        current_ = section;
+        section_begin_ = buffer_.size();
+    }
+
+    void EndSection() {
+        const size_t entry = kHeaderBytes + current_ * kSectionEntryBytes;
+        StoreAt<std::uint64_t>(buffer_, entry, section_begin_);
+        StoreAt<std::uint64_t>(buffer_, entry + 8, buffer_.size() - section_begin_);
+    }
+
+    void WriteBytes(const void* data, size_t size) {
+        buffer_.append(static_cast<const char*>(data), size);
+    }
+
+    void WriteVarint(std::uint32_t value) {
+        while (value >= 0x80) {
+            buffer_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        buffer_.push_back(static_cast<char>(value));
+    }
+
+    template <typename T>
+    void WriteSection(size_t section, const std::vector<T>& values) {
+        BeginSection(section);
+        WriteBytes(values.data(), values.size() * sizeof(T));
+        EndSection();
+    }
+
+    void WriteSection(size_t section, std::string_view bytes) {
+        BeginSection(section);
+        WriteBytes(bytes.data(), bytes.size());
+        EndSection();
+    }
+
+    std::string& Buffer() { return buffer_; }
+
+private:
+    std::string buffer_;
+    size_t current_{0};
+    size_t section_begin_{0};
+};
+
+template <typename T>
+bool CopySection(std::string_view bytes, size_t expected_count, std::vector<T>& values) {
+    if (bytes.size() != expected_count * sizeof(T)) {
+        return false;
+    }
+    values.resize(expected_count);
+    if (expected_count != 0) {
+        std::memcpy(values.data(), bytes.data(), bytes.size());
+    }
+    return true;
+}
+
+// 偏移数组从 0 开始、单调不减，并以 total 结束
+template <typename T>
+bool ValidOffsets(const std::vector<T>& offsets, size_t total) {
+    if (offsets.empty() || offsets.front() != 0 || offsets.back() != total) {
+        return false;
+    }
+    return std::is_sorted(offsets.begin(), offsets.end());
+}
+
+bool ValidIds(const std::vector<std::uint32_t>& ids, size_t limit) {
+    return std::all_of(ids.begin(), ids.end(), [limit](std::uint32_t id) { return id < limit; });
+}
+
+}  // namespace
+
+bool GraphSnapshot::Save(const fs::path& path,
+                         const std::string& key,
+                         std::uint64_t source_fingerprint,
+                         const TargetTable& table,
+                         const DependencyGraph& graph,
+                         bool include_components) {
+    GraphWriter writer;
+    writer.WriteSection(kKey, std::string_view(key));
+    // 驻留池的字节、偏移、哈希与槽位原样写出；偏移统一存 64 位
+    const auto write_interner = [&writer](const StringInterner& interner, size_t first_section) {
+        writer.WriteSection(first_section, std::string_view(interner.buffer_));
+        writer.WriteSection(first_section + 1,
+                            std::vector<std::uint64_t>(interner.offsets_.begin(), interner.offsets_.end()));
+        writer.WriteSection(first_section + 2, interner.hashes_);
+        writer.WriteSection(first_section + 3, interner.slots_);
+    };
+    write_interner(table.labels_, kLabelBytes);
+    write_interner(table.strings_, kStringBytes);
+    writer.WriteSection(kNameIds, table.name_ids_);
+    writer.WriteSection(kPathIds, table.path_ids_);
+    writer.WriteSection(kRuleTypeIds, table.rule_type_ids_);
+    writer.WriteSection(kDepOffsets, table.dep_offsets_);
+    writer.WriteSection(kDepIds, table.dep_ids_);
+    writer.WriteSection(kSrcOffsets, table.src_offsets_);
+    writer.WriteSection(kSrcIds, table.src_ids_);
+    writer.WriteSection(kHdrOffsets, table.hdr_offsets_);
+    writer.WriteSection(kHdrIds, table.hdr_ids_);
+    writer.WriteSection(kEdgeOffsets, graph.forward_offsets_);
+
+    writer.BeginSection(kEdges);
+    for (size_t node = 0; node < graph.NodeCount(); ++node) {
+        DependencyGraph::NodeId previous = 0;
+        bool first = true;
+        for (const DependencyGraph::NodeId dep : graph.GetDirectDependencyIds(static_cast<DependencyGraph::NodeId>(node))) {
+            writer.WriteVarint(first ? dep : dep - previous);
+            previous = dep;
+            first = false;
+        }
+    }
+    writer.EndSection();
+
+    std::uint32_t flags = 0;
+    if (include_components) {
+        writer.WriteSection(kComponents, graph.FindStronglyConnectedComponents().component_of);
+        flags |= kHasComponents;
+    } else {
+        writer.WriteSection(kComponents, std::string_view());
+    }
+
+    std::string& buffer = writer.Buffer();
+    std::memcpy(buffer.data(), kGraphMagic, sizeof(kGraphMagic));
+    StoreAt<std::uint32_t>(buffer, sizeof(kGraphMagic), kEndianMarker);
+    StoreAt<std::uint32_t>(buffer, kVersionOffset, kFormatVersion);
+    StoreAt<std::uint64_t>(buffer, kFingerprintOffset, source_fingerprint);
+    StoreAt<std::uint32_t>(buffer, kTargetCountOffset, static_cast<std::uint32_t>(table.TargetCount()));
+    StoreAt<std::uint32_t>(buffer, kLabelCountOffset, static_cast<std::uint32_t>(table.LabelCount()));
+    StoreAt<std::uint32_t>(buffer, kStringCountOffset, static_cast<std::uint32_t>(table.strings_.Size()));
+    StoreAt<std::uint32_t>(buffer, kFlagsOffset, flags);
+    StoreAt<std::uint64_t>(buffer, kEdgeCountOffset, graph.EdgeCount());
+    StoreAt<std::uint32_t>(buffer, kSectionCountOffset, static_cast<std::uint32_t>(kSectionCount));
+    StoreAt<std::uint64_t>(buffer, kChecksumOffset,
+                           Checksum(reinterpret_cast<const unsigned char*>(buffer.data()) + kHeaderBytes,
+                                    buffer.size() - kHeaderBytes));
+
+    std::error_code ec;
+    if (path.has_parent_path()) {
+        fs::create_directories(path.parent_path(), ec);
+        if (ec) {
+            LOG_WARN("Failed to create graph snapshot directory: " + path.parent_path().string());
+            return false;
+        }
+    }
+
+    // 同一进程内可能有多个上下文同时写同一快照（例如指纹已过期的旧构建），临时文件名再加序号
+    static std::atomic<std::uint64_t> save_sequence{0};
+    fs::path temp_path = path;
+    temp_path += ".tmp." + std::to_string(::getpid()) + "." +
+                 std::to_string(save_sequence.fetch_add(1, std::memory_order_relaxed));
+    {
+        std::ofstream output(temp_path, std::ios::binary | std::ios::trunc);
+        if (!output) {
+            LOG_WARN("Failed to write graph snapshot: " + temp_path.string());
+            return false;
+        }
+        output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!output) {
+            output.close();
+            fs::remove(temp_path, ec);
+            LOG_WARN("Failed to write graph snapshot: " + temp_path.string());
+            return false;
+        }
+    }
+
+    fs::rename(temp_path, path, ec);
+    if (ec) {
+        fs::remove(temp_path, ec);
+        LOG_WARN("Failed to publish graph snapshot: " + path.string());
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<GraphSnapshot> GraphSnapshot::Open(const fs::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(kHeaderBytes)) {
+        ::close(fd);
+        return nullptr;
+    }
+    const auto size = static_cast<size_t>(file_stat.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        LOG_WARN("Failed to map graph snapshot: " + path.string());
+        return nullptr;
+    }
+
+    std::unique_ptr<GraphSnapshot> snapshot(new GraphSnapshot());
+    snapshot->data_ = static_cast<const unsigned char*>(mapping);
+    snapshot->size_ = size;
+    snapshot->path_ = path.string();
+    const unsigned char* data = snapshot->data_;
+
+    if (std::memcmp(data, kGraphMagic, sizeof(kGraphMagic)) != 0 ||
+        LoadAt<std::uint32_t>(data, sizeof(kGraphMagic)) != kEndianMarker ||
+        LoadAt<std::uint32_t>(data, kVersionOffset) != kFormatVersion) {
+        return nullptr;
+    }
+    if (LoadAt<std::uint32_t>(data, kSectionCountOffset) != kSectionCount ||
+        size < kHeaderBytes + kSectionCount * kSectionEntryBytes ||
+        LoadAt<std::uint64_t>(data, kChecksumOffset) != Checksum(data + kHeaderBytes, size - kHeaderBytes)) {
+        LOG_WARN("Corrupted graph snapshot: " + snapshot->path_);
+        return nullptr;
+    }
+    for (size_t section = 0; section < kSectionCount; ++section) {
+        const size_t entry = kHeaderBytes + section * kSectionEntryBytes;
+        const auto offset = LoadAt<std::uint64_t>(data, entry);
+        const auto length = LoadAt<std::uint64_t>(data, entry + 8);
+        if (offset % kSectionAlignment != 0 || offset > size || length > size - offset) {
+            LOG_WARN("Corrupted graph snapshot: " + snapshot->path_);
+            return nullptr;
+        }
+    }
+
+    snapshot->source_fingerprint_ = LoadAt<std::uint64_t>(data, kFingerprintOffset);
+    snapshot->target_count_ = LoadAt<std::uint32_t>(data, kTargetCountOffset);
+    snapshot->label_count_ = LoadAt<std::uint32_t>(data, kLabelCountOffset);
+    snapshot->string_count_ = LoadAt<std::uint32_t>(data, kStringCountOffset);
+    snapshot->edge_count_ = LoadAt<std::uint64_t>(data, kEdgeCountOffset);
+    snapshot->key_ = std::string(snapshot->Section(kKey));
+    return snapshot;
+}
+
+GraphSnapshot::~GraphSnapshot() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+    }
+}
+
+bool GraphSnapshot::HasComponents() const {
+    return (LoadAt<std::uint32_t>(data_, kFlagsOffset) & kHasComponents) != 0;
+}
+
+std::string_view GraphSnapshot::Section(size_t section) const {
+    const size_t entry = kHeaderBytes + section * kSectionEntryBytes;
+    return std::string_view(reinterpret_cast<const char*>(data_) + LoadAt<std::uint64_t>(data_, entry),
+                            LoadAt<std::uint64_t>(data_, entry + 8));
+}
+
+bool GraphSnapshot::RestoreTargetTable(TargetTable& table) const {
+    TargetTable restored;
+    // 驻留池：槽位数是 2 的幂且留有空槽，查找才能终止
+    const auto restore_interner = [&](StringInterner& interner, size_t first_section, size_t count) {
+        const std::string_view bytes = Section(first_section);
+        std::vector<std::uint64_t> offsets;
+        if (!CopySection(Section(first_section + 1), count + 1, offsets) || !ValidOffsets(offsets, bytes.size()) ||
+            !CopySection(Section(first_section + 2), count, interner.hashes_)) {
+            return false;
+        }
+        const std::string_view slot_bytes = Section(first_section + 3);
+        const size_t slot_count = slot_bytes.size() / sizeof(StringInterner::Id);
+        if (slot_count <= count || (slot_count & (slot_count - 1)) != 0 ||
+            !CopySection(slot_bytes, slot_count, interner.slots_)) {
+            return false;
+        }
+        if (!std::all_of(interner.slots_.begin(), interner.slots_.end(), [count](StringInterner::Id id) {
+                return id == StringInterner::kInvalidId || id < count;
+            })) {
+            return false;
+        }
+        interner.buffer_.assign(bytes.data(), bytes.size());
+        interner.offsets_.assign(offsets.begin(), offsets.end());
+        return true;
+    };
+    if (!restore_interner(restored.labels_, kLabelBytes, label_count_) ||
+        !restore_interner(restored.strings_, kStringBytes, string_count_) ||
+        target_count_ > label_count_) {
+        LOG_WARN("Corrupted graph snapshot: " + path_);
+        return false;
+    }
+    restored.target_count_ = target_count_;
+
+    const auto restore_column = [&](size_t section, std::vector<std::uint32_t>& ids, size_t limit) {
+        return CopySection(Section(section), target_count_, ids) && ValidIds(ids, limit);
+    };
+    const auto restore_lists = [&](size_t offsets_section, size_t ids_section, std::vector<std::uint32_t>& offsets,
+                                   std::vector<std::uint32_t>& ids, size_t limit) {
+        const std::string_view id_bytes = Section(ids_section);
+        return CopySection(Section(offsets_section), static_cast<size_t>(target_count_) + 1, offsets) &&
+               CopySection(id_bytes, id_bytes.size() / sizeof(std::uint32_t), ids) &&
+               id_bytes.size() % sizeof(std::uint32_t) == 0 && ValidOffsets(offsets, ids.size()) &&
+               ValidIds(ids, limit);
+    };
+    if (!restore_column(kNameIds, restored.name_ids_, string_count_) ||
+        !restore_column(kPathIds, restored.path_ids_, string_count_) ||
+        !restore_column(kRuleTypeIds, restored.rule_type_ids_, string_count_) ||
+        !restore_lists(kDepOffsets, kDepIds, restored.dep_offsets_, restored.dep_ids_, label_count_) ||
+        !restore_lists(kSrcOffsets, kSrcIds, restored.src_offsets_, restored.src_ids_, string_count_) ||
+        !restore_lists(kHdrOffsets, kHdrIds, restored.hdr_offsets_, restored.hdr_ids_, string_count_)) {
+        LOG_WARN("Corrupted graph snapshot: " + path_);
+        return false;
+    }
+
+    table = std::move(restored);
+    return true;
+}
+
+std::unique_ptr<DependencyGraph> GraphSnapshot::RestoreGraph(const TargetTable& table) const {
+    const size_t node_count = table.LabelCount();
+    std::vector<std::uint32_t> offsets;
+    if (node_count != label_count_ || edge_count_ >= TargetTable::kInvalidId ||
+        !CopySection(Section(kEdgeOffsets), node_count + 1, offsets) || !ValidOffsets(offsets, edge_count_)) {
+        LOG_WARN("Corrupted graph snapshot: " + path_);
+        return nullptr;
+    }
+
+    // 逐节点解码 varint：首个邻居为 id，之后为严格递增的差值
+    std::vector<DependencyGraph::NodeId> edges(edge_count_);
+    const std::string_view encoded = Section(kEdges);
+    size_t position = 0;
+    const auto read_varint = [&](std::uint32_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 35 && position < encoded.size(); shift += 7) {
+            const auto byte = static_cast<unsigned char>(encoded[position++]);
+            value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+    for (size_t node = 0; node < node_count; ++node) {
+        std::uint64_t previous = 0;
+        for (std::uint32_t edge = offsets[node]; edge < offsets[node + 1]; ++edge) {
+            std::uint32_t value = 0;
+            if (!read_varint(value) || (edge != offsets[node] && value == 0)) {
+                LOG_WARN("Corrupted graph snapshot: " + path_);
+                return nullptr;
+            }
+            const std::uint64_t dep = (edge == offsets[node] ? 0 : previous) + value;
+            if (dep >= node_count) {
+                LOG_WARN("Corrupted graph snapshot: " + path_);
+                return nullptr;
+            }
+            edges[edge] = static_cast<DependencyGraph::NodeId>(dep);
+            previous = dep;
+        }
+    }
+    if (position != encoded.size()) {
+        LOG_WARN("Corrupted graph snapshot: " + path_);
+        return nullptr;
+    }
+
+    // 分量编号须连续、覆盖全部节点，且每条边的终点分量编号不大于起点（逆拓扑序）
+    std::optional<SccPartition> components;
+    if (HasComponents()) {
+        SccPartition partition;
+        if (!CopySection(Section(kComponents), node_count, partition.component_of) ||
+            !ValidIds(partition.component_of, node_count)) {
+            LOG_WARN("Corrupted graph snapshot: " + path_);
+            return nullptr;
+        }
+        const std::uint32_t component_count =
+            node_count == 0 ? 0 : *std::max_element(partition.component_of.begin(), partition.component_of.end()) + 1;
+        partition.offsets.assign(static_cast<size_t>(component_count) + 1, 0);
+        for (const std::uint32_t component : partition.component_of) {
+            ++partition.offsets[component + 1];
+        }
+        bool valid = true;
+        for (std::uint32_t component = 0; component < component_count; ++component) {
+            valid = valid && partition.offsets[component + 1] != 0;
+            partition.offsets[component + 1] += partition.offsets[component];
+        }
+        for (size_t node = 0; valid && node < node_count; ++node) {
+            for (std::uint32_t edge = offsets[node]; edge < offsets[node + 1]; ++edge) {
+                valid = valid && partition.component_of[edges[edge]] <= partition.component_of[node];
+            }
+        }
+        if (!valid) {
+            LOG_WARN("Corrupted graph snapshot: " + path_);
+            return nullptr;
+        }
+        // 按 id 递增回填，分量内节点自然有序，与 Tarjan 的结果一致
+        partition.nodes.resize(node_count);
+        std::vector<std::uint32_t> fill_positions(partition.offsets.begin(), partition.offsets.end() - 1);
+        for (size_t node = 0; node < node_count; ++node) {
+            partition.nodes[fill_positions[partition.component_of[node]]++] = static_cast<DependencyGraph::NodeId>(node);
+        }
+        components = std::move(partition);
+    }
+
+    return std::unique_ptr<DependencyGraph>(
+        new DependencyGraph(table, std::move(offsets), std::move(edges), std::move(components)));
+}
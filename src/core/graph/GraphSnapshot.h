@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "graph/TargetTable.h"
+
+class DependencyGraph;
+
+// 依赖图的二进制快照：目标表与依赖图一起写入一个带版本号的文件，读取时整体 mmap，
+// 各列按块复制回内存，不重新解析 label、也不重新计算字符串哈希。
+//
+// 文件布局（小端，各段按 8 字节对齐）：
+// - 64 字节文件头：魔数、字节序标记、格式版本、来源指纹、校验和、各类计数；
+// - 段目录：每段的 (偏移, 长度)；
+// - 字符串表：label 与其他字符串两个驻留池各自的字节、偏移、哈希与开放寻址槽位，原样保存；
+// - 目标列：名称 / 路径 / 规则类型 id，deps / srcs / hdrs 的偏移与 id；
+// - 依赖图：正向 CSR 偏移，边按节点依次存放，每个节点的邻居升序，首个存 id，其余存与前一个的差，均为 varint；
+//   反向 CSR 加载时线性重建；
+// - 可选：每个节点的强连通分量编号，加载后 FindStronglyConnectedComponents 不再重算。
+//
+// 来源指纹与 key 由调用方定义（例如 BUILD 文件清单的指纹与解析策略），快照本身只负责原样保存与校验。
+// 校验和覆盖文件头之后的全部内容，加载时还会检查所有偏移与 id 的范围，损坏或截断的文件只会被拒绝。
+class GraphSnapshot {
+public:
+    // 格式变化时递增，旧版本快照会被直接忽略
+    static constexpr std::uint32_t kFormatVersion = 1;
+
+    // 写入快照（先写临时文件再 rename，避免并发进程读到半截文件）
+    static bool Save(const std::filesystem::path& path,
+                     const std::string& key,
+                     std::uint64_t source_fingerprint,
+                     const TargetTable& table,
+                     const DependencyGraph& graph,
+                     bool include_components = true);
+
+    // mmap 打开并校验文件头、段目录与校验和；文件不存在、版本不同或已损坏时返回 nullptr
+    static std::unique_ptr<GraphSnapshot> Open(const std::filesystem::path& path);
+
+    GraphSnapshot(const GraphSnapshot&) = delete;
+    GraphSnapshot& operator=(const GraphSnapshot&) = delete;
+    ~GraphSnapshot();
+
+    const std::string& Key() const { return key_; }
+    std::uint64_t SourceFingerprint() const { return source_fingerprint_; }
+    size_t TargetCount() const { return target_count_; }
+    size_t LabelCount() const { return label_count_; }
+    size_t EdgeCount() const { return edge_count_; }
+    bool HasComponents() const;
+    size_t FileBytes() const { return size_; }
+
+    // 还原目标表；内容不合法时返回 false
+    bool RestoreTargetTable(TargetTable& table) const;
+
+    // 在 RestoreTargetTable 得到的表上还原依赖图，表之后不能再移动；内容不合法时返回 nullptr
+    std::unique_ptr<DependencyGraph> RestoreGraph(const TargetTable& table) const;
+
+private:
+    GraphSnapshot() = default;
+
+    std::string_view Section(size_t section) const;
+
+    const unsigned char* data_{nullptr};
+    size_t size_{0};
+    std::string path_;
+    std::string key_;
+    std::uint64_t source_fingerprint_{0};
+    std::uint32_t target_count_{0};
+    std::uint32_t label_count_{0};
+    std::uint32_t string_count_{0};
+    std::uint64_t edge_count_{0};
+};
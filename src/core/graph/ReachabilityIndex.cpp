@@ -0,0 +1,249 @@
+#include "ReachabilityIndex.h"
+
+#include "graph/DependencyGraph.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace {
+
+constexpr std::uint32_t kNoComponent = std::numeric_limits<std::uint32_t>::max();
+
+// 每次遍历的子节点起始位置：按 (分量, 遍历序号) 散列旋转后继列表，不需要为每次遍历复制打乱后的边
+std::uint32_t RotationOffset(std::uint32_t component, size_t traversal, std::uint32_t degree) {
+    std::uint64_t hash = (static_cast<std::uint64_t>(component) << 8 | traversal) * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 29;
+    return static_cast<std::uint32_t>(hash % degree);
+}
+
+// 剪枝 DFS 的每线程暂存：访问标记用递增的 epoch 区分不同查询，不需要每次清零
+struct SearchScratch {
+    std::vector<std::uint32_t> stamps;
+    std::vector<std::uint32_t> stack;
+    std::uint32_t epoch{0};
+};
+
+}  // namespace
+
+ReachabilityIndex ReachabilityIndex::Build(const DependencyGraph& graph, SccPartition components) {
+    ReachabilityIndex index;
+    index.components_ = std::move(components);
+    const auto& component_of = index.components_.component_of;
+    const auto component_count = static_cast<std::uint32_t>(index.components_.Count());
+
+    // 缩点 DAG：分量按逆拓扑序编号，后继编号都更小
+    index.cyclic_.assign(component_count, 0);
+    index.dag_offsets_.reserve(component_count + 1);
+    std::vector<std::uint32_t> last_seen(component_count, kNoComponent);
+    std::vector<std::uint32_t> in_degree(component_count, 0);
+    for (std::uint32_t component = 0; component < component_count; ++component) {
+        const TargetTable::IdSpan nodes = index.components_.Component(component);
+        index.cyclic_[component] = nodes.size() > 1 ? 1 : 0;
+        for (const NodeId node : nodes) {
+            for (const NodeId dep : graph.GetDirectDependencyIds(node)) {
+                const std::uint32_t successor = component_of[dep];
+                if (successor == component) {
+                    index.cyclic_[component] = 1;
+                } else if (last_seen[successor] != component) {
+                    last_seen[successor] = component;
+                    index.dag_edges_.push_back(successor);
+                    ++in_degree[successor];
+                }
+            }
+        }
+        index.dag_offsets_.push_back(static_cast<std::uint32_t>(index.dag_edges_.size()));
+    }
+    index.dag_edges_.shrink_to_fit();
+
+    const auto successors = [&index](std::uint32_t component) {
+        return std::make_pair(index.dag_edges_.data() + index.dag_offsets_[component],
+                              index.dag_offsets_[component + 1] - index.dag_offsets_[component]);
+    };
+
+    index.level_.assign(component_count, 0);
+    for (std::uint32_t component = 0; component < component_count; ++component) {
+        const auto [edges, degree] = successors(component);
+        for (std::uint32_t position = 0; position < degree; ++position) {
+            index.level_[component] = std::max(index.level_[component], index.level_[edges[position]] + 1);
+        }
+    }
+
+    // 枢纽取 (入度 + 1) * (出度 + 1) 最大的分量，经过它们的路径最多；掩码沿逆拓扑序与拓扑序各传播一遍
+    std::vector<std::uint32_t> order(component_count);
+    for (std::uint32_t component = 0; component < component_count; ++component) {
+        order[component] = component;
+    }
+    const auto hub_score = [&](std::uint32_t component) {
+        return static_cast<std::uint64_t>(in_degree[component] + 1) *
+               (index.dag_offsets_[component + 1] - index.dag_offsets_[component] + 1);
+    };
+    const size_t landmark_count = std::min<size_t>(kLandmarks, component_count);
+    std::partial_sort(order.begin(), order.begin() + landmark_count, order.end(),
+                      [&](std::uint32_t lhs, std::uint32_t rhs) {
+                          const std::uint64_t lhs_score = hub_score(lhs);
+                          const std::uint64_t rhs_score = hub_score(rhs);
+                          return lhs_score != rhs_score ? lhs_score > rhs_score : lhs < rhs;
+                      });
+    index.landmark_out_.assign(component_count, 0);
+    index.landmark_in_.assign(component_count, 0);
+    for (size_t landmark = 0; landmark < landmark_count; ++landmark) {
+        index.landmark_out_[order[landmark]] = index.landmark_in_[order[landmark]] = 1ULL << landmark;
+    }
+    for (std::uint32_t component = 0; component < component_count; ++component) {
+        const auto [edges, degree] = successors(component);
+        for (std::uint32_t position = 0; position < degree; ++position) {
+            index.landmark_out_[component] |= index.landmark_out_[edges[position]];
+        }
+    }
+    for (std::uint32_t component = component_count; component-- > 0;) {
+        const auto [edges, degree] = successors(component);
+        for (std::uint32_t position = 0; position < degree; ++position) {
+            index.landmark_in_[edges[position]] |= index.landmark_in_[component];
+        }
+    }
+
+    // 没有前驱的分量作为 DFS 根；第一次按编号降序，之后每次按散列重新排列
+    std::vector<std::uint32_t> roots;
+    for (std::uint32_t component = component_count; component-- > 0;) {
+        if (in_degree[component] == 0) {
+            roots.push_back(component);
+        }
+    }
+
+    index.intervals_.resize(component_count);
+    std::vector<std::uint8_t> visited(component_count);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> stack;   // (分量, 已处理的后继数)
+    for (size_t traversal = 0; traversal < kTraversals; ++traversal) {
+        if (traversal > 0) {
+            std::sort(roots.begin(), roots.end(), [traversal](std::uint32_t lhs, std::uint32_t rhs) {
+                const std::uint32_t lhs_key = RotationOffset(lhs, traversal, kNoComponent);
+                const std::uint32_t rhs_key = RotationOffset(rhs, traversal, kNoComponent);
+                return lhs_key != rhs_key ? lhs_key < rhs_key : lhs < rhs;
+            });
+        }
+        std::fill(visited.begin(), visited.end(), 0);
+        std::uint32_t post = 0;
+
+        const auto discover = [&](std::uint32_t component) {
+            visited[component] = 1;
+            index.intervals_[component][traversal].tree_low = post;
+            stack.emplace_back(component, 0);
+        };
+
+        for (const std::uint32_t root : roots) {
+            discover(root);
+            while (!stack.empty()) {
+                auto& [component, processed] = stack.back();
+                const auto [edges, degree] = successors(component);
+                if (processed < degree) {
+                    const std::uint32_t rotation = RotationOffset(component, traversal, degree);
+                    const std::uint32_t next = edges[(rotation + processed++) % degree];
+                    if (visited[next] == 0) {
+                        discover(next);
+                    }
+                    continue;
+                }
+
+                // DAG 中没有回边，后继此时都已完成；low 取子树与全部后继 low 的最小值
+                Interval& interval = index.intervals_[component][traversal];
+                interval.post = post++;
+                interval.low = interval.tree_low;
+                for (std::uint32_t position = 0; position < degree; ++position) {
+                    interval.low = std::min(interval.low, index.intervals_[edges[position]][traversal].low);
+                }
+                stack.pop_back();
+            }
+        }
+    }
+    return index;
+}
+
+bool ReachabilityIndex::Reaches(NodeId from, NodeId to) const {
+    const auto& component_of = components_.component_of;
+    if (from >= component_of.size() || to >= component_of.size()) {
+        return false;
+    }
+    const std::uint32_t from_component = component_of[from];
+    const std::uint32_t to_component = component_of[to];
+    if (from_component == to_component) {
+        return cyclic_[from_component] != 0;
+    }
+    if (to_component > from_component || !MayReach(from_component, to_component)) {
+        return false;
+    }
+    return LandmarkCovers(from_component, to_component) || TreeCovers(from_component, to_component) ||
+           SearchReaches(from_component, to_component);
+}
+
+bool ReachabilityIndex::MayReach(std::uint32_t from_component, std::uint32_t to_component) const {
+    if (level_[to_component] >= level_[from_component] ||
+        (landmark_out_[to_component] & ~landmark_out_[from_component]) != 0 ||
+        (landmark_in_[from_component] & ~landmark_in_[to_component]) != 0) {
+        return false;
+    }
+    const auto& from_intervals = intervals_[from_component];
+    const auto& to_intervals = intervals_[to_component];
+    for (size_t traversal = 0; traversal < kTraversals; ++traversal) {
+        if (to_intervals[traversal].low < from_intervals[traversal].low ||
+            to_intervals[traversal].post > from_intervals[traversal].post) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ReachabilityIndex::TreeCovers(std::uint32_t from_component, std::uint32_t to_component) const {
+    const auto& from_intervals = intervals_[from_component];
+    for (size_t traversal = 0; traversal < kTraversals; ++traversal) {
+        const std::uint32_t post = intervals_[to_component][traversal].post;
+        if (from_intervals[traversal].tree_low <= post && post <= from_intervals[traversal].post) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReachabilityIndex::SearchReaches(std::uint32_t from_component, std::uint32_t to_component) const {
+    thread_local SearchScratch scratch;
+    if (scratch.stamps.size() < ComponentCount()) {
+        scratch.stamps.assign(ComponentCount(), 0);
+        scratch.epoch = 0;
+    }
+    if (++scratch.epoch == 0) {
+        std::fill(scratch.stamps.begin(), scratch.stamps.end(), 0);
+        scratch.epoch = 1;
+    }
+
+    scratch.stack.clear();
+    scratch.stack.push_back(from_component);
+    scratch.stamps[from_component] = scratch.epoch;
+    while (!scratch.stack.empty()) {
+        const std::uint32_t component = scratch.stack.back();
+        scratch.stack.pop_back();
+        for (std::uint32_t position = dag_offsets_[component]; position < dag_offsets_[component + 1]; ++position) {
+            const std::uint32_t successor = dag_edges_[position];
+            if (successor == to_component) {
+                return true;
+            }
+            // 编号不大于 to 的分量不可能到达 to
+            if (successor < to_component || scratch.stamps[successor] == scratch.epoch ||
+                !MayReach(successor, to_component)) {
+                continue;
+            }
+            if (LandmarkCovers(successor, to_component) || TreeCovers(successor, to_component)) {
+                return true;
+            }
+            scratch.stamps[successor] = scratch.epoch;
+            scratch.stack.push_back(successor);
+        }
+    }
+    return false;
+}
+
+size_t ReachabilityIndex::MemoryBytes() const {
+    return components_.MemoryBytes() +
+           sizeof(std::uint32_t) * (dag_offsets_.capacity() + dag_edges_.capacity() + level_.capacity()) +
+           sizeof(std::uint64_t) * (landmark_out_.capacity() + landmark_in_.capacity()) +
+           cyclic_.capacity() + intervals_.capacity() * sizeof(intervals_[0]);
+}
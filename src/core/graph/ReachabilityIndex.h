@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "graph/TargetTable.h"
+#include "graph/TransitiveClosure.h"
+
+class DependencyGraph;
+
+// 可达性索引：在强连通分量缩点后的 DAG 上为每个分量保存常数个标签，内存与节点数、边数成线性关系。
+//
+// - 分量编号本身是逆拓扑序，后继分量的编号总是更小；另记每个分量到汇点的最长路径层数，
+//   层数不更高的分量不可能是后继；
+// - kTraversals 次随机化 DFS 各给出一个区间标签 [low, post]（GRAIL）：a 可达 b 时 b 的区间必落在 a 的区间内，
+//   任一区间不包含即可判定不可达；
+// - 同一次 DFS 的生成森林另给出树覆盖区间 [tree_low, post]：b 的后序号落在其中说明 b 是 a 在树上的子孙，直接判定可达；
+// - 按度数选出 kLandmarks 个枢纽分量，每个分量用两个位掩码记录能到达的枢纽与能到达它的枢纽（裁剪后的 2-hop 标签）：
+//   存在枢纽 h 使 a -> h -> b 时判定可达；a 可达 b 时 b 能到达的枢纽 a 也必能到达，反之即判定不可达。
+//
+// 绝大多数查询由这些标签在常数时间内回答；其余情况从 from 出发做 DFS，只进入区间包含 to 的分量，
+// 并在遇到树覆盖命中时提前结束。查询只读，可在多个线程上并发调用。
+class ReachabilityIndex {
+public:
+    using NodeId = TargetTable::Id;
+
+    static constexpr size_t kTraversals = 3;
+    static constexpr size_t kLandmarks = 64;   // 与 landmark 掩码的位数对应
+
+    ReachabilityIndex() = default;
+
+    // components 需覆盖全部节点
+    static ReachabilityIndex Build(const DependencyGraph& graph, SccPartition components);
+
+    // to 是否为 from 的传递依赖（from 自身仅在处于环上时算作自己的依赖）
+    bool Reaches(NodeId from, NodeId to) const;
+
+    size_t ComponentCount() const { return components_.Count(); }
+    size_t MemoryBytes() const;
+
+private:
+    struct Interval {
+        std::uint32_t low;        // 所有可达分量中最小的后序号
+        std::uint32_t tree_low;   // 生成树子树中最小的后序号（进入该分量时的后序计数）
+        std::uint32_t post;
+    };
+
+    // 所有标签都不能排除 from_component -> to_component 时为 true
+    bool MayReach(std::uint32_t from_component, std::uint32_t to_component) const;
+    // to 是否为 from 在某次 DFS 生成森林中的子孙
+    bool TreeCovers(std::uint32_t from_component, std::uint32_t to_component) const;
+    // 经由某个枢纽可达
+    bool LandmarkCovers(std::uint32_t from_component, std::uint32_t to_component) const {
+        return (landmark_out_[from_component] & landmark_in_[to_component]) != 0;
+    }
+    // 标签无法直接回答时的剪枝 DFS
+    bool SearchReaches(std::uint32_t from_component, std::uint32_t to_component) const;
+
+    SccPartition components_;
+    // 缩点后的 DAG（CSR，后继已去重）
+    std::vector<std::uint32_t> dag_offsets_{0};
+    std::vector<std::uint32_t> dag_edges_;
+    std::vector<std::uint8_t> cyclic_;      // 分量内有环（多个节点或自环）
+    std::vector<std::uint32_t> level_;      // 到汇点的最长路径边数
+    std::vector<std::array<Interval, kTraversals>> intervals_;
+    std::vector<std::uint64_t> landmark_out_;   // 可到达的枢纽（含自身）
+    std::vector<std::uint64_t> landmark_in_;    // 能到达它的枢纽（含自身）
+};
@@ -0,0 +1,255 @@
+#include "TargetTable.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t kInitialSlotCount = 64;
+
+std::uint64_t HashText(std::string_view text) {
+    std::uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char ch : text) {
+        hash ^= ch;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// 与 DependencyGraph 原先的 SimplifyDependencyName 一致：去掉 label 中的空白字符
+std::string StripWhitespace(const std::string& text) {
+    if (text.find_first_of(" \t\n") == std::string::npos) {
+        return text;
+    }
+    std::string result;
+    result.reserve(text.size());
+    for (char ch : text) {
+        if (ch != ' ' && ch != '\t' && ch != '\n') {
+            result.push_back(ch);
+        }
+    }
+    return result;
+}
+
+void CheckIdRange(size_t size, const char* what) {
+    if (size >= StringInterner::kInvalidId) {
+        throw std::length_error(std::string("TargetTable: too many ") + what);
+    }
+}
+
+}  // namespace
+
+StringInterner::Id StringInterner::Intern(std::string_view text) {
+    if (slots_.empty()) {
+        Rehash(kInitialSlotCount);
+    }
+
+    const std::uint64_t hash = HashText(text);
+    const size_t mask = slots_.size() - 1;
+    size_t slot = static_cast<size_t>(hash) & mask;
+    while (slots_[slot] != kInvalidId) {
+        const Id existing = slots_[slot];
+        if (hashes_[existing] == hash && View(existing) == text) {
+            return existing;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    CheckIdRange(Size(), "strings");
+    const Id id = static_cast<Id>(Size());
+    buffer_.append(text.data(), text.size());
+    offsets_.push_back(buffer_.size());
+    hashes_.push_back(hash);
+    slots_[slot] = id;
+
+    // 负载因子保持在 1/2 以下
+    if (Size() * 2 > slots_.size()) {
+        Rehash(slots_.size() * 2);
+    }
+    return id;
+}
+
+StringInterner::Id StringInterner::Find(std::string_view text) const {
+    if (slots_.empty()) {
+        return kInvalidId;
+    }
+
+    const std::uint64_t hash = HashText(text);
+    const size_t mask = slots_.size() - 1;
+    size_t slot = static_cast<size_t>(hash) & mask;
+    while (slots_[slot] != kInvalidId) {
+        const Id existing = slots_[slot];
+        if (hashes_[existing] == hash && View(existing) == text) {
+            return existing;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return kInvalidId;
+}
+
+void StringInterner::Reserve(size_t count, size_t total_bytes) {
+    buffer_.reserve(total_bytes);
+    offsets_.reserve(count + 1);
+    hashes_.reserve(count);
+
+    size_t slot_count = std::max(kInitialSlotCount, slots_.size());
+    while (slot_count < count * 2 + 1) {
+        slot_count *= 2;
+    }
+    if (slot_count != slots_.size()) {
+        Rehash(slot_count);
+    }
+}
+
+void StringInterner::Rehash(size_t slot_count) {
+    slots_.assign(slot_count, kInvalidId);
+    const size_t mask = slot_count - 1;
+    for (Id id = 0; id < Size(); ++id) {
+        size_t slot = static_cast<size_t>(hashes_[id]) & mask;
+        while (slots_[slot] != kInvalidId) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = id;
+    }
+}
+
+size_t StringInterner::MemoryBytes() const {
+    return buffer_.capacity() + offsets_.capacity() * sizeof(size_t) +
+           hashes_.capacity() * sizeof(std::uint64_t) + slots_.capacity() * sizeof(Id);
+}
+
+TargetTable TargetTable::Build(const std::unordered_map<std::string, BazelTarget>& targets) {
+    TargetTable table;
+
+    // 目标 label 先按字典序占住 [0, N)，保证 id 稳定且目标下标等于 label id
+    std::vector<const std::string*> names;
+    names.reserve(targets.size());
+    size_t label_bytes = 0;
+    size_t dep_count = 0;
+    size_t src_count = 0;
+    size_t hdr_count = 0;
+    for (const auto& [name, target] : targets) {
+        names.push_back(&name);
+        label_bytes += name.size();
+        dep_count += target.deps.size();
+        src_count += target.srcs.size();
+        hdr_count += target.hdrs.size();
+    }
+    std::sort(names.begin(), names.end(),
+              [](const std::string* lhs, const std::string* rhs) { return *lhs < *rhs; });
+    CheckIdRange(names.size(), "targets");
+    CheckIdRange(dep_count, "dependency edges");
+    CheckIdRange(src_count, "source files");
+    CheckIdRange(hdr_count, "header files");
+
+    table.labels_.Reserve(names.size() * 2, label_bytes * 2);
+    for (const std::string* name : names) {
+        table.labels_.Intern(*name);
+    }
+    table.target_count_ = names.size();
+
+    table.name_ids_.reserve(names.size());
+    table.path_ids_.reserve(names.size());
+    table.rule_type_ids_.reserve(names.size());
+    table.dep_offsets_.reserve(names.size() + 1);
+    table.src_offsets_.reserve(names.size() + 1);
+    table.hdr_offsets_.reserve(names.size() + 1);
+    table.dep_ids_.reserve(dep_count);
+    table.src_ids_.reserve(src_count);
+    table.hdr_ids_.reserve(hdr_count);
+
+    for (const std::string* name : names) {
+        const BazelTarget& target = targets.at(*name);
+        table.name_ids_.push_back(table.strings_.Intern(target.name));
+        table.path_ids_.push_back(table.strings_.Intern(target.path));
+        table.rule_type_ids_.push_back(table.strings_.Intern(target.rule_type));
+
+        for (const auto& dep : target.deps) {
+            table.dep_ids_.push_back(table.labels_.Intern(StripWhitespace(dep)));
+        }
+        for (const auto& src : target.srcs) {
+            table.src_ids_.push_back(table.strings_.Intern(src));
+        }
+        for (const auto& hdr : target.hdrs) {
+            table.hdr_ids_.push_back(table.strings_.Intern(hdr));
+        }
+        table.dep_offsets_.push_back(static_cast<std::uint32_t>(table.dep_ids_.size()));
+        table.src_offsets_.push_back(static_cast<std::uint32_t>(table.src_ids_.size()));
+        table.hdr_offsets_.push_back(static_cast<std::uint32_t>(table.hdr_ids_.size()));
+    }
+    CheckIdRange(table.labels_.Size(), "labels");
+
+    return table;
+}
+
+TargetTableDelta TargetTable::Diff(const TargetTable& previous, const TargetTable& current) {
+    TargetTableDelta delta;
+    delta.previous_to_current.resize(previous.LabelCount());
+    for (Id id = 0; id < previous.LabelCount(); ++id) {
+        delta.previous_to_current[id] = current.FindLabel(previous.Label(id));
+    }
+
+    const auto same_labels = [&](IdSpan lhs, IdSpan rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (size_t index = 0; index < lhs.size(); ++index) {
+            if (delta.previous_to_current[lhs[index]] != rhs[index]) {
+                return false;
+            }
+        }
+        return true;
+    };
+    const auto same_files = [&](IdSpan lhs, IdSpan rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (size_t index = 0; index < lhs.size(); ++index) {
+            if (previous.File(lhs[index]) != current.File(rhs[index])) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (Id target = 0; target < previous.TargetCount(); ++target) {
+        const Id mapped = delta.previous_to_current[target];
+        if (mapped == kInvalidId || !current.IsTarget(mapped)) {
+            delta.removed.emplace_back(previous.Label(target));
+            if (mapped != kInvalidId) {
+                delta.changed_ids.push_back(mapped);
+            }
+            continue;
+        }
+        if (previous.RuleType(target) != current.RuleType(mapped) ||
+            !same_labels(previous.Deps(target), current.Deps(mapped)) ||
+            !same_files(previous.Srcs(target), current.Srcs(mapped)) ||
+            !same_files(previous.Hdrs(target), current.Hdrs(mapped))) {
+            delta.changed.emplace_back(previous.Label(target));
+            delta.changed_ids.push_back(mapped);
+        }
+    }
+    for (Id target = 0; target < current.TargetCount(); ++target) {
+        if (previous.FindTarget(current.Label(target)) == kInvalidId) {
+            delta.added.emplace_back(current.Label(target));
+            delta.changed_ids.push_back(target);
+        }
+    }
+    std::sort(delta.changed_ids.begin(), delta.changed_ids.end());
+    return delta;
+}
+
+TargetTable::Id TargetTable::FindTarget(std::string_view label) const {
+    const Id id = labels_.Find(label);
+    return id < target_count_ ? id : kInvalidId;
+}
+
+size_t TargetTable::MemoryBytes() const {
+    const size_t id_bytes = sizeof(Id) * (name_ids_.capacity() + path_ids_.capacity() +
+                                          rule_type_ids_.capacity() + dep_ids_.capacity() +
+                                          src_ids_.capacity() + hdr_ids_.capacity());
+    const size_t offset_bytes = sizeof(std::uint32_t) * (dep_offsets_.capacity() +
+                                                         src_offsets_.capacity() +
+                                                         hdr_offsets_.capacity());
+    return labels_.MemoryBytes() + strings_.MemoryBytes() + id_bytes + offset_bytes;
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "struct.h"
+
+// 字符串驻留池：相同内容只存一份，按插入顺序分配 32 位 id。
+// 所有字符串连续存放在同一块缓冲区里，哈希索引是只存 id 的开放寻址表，避免每个字符串一次堆分配。
+class StringInterner {
+public:
+    using Id = std::uint32_t;
+    static constexpr Id kInvalidId = std::numeric_limits<Id>::max();
+
+    // 返回已有 id 或分配新 id
+    Id Intern(std::string_view text);
+
+    // 查找已驻留的字符串，不存在时返回 kInvalidId
+    Id Find(std::string_view text) const;
+
+    // 返回的视图在下一次 Intern 之前有效
+    std::string_view View(Id id) const {
+        return std::string_view(buffer_.data() + offsets_[id], offsets_[id + 1] - offsets_[id]);
+    }
+
+    size_t Size() const { return offsets_.size() - 1; }
+    void Reserve(size_t count, size_t total_bytes);
+    size_t MemoryBytes() const;
+
+private:
+    // 快照按原样保存与还原内部数组
+    friend class GraphSnapshot;
+
+    void Rehash(size_t slot_count);
+
+    std::string buffer_;
+    std::vector<size_t> offsets_{0};    // 第 i 个字符串位于 [offsets_[i], offsets_[i + 1])
+    std::vector<std::uint64_t> hashes_; // 每个 id 的哈希，扩容时免重算
+    std::vector<Id> slots_;             // 开放寻址槽位，kInvalidId 表示空
+};
+
+struct TargetTableDelta;
+
+// 全工作区共享的目标表：label 与文件路径驻留为 32 位 id，每个目标的字段按列存放（struct-of-arrays），
+// deps / srcs / hdrs 是指向连续 id 数组的区间。
+//
+// label id 的分配规则：先按字典序为所有目标分配 [0, TargetCount())，之后出现的仅作为依赖的 label
+// （外部依赖、不在工作区内的目标）追加在后面。因此目标下标与其 label id 相同，
+// DependencyGraph 直接以 label id 作为节点 id。
+class TargetTable {
+public:
+    using Id = StringInterner::Id;
+    static constexpr Id kInvalidId = StringInterner::kInvalidId;
+
+    // 连续 id 区间的只读视图
+    class IdSpan {
+    public:
+        IdSpan() = default;
+        IdSpan(const Id* data, size_t size) : data_(data), size_(size) {}
+
+        const Id* begin() const { return data_; }
+        const Id* end() const { return data_ + size_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        Id operator[](size_t index) const { return data_[index]; }
+
+    private:
+        const Id* data_{nullptr};
+        size_t size_{0};
+    };
+
+    TargetTable() = default;
+
+    // 从解析结果构建；结果与 unordered_map 的遍历顺序无关
+    static TargetTable Build(const std::unordered_map<std::string, BazelTarget>& targets);
+
+    size_t TargetCount() const { return target_count_; }
+    size_t LabelCount() const { return labels_.Size(); }
+    bool IsTarget(Id label_id) const { return label_id < target_count_; }
+
+    // label -> id；未出现过的 label 返回 kInvalidId
+    Id FindLabel(std::string_view label) const { return labels_.Find(label); }
+    // label -> 目标下标；不是工作区目标时返回 kInvalidId
+    Id FindTarget(std::string_view label) const;
+
+    std::string_view Label(Id label_id) const { return labels_.View(label_id); }
+    std::string_view Name(Id target) const { return strings_.View(name_ids_[target]); }
+    std::string_view Path(Id target) const { return strings_.View(path_ids_[target]); }
+    std::string_view RuleType(Id target) const { return strings_.View(rule_type_ids_[target]); }
+
+    // 依赖为 label id（已去除空白，保留声明顺序与重复项）
+    IdSpan Deps(Id target) const { return MakeSpan(dep_offsets_, dep_ids_, target); }
+    // 源文件 / 头文件为路径 id，用 File() 取回字符串
+    IdSpan Srcs(Id target) const { return MakeSpan(src_offsets_, src_ids_, target); }
+    IdSpan Hdrs(Id target) const { return MakeSpan(hdr_offsets_, hdr_ids_, target); }
+    std::string_view File(Id file_id) const { return strings_.View(file_id); }
+
+    // 目标表自身占用的内存（估算），用于日志与缓存统计
+    size_t MemoryBytes() const;
+
+    // 按 label 比较两个版本的目标表，O(标签数 + 依赖边数)
+    static TargetTableDelta Diff(const TargetTable& previous, const TargetTable& current);
+
+private:
+    friend class GraphSnapshot;
+
+    static IdSpan MakeSpan(const std::vector<std::uint32_t>& offsets,
+                           const std::vector<Id>& ids,
+                           Id target) {
+        return IdSpan(ids.data() + offsets[target], offsets[target + 1] - offsets[target]);
+    }
+
+    size_t target_count_{0};
+    StringInterner labels_;     // 目标与依赖 label
+    StringInterner strings_;    // 文件路径、目标名、规则类型
+
+    std::vector<Id> name_ids_;
+    std::vector<Id> path_ids_;
+    std::vector<Id> rule_type_ids_;
+
+    std::vector<std::uint32_t> dep_offsets_{0};
+    std::vector<Id> dep_ids_;
+    std::vector<std::uint32_t> src_offsets_{0};
+    std::vector<Id> src_ids_;
+    std::vector<std::uint32_t> hdr_offsets_{0};
+    std::vector<Id> hdr_ids_;
+};
+
+// 两个版本目标表之间的差异，以及旧 label id 到新 label id 的映射。
+// 新增或删除目标会使后续 label 的 id 整体偏移，缓存迁移时一律经 Map 转换
+struct TargetTableDelta {
+    std::vector<std::string> added;      // 新增的目标
+    std::vector<std::string> removed;    // 删除的目标
+    std::vector<std::string> changed;    // 规则类型、deps、srcs 或 hdrs 有变化的目标
+    // 新表中的变更节点（新增、变更，以及仍作为依赖 label 出现的已删除目标），按 id 升序
+    std::vector<TargetTable::Id> changed_ids;
+    // 旧 label id -> 新 label id；label 已不存在时为 kInvalidId
+    std::vector<TargetTable::Id> previous_to_current;
+
+    bool Empty() const { return added.empty() && removed.empty() && changed.empty(); }
+
+    TargetTable::Id Map(TargetTable::Id previous) const {
+        return previous < previous_to_current.size() ? previous_to_current[previous] : TargetTable::kInvalidId;
+    }
+
+    // 新表中的 id 是否为变更节点
+    bool IsChanged(TargetTable::Id current) const {
+        return std::binary_search(changed_ids.begin(), changed_ids.end(), current);
+    }
+};
@@ -0,0 +1,197 @@
+#include "TransitiveClosure.h"
+
+#include "graph/DependencyGraph.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace {
+
+constexpr std::uint32_t kNoComponent = std::numeric_limits<std::uint32_t>::max();
+
+void SetBitRange(std::vector<std::uint64_t>& words, std::uint32_t begin, std::uint32_t end) {
+    while (begin < end) {
+        const std::uint32_t offset = begin % 64;
+        const std::uint32_t count = std::min<std::uint32_t>(64 - offset, end - begin);
+        const std::uint64_t mask = count == 64 ? ~0ULL : ((1ULL << count) - 1) << offset;
+        words[begin / 64] |= mask;
+        begin += count;
+    }
+}
+
+}  // namespace
+
+bool TransitiveClosure::ReachSet::Contains(std::uint32_t component) const {
+    if (dense) {
+        const size_t word = component / 64;
+        return word < words.size() && ((words[word] >> (component % 64)) & 1ULL) != 0;
+    }
+
+    // 找到最后一个起点不大于 component 的区间
+    size_t low = 0;
+    size_t high = runs.size() / 2;
+    while (low < high) {
+        const size_t middle = (low + high) / 2;
+        if (runs[middle * 2] <= component) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low > 0 && component < runs[(low - 1) * 2 + 1];
+}
+
+size_t TransitiveClosure::ReachSet::MemoryBytes() const {
+    return runs.capacity() * sizeof(std::uint32_t) + words.capacity() * sizeof(std::uint64_t);
+}
+
+TransitiveClosure TransitiveClosure::Build(const DependencyGraph& graph,
+                                           SccPartition components,
+                                           size_t memory_budget) {
+    TransitiveClosure closure;
+    closure.components_ = std::move(components);
+    const auto& component_of = closure.components_.component_of;
+    const auto& component_offsets = closure.components_.offsets;
+    const auto& component_nodes = closure.components_.nodes;
+
+    const auto component_count = static_cast<std::uint32_t>(closure.ComponentCount());
+    const size_t word_count = (static_cast<size_t>(component_count) + 63) / 64;
+    closure.reach_.resize(component_count);
+
+    std::vector<std::uint32_t> last_seen(component_count, kNoComponent);
+    std::vector<std::uint32_t> successors;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> gathered;
+    size_t memory = 0;
+
+    // 逆拓扑序：处理分量 c 时它的后继分量都已算完
+    for (std::uint32_t component = 0; component < component_count; ++component) {
+        const std::uint32_t node_begin = component_offsets[component];
+        const std::uint32_t node_end = component_offsets[component + 1];
+        bool cyclic = node_end - node_begin > 1;
+
+        successors.clear();
+        bool any_dense = false;
+        for (std::uint32_t index = node_begin; index < node_end; ++index) {
+            for (const NodeId dep : graph.GetDirectDependencyIds(component_nodes[index])) {
+                const std::uint32_t successor = component_of[dep];
+                if (successor == component) {
+                    cyclic = true;
+                } else if (last_seen[successor] != component) {
+                    last_seen[successor] = component;
+                    successors.push_back(successor);
+                    any_dense = any_dense || closure.reach_[successor].dense;
+                }
+            }
+        }
+
+        ReachSet& reach = closure.reach_[component];
+        if (!any_dense) {
+            // 后继都是区间表示：收集区间后排序合并
+            gathered.clear();
+            for (const std::uint32_t successor : successors) {
+                gathered.emplace_back(successor, successor + 1);
+                const auto& runs = closure.reach_[successor].runs;
+                for (size_t index = 0; index < runs.size(); index += 2) {
+                    gathered.emplace_back(runs[index], runs[index + 1]);
+                }
+            }
+            if (cyclic) {
+                gathered.emplace_back(component, component + 1);
+            }
+            std::sort(gathered.begin(), gathered.end());
+            for (const auto& [begin, end] : gathered) {
+                if (!reach.runs.empty() && begin <= reach.runs.back()) {
+                    reach.runs.back() = std::max(reach.runs.back(), end);
+                } else {
+                    reach.runs.push_back(begin);
+                    reach.runs.push_back(end);
+                }
+            }
+
+            // 区间数超过位图字数时改用位图
+            if (reach.runs.size() / 2 > word_count) {
+                reach.words.assign(word_count, 0);
+                for (size_t index = 0; index < reach.runs.size(); index += 2) {
+                    SetBitRange(reach.words, reach.runs[index], reach.runs[index + 1]);
+                }
+                reach.runs.clear();
+                reach.dense = true;
+            }
+            reach.runs.shrink_to_fit();
+        } else {
+            reach.dense = true;
+            reach.words.assign(word_count, 0);
+            for (const std::uint32_t successor : successors) {
+                const ReachSet& successor_reach = closure.reach_[successor];
+                if (successor_reach.dense) {
+                    for (size_t word = 0; word < word_count; ++word) {
+                        reach.words[word] |= successor_reach.words[word];
+                    }
+                } else {
+                    for (size_t index = 0; index < successor_reach.runs.size(); index += 2) {
+                        SetBitRange(reach.words, successor_reach.runs[index], successor_reach.runs[index + 1]);
+                    }
+                }
+                SetBitRange(reach.words, successor, successor + 1);
+            }
+            if (cyclic) {
+                SetBitRange(reach.words, component, component + 1);
+            }
+        }
+
+        memory += reach.MemoryBytes();
+        if (memory > memory_budget) {
+            return TransitiveClosure();
+        }
+    }
+
+    closure.complete_ = true;
+    return closure;
+}
+
+bool TransitiveClosure::Reaches(NodeId from, NodeId to) const {
+    const auto& component_of = components_.component_of;
+    if (!complete_ || from >= component_of.size() || to >= component_of.size()) {
+        return false;
+    }
+    return reach_[component_of[from]].Contains(component_of[to]);
+}
+
+std::vector<TransitiveClosure::NodeId> TransitiveClosure::Descendants(NodeId from) const {
+    std::vector<NodeId> descendants;
+    if (!complete_ || from >= components_.component_of.size()) {
+        return descendants;
+    }
+
+    const auto append_component = [this, &descendants](std::uint32_t component) {
+        const TargetTable::IdSpan nodes = components_.Component(component);
+        descendants.insert(descendants.end(), nodes.begin(), nodes.end());
+    };
+
+    const ReachSet& reach = reach_[components_.component_of[from]];
+    if (reach.dense) {
+        for (size_t word = 0; word < reach.words.size(); ++word) {
+            for (std::uint64_t bits = reach.words[word]; bits != 0; bits &= bits - 1) {
+                append_component(static_cast<std::uint32_t>(word * 64 + __builtin_ctzll(bits)));
+            }
+        }
+    } else {
+        for (size_t index = 0; index < reach.runs.size(); index += 2) {
+            for (std::uint32_t component = reach.runs[index]; component < reach.runs[index + 1]; ++component) {
+                append_component(component);
+            }
+        }
+    }
+
+    std::sort(descendants.begin(), descendants.end());
+    return descendants;
+}
+
+size_t TransitiveClosure::MemoryBytes() const {
+    size_t bytes = components_.MemoryBytes() + reach_.capacity() * sizeof(ReachSet);
+    for (const auto& reach : reach_) {
+        bytes += reach.MemoryBytes();
+    }
+    return bytes;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "graph/TargetTable.h"
+
+class DependencyGraph;
+
+// 强连通分量划分：分量按逆拓扑序（Tarjan 完成顺序）编号，分量内节点按 id 升序，
+// 全部分量连续存放在 nodes 中
+struct SccPartition {
+    using NodeId = TargetTable::Id;
+
+    std::vector<std::uint32_t> offsets{0};     // 分量 c 的节点为 nodes[offsets[c], offsets[c + 1])
+    std::vector<NodeId> nodes;
+    std::vector<std::uint32_t> component_of;   // 节点 -> 分量
+
+    size_t Count() const { return offsets.size() - 1; }
+    TargetTable::IdSpan Component(size_t component) const {
+        return TargetTable::IdSpan(nodes.data() + offsets[component], offsets[component + 1] - offsets[component]);
+    }
+    size_t MemoryBytes() const {
+        return sizeof(std::uint32_t) * (offsets.capacity() + component_of.capacity()) +
+               sizeof(NodeId) * nodes.capacity();
+    }
+};
+
+// 传递闭包引擎：把强连通分量缩成单点得到 DAG，再按逆拓扑序为每个分量一次性算出可达分量集合，
+// 之后的可达性判断只是一次位探测。
+//
+// 分量按 Tarjan 的完成顺序（DFS 后序）编号，一个分量的子孙大多落在连续编号区间内，
+// 因此可达集合优先用有序区间（run）表示，长依赖链也只占常数空间；区间数超过稠密位图的字数时
+// 改用稠密位图，合并时按 64 位字并行 OR。
+class TransitiveClosure {
+public:
+    using NodeId = TargetTable::Id;
+
+    TransitiveClosure() = default;
+
+    // components 需覆盖全部节点；可达集合总大小超过 memory_budget 字节时放弃构建，
+    // Complete() 返回 false
+    static TransitiveClosure Build(const DependencyGraph& graph,
+                                   SccPartition components,
+                                   size_t memory_budget);
+
+    bool Complete() const { return complete_; }
+
+    // to 是否为 from 的传递依赖（from 自身仅在处于环上时算作自己的依赖）
+    bool Reaches(NodeId from, NodeId to) const;
+
+    // from 的全部传递依赖，按 id 升序
+    std::vector<NodeId> Descendants(NodeId from) const;
+
+    size_t ComponentCount() const { return components_.Count(); }
+    std::uint32_t ComponentOf(NodeId node) const { return components_.component_of[node]; }
+    size_t MemoryBytes() const;
+
+private:
+    // 一个分量的可达分量集合：区间表示 [runs[2i], runs[2i + 1])，或 words 中的稠密位图
+    struct ReachSet {
+        std::vector<std::uint32_t> runs;
+        std::vector<std::uint64_t> words;
+        bool dense{false};
+
+        bool Contains(std::uint32_t component) const;
+        size_t MemoryBytes() const;
+    };
+
+    bool complete_{false};
+    SccPartition components_;
+    std::vector<ReachSet> reach_;
+};
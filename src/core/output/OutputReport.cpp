@@ -1,5 +1,6 @@
 #include "OutputReport.h"
 
+#include <algorithm>
 #include <ctime>
 #include <fstream>
 #include <iomanip>
@@ -72,6 +73,32 @@ std::string CycleTypeToString(CycleType type) {
     return os.str();
 }
 
+// 文本类报告中每个强连通分量最多列出的目标数，完整列表见 JSON 报告
+constexpr size_t kMaxListedComponentTargets = 20;
+
+size_t CountComponentCycles(const std::vector<ComponentAnalysis>& components) {
+    size_t total = 0;
+    for (const auto& component : components) {
+        total += component.covering_cycles.size();
+    }
+    return total;
+}
+
+std::string FormatComponentTargets(const ComponentAnalysis& component) {
+    std::ostringstream ss;
+    const size_t listed = std::min(component.targets.size(), kMaxListedComponentTargets);
+    for (size_t index = 0; index < listed; ++index) {
+        if (index > 0) {
+            ss << ", ";
+        }
+        ss << component.targets[index];
+    }
+    if (listed < component.targets.size()) {
+        ss << " … 共 " << component.targets.size() << " 个";
+    }
+    return ss.str();
+}
+
 std::vector<std::pair<std::string, std::string>> CollectArtifacts(
     const bazel_analyzer::AnalysisResult& result) {
     std::vector<std::pair<std::string, std::string>> artifacts;
@@ -100,6 +127,22 @@ std::string OutputReport::RenderCycleReport(
     return os.str();
 }
 
+std::string OutputReport::RenderCycleReport(
+    const std::vector<ComponentAnalysis>& components,
+    const OutputFormat& format) const {
+    std::ostringstream os;
+    GenerateCycleReport(components, format, os);
+    return os.str();
+}
+
+std::string OutputReport::RenderCycleReport(
+    const FeedbackArcSetAnalysis& feedback_arcs,
+    const OutputFormat& format) const {
+    std::ostringstream os;
+    GenerateCycleReport(feedback_arcs, format, os);
+    return os.str();
+}
+
 std::string OutputReport::RenderUnusedDependenciesReport(
     const std::vector<RemovableDependency>& unused_dependencies,
     const OutputFormat& format) const {
@@ -108,6 +151,14 @@ std::string OutputReport::RenderUnusedDependenciesReport(
     return os.str();
 }
 
+std::string OutputReport::RenderTransitiveReductionReport(
+    const TransitiveReductionAnalysis& reduction,
+    const OutputFormat& format) const {
+    std::ostringstream os;
+    GenerateTransitiveReductionReport(reduction, format, os);
+    return os.str();
+}
+
 std::string OutputReport::RenderBuildTimeReport(
     const bazel_analyzer::AnalysisResult& result,
     const OutputFormat& format) const {
@@ -124,6 +175,22 @@ void OutputReport::GenerateCycleReport(
     });
 }
 
+void OutputReport::GenerateCycleReport(
+    const std::vector<ComponentAnalysis>& components,
+    const OutputFormat& format) const {
+    WriteToConfiguredOutput(output_path_, [this, &components, &format](std::ostream& os) {
+        GenerateCycleReport(components, format, os);
+    });
+}
+
+void OutputReport::GenerateCycleReport(
+    const FeedbackArcSetAnalysis& feedback_arcs,
+    const OutputFormat& format) const {
+    WriteToConfiguredOutput(output_path_, [this, &feedback_arcs, &format](std::ostream& os) {
+        GenerateCycleReport(feedback_arcs, format, os);
+    });
+}
+
 void OutputReport::GenerateUnusedDependenciesReport(
     const std::vector<RemovableDependency>& unused_dependencies,
     const OutputFormat& format) const {
@@ -132,6 +199,14 @@ void OutputReport::GenerateUnusedDependenciesReport(
     });
 }
 
+void OutputReport::GenerateTransitiveReductionReport(
+    const TransitiveReductionAnalysis& reduction,
+    const OutputFormat& format) const {
+    WriteToConfiguredOutput(output_path_, [this, &reduction, &format](std::ostream& os) {
+        GenerateTransitiveReductionReport(reduction, format, os);
+    });
+}
+
 void OutputReport::GenerateBuildTimeReport(
     const bazel_analyzer::AnalysisResult& result,
     const OutputFormat& format) const {
@@ -160,6 +235,46 @@ void OutputReport::GenerateCycleReport(
     }
 }
 
+void OutputReport::GenerateCycleReport(
+    const std::vector<ComponentAnalysis>& components,
+    const OutputFormat& format,
+    std::ostream& output_stream) const {
+    switch (format) {
+        case OutputFormat::CONSOLE:
+            GenerateComponentConsoleReport(components, output_stream);
+            break;
+        case OutputFormat::MARKDOWN:
+            GenerateComponentMarkdownReport(components, output_stream);
+            break;
+        case OutputFormat::JSON:
+            GenerateComponentJsonReport(components, output_stream);
+            break;
+        case OutputFormat::HTML:
+            GenerateComponentHtmlReport(components, output_stream);
+            break;
+    }
+}
+
+void OutputReport::GenerateCycleReport(
+    const FeedbackArcSetAnalysis& feedback_arcs,
+    const OutputFormat& format,
+    std::ostream& output_stream) const {
+    switch (format) {
+        case OutputFormat::CONSOLE:
+            GenerateFeedbackArcConsoleReport(feedback_arcs, output_stream);
+            break;
+        case OutputFormat::MARKDOWN:
+            GenerateFeedbackArcMarkdownReport(feedback_arcs, output_stream);
+            break;
+        case OutputFormat::JSON:
+            GenerateFeedbackArcJsonReport(feedback_arcs, output_stream);
+            break;
+        case OutputFormat::HTML:
+            GenerateFeedbackArcHtmlReport(feedback_arcs, output_stream);
+            break;
+    }
+}
+
 void OutputReport::GenerateUnusedDependenciesReport(
     const std::vector<RemovableDependency>& unused_dependencies,
     const OutputFormat& format,
@@ -180,6 +295,26 @@ void OutputReport::GenerateUnusedDependenciesReport(
     }
 }
 
+void OutputReport::GenerateTransitiveReductionReport(
+    const TransitiveReductionAnalysis& reduction,
+    const OutputFormat& format,
+    std::ostream& output_stream) const {
+    switch (format) {
+        case OutputFormat::CONSOLE:
+            GenerateTransitiveReductionConsoleReport(reduction, output_stream);
+            break;
+        case OutputFormat::MARKDOWN:
+            GenerateTransitiveReductionMarkdownReport(reduction, output_stream);
+            break;
+        case OutputFormat::JSON:
+            GenerateTransitiveReductionJsonReport(reduction, output_stream);
+            break;
+        case OutputFormat::HTML:
+            GenerateTransitiveReductionHtmlReport(reduction, output_stream);
+            break;
+    }
+}
+
 void OutputReport::GenerateBuildTimeReport(
     const bazel_analyzer::AnalysisResult& result,
     const OutputFormat& format,
@@ -720,6 +855,522 @@ void OutputReport::GenerateCycleHtmlReport(
     WriteHtmlDocumentEnd(os);
 }
 
+void OutputReport::GenerateComponentConsoleReport(
+    const std::vector<ComponentAnalysis>& components,
+    std::ostream& os) const {
+    if (components.empty()) {
+        os << "未发现循环依赖\n";
+        return;
+    }
+
+    os << "========================================\n";
+    os << "   强连通分量分析报告\n";
+    os << "   生成时间: " << GetCurrentTimestamp() << "\n";
+    os << "   强连通分量数量: " << components.size() << "\n";
+    os << "   覆盖环数量: " << CountComponentCycles(components) << "\n";
+    os << "========================================\n\n";
+
+    for (size_t index = 0; index < components.size(); ++index) {
+        const auto& component = components[index];
+
+        os << "分量 #" << (index + 1) << ":\n";
+        os << "├─ 规模: " << component.targets.size() << " 个目标, " << component.internal_edges << " 条内部边\n";
+        os << "├─ 外部边: 入 " << component.entry_edges << " / 出 " << component.exit_edges << "\n";
+        os << "├─ 独立环数: " << component.cycle_rank << "\n";
+        os << "├─ 目标: " << FormatComponentTargets(component) << "\n";
+        if (component.truncated) {
+            os << "├─ 注意: 已达到环数上限或超时，部分目标不在任何覆盖环上\n";
+        }
+        os << "└─ 覆盖环 (" << component.covering_cycles.size() << "):\n";
+        for (size_t cycle_index = 0; cycle_index < component.covering_cycles.size(); ++cycle_index) {
+            const auto& analysis = component.covering_cycles[cycle_index];
+            os << "   " << (cycle_index + 1) << ". [" << analysis.cycle_type << "] "
+               << FormatCyclePath(analysis.cycle) << "\n";
+            for (const auto& dep : analysis.removable_dependencies) {
+                os << "      可移除: " << dep.from_target << " → " << dep.to_target;
+                if (!dep.reason.empty()) {
+                    os << " (" << dep.reason << ")";
+                }
+                os << "\n";
+            }
+        }
+        os << "\n";
+    }
+}
+
+void OutputReport::GenerateComponentMarkdownReport(
+    const std::vector<ComponentAnalysis>& components,
+    std::ostream& os) const {
+    os << "# 强连通分量分析报告\n\n";
+    os << "- **生成时间**: " << GetCurrentTimestamp() << "\n";
+    os << "- **强连通分量数量**: " << components.size() << "\n";
+    os << "- **覆盖环数量**: " << CountComponentCycles(components) << "\n\n";
+
+    if (components.empty()) {
+        os << "未发现循环依赖\n";
+        return;
+    }
+
+    os << "## 分量详情\n\n";
+    for (size_t index = 0; index < components.size(); ++index) {
+        const auto& component = components[index];
+        os << "### 分量 #" << (index + 1) << "\n\n";
+        os << "- **规模**: " << component.targets.size() << " 个目标, " << component.internal_edges << " 条内部边\n";
+        os << "- **外部边**: 入 " << component.entry_edges << " / 出 " << component.exit_edges << "\n";
+        os << "- **独立环数**: " << component.cycle_rank << "\n";
+        os << "- **目标**: `" << FormatComponentTargets(component) << "`\n";
+        if (component.truncated) {
+            os << "- **注意**: 已达到环数上限或超时，部分目标不在任何覆盖环上\n";
+        }
+        os << "\n| # | 类型 | 覆盖环 | 可安全移除的依赖 |\n";
+        os << "|---|---|---|---|\n";
+        for (size_t cycle_index = 0; cycle_index < component.covering_cycles.size(); ++cycle_index) {
+            const auto& analysis = component.covering_cycles[cycle_index];
+            os << "| " << (cycle_index + 1) << " | `" << analysis.cycle_type << "` | `"
+               << FormatCyclePath(analysis.cycle) << "` | ";
+            for (size_t dep_index = 0; dep_index < analysis.removable_dependencies.size(); ++dep_index) {
+                const auto& dep = analysis.removable_dependencies[dep_index];
+                os << (dep_index > 0 ? "<br>" : "") << "`" << dep.from_target << "` → `" << dep.to_target << "`";
+            }
+            os << " |\n";
+        }
+        os << "\n";
+    }
+}
+
+void OutputReport::GenerateComponentJsonReport(
+    const std::vector<ComponentAnalysis>& components,
+    std::ostream& os) const {
+    const auto write_string_array = [this, &os](const std::vector<std::string>& values, const std::string& indent) {
+        os << "[\n";
+        for (size_t index = 0; index < values.size(); ++index) {
+            os << indent << "  \"" << EscapeJsonString(values[index]) << "\"";
+            if (index + 1 < values.size()) {
+                os << ",";
+            }
+            os << "\n";
+        }
+        os << indent << "]";
+    };
+
+    os << "{\n";
+    os << "  \"report\": {\n";
+    os << "    \"timestamp\": \"" << EscapeJsonString(GetCurrentTimestamp()) << "\",\n";
+    os << "    \"mode\": \"scc\",\n";
+    os << "    \"total_components\": " << components.size() << ",\n";
+    os << "    \"total_cycles\": " << CountComponentCycles(components) << ",\n";
+    os << "    \"components\": [\n";
+
+    for (size_t index = 0; index < components.size(); ++index) {
+        const auto& component = components[index];
+        os << "      {\n";
+        os << "        \"id\": " << (index + 1) << ",\n";
+        os << "        \"size\": " << component.targets.size() << ",\n";
+        os << "        \"internal_edges\": " << component.internal_edges << ",\n";
+        os << "        \"entry_edges\": " << component.entry_edges << ",\n";
+        os << "        \"exit_edges\": " << component.exit_edges << ",\n";
+        os << "        \"cycle_rank\": " << component.cycle_rank << ",\n";
+        os << "        \"truncated\": " << (component.truncated ? "true" : "false") << ",\n";
+        os << "        \"targets\": ";
+        write_string_array(component.targets, "        ");
+        os << ",\n";
+        os << "        \"covering_cycles\": [\n";
+        for (size_t cycle_index = 0; cycle_index < component.covering_cycles.size(); ++cycle_index) {
+            const auto& analysis = component.covering_cycles[cycle_index];
+            os << "          {\n";
+            os << "            \"type\": \"" << CycleTypeToString(analysis.cycle_type) << "\",\n";
+            os << "            \"length\": " << analysis.cycle.size() << ",\n";
+            os << "            \"path\": ";
+            write_string_array(analysis.cycle, "            ");
+            os << ",\n";
+            os << "            \"removable_dependencies\": [\n";
+            for (size_t dep_index = 0; dep_index < analysis.removable_dependencies.size(); ++dep_index) {
+                const auto& dep = analysis.removable_dependencies[dep_index];
+                os << "              {\n";
+                os << "                \"from\": \"" << EscapeJsonString(dep.from_target) << "\",\n";
+                os << "                \"to\": \"" << EscapeJsonString(dep.to_target) << "\",\n";
+                os << "                \"reason\": \"" << EscapeJsonString(dep.reason) << "\",\n";
+                os << "                \"confidence\": \"" << ConfidenceLevelToString(dep.confidence) << "\"\n";
+                os << "              }";
+                if (dep_index + 1 < analysis.removable_dependencies.size()) {
+                    os << ",";
+                }
+                os << "\n";
+            }
+            os << "            ]\n";
+            os << "          }";
+            if (cycle_index + 1 < component.covering_cycles.size()) {
+                os << ",";
+            }
+            os << "\n";
+        }
+        os << "        ]\n";
+        os << "      }";
+        if (index + 1 < components.size()) {
+            os << ",";
+        }
+        os << "\n";
+    }
+
+    os << "    ]\n";
+    os << "  }\n";
+    os << "}\n";
+}
+
+void OutputReport::GenerateComponentHtmlReport(
+    const std::vector<ComponentAnalysis>& components,
+    std::ostream& os) const {
+    const size_t total_cycles = CountComponentCycles(components);
+    size_t largest = 0;
+    for (const auto& component : components) {
+        largest = std::max(largest, component.targets.size());
+    }
+
+    WriteHtmlDocumentStart(os, "强连通分量分析报告");
+    WriteHtmlHeader(os,
+                    "强连通分量分析报告",
+                    {{"生成时间", GetCurrentTimestamp()},
+                     {"强连通分量数量", std::to_string(components.size())}});
+
+    os << "  <section class=\"panel\">\n";
+    os << "    <div class=\"panel-header\">\n";
+    os << "      <h2>概览</h2>\n";
+    os << "      <p>每个强连通分量给出规模、内外边数，以及覆盖分量内全部目标的覆盖环。</p>\n";
+    os << "    </div>\n";
+    os << "    <div class=\"metric-grid\">\n";
+    WriteHtmlMetricCard(os, "强连通分量", std::to_string(components.size()), "danger");
+    WriteHtmlMetricCard(os, "覆盖环", std::to_string(total_cycles));
+    WriteHtmlMetricCard(os, "最大分量", std::to_string(largest));
+    os << "    </div>\n";
+    os << "  </section>\n";
+
+    if (components.empty()) {
+        os << "  <section class=\"panel empty-state\">\n";
+        os << "    <h2>没有发现循环依赖</h2>\n";
+        os << "    <p>当前工作区未检测到循环链路。</p>\n";
+        os << "  </section>\n";
+        WriteHtmlDocumentEnd(os);
+        return;
+    }
+
+    os << "  <section class=\"panel\">\n";
+    os << "    <div class=\"panel-header\">\n";
+    os << "      <h2>分量详情</h2>\n";
+    os << "      <p>按分量规模从大到小排列。</p>\n";
+    os << "    </div>\n";
+
+    for (size_t index = 0; index < components.size(); ++index) {
+        const auto& component = components[index];
+        os << "    <details class=\"group-card\"" << (index == 0 ? " open" : "") << ">\n";
+        os << "      <summary>\n";
+        os << "        <div>\n";
+        os << "          <strong>分量 #" << (index + 1) << "</strong>\n";
+        os << "          <span class=\"muted\">" << component.targets.size() << " 个目标 · "
+           << component.internal_edges << " 条内部边 · 入 " << component.entry_edges << " / 出 "
+           << component.exit_edges << " · 独立环数 " << component.cycle_rank << "</span>\n";
+        os << "        </div>\n";
+        os << "        <span class=\"chip chip-danger\">SCC</span>\n";
+        os << "      </summary>\n";
+        os << "      <div class=\"stack-list\">\n";
+        os << "        <article class=\"item-card\">\n";
+        os << "          <div class=\"item-main\">\n";
+        os << "            <h3>目标</h3>\n";
+        os << "            <p class=\"path-block\">" << EscapeHtmlString(FormatComponentTargets(component)) << "</p>\n";
+        if (component.truncated) {
+            os << "            <p class=\"muted\">已达到环数上限或超时，部分目标不在任何覆盖环上。</p>\n";
+        }
+        os << "          </div>\n";
+        os << "        </article>\n";
+        os << "        <article class=\"item-card tone-warning\">\n";
+        os << "          <div class=\"item-main\">\n";
+        os << "            <h3>覆盖环</h3>\n";
+        os << "            <ul class=\"bullet-list\">\n";
+        for (const auto& analysis : component.covering_cycles) {
+            os << "              <li><strong>" << EscapeHtmlString(CycleTypeToString(analysis.cycle_type))
+               << "</strong> " << EscapeHtmlString(FormatCyclePath(analysis.cycle));
+            for (const auto& dep : analysis.removable_dependencies) {
+                os << " <span class=\"pill\">" << EscapeHtmlString("可移除 " + dep.from_target + " → " + dep.to_target)
+                   << "</span>";
+            }
+            os << "</li>\n";
+        }
+        os << "            </ul>\n";
+        os << "          </div>\n";
+        os << "        </article>\n";
+        os << "      </div>\n";
+        os << "    </details>\n";
+    }
+    os << "  </section>\n";
+    WriteHtmlDocumentEnd(os);
+}
+
+void OutputReport::GenerateFeedbackArcConsoleReport(
+    const FeedbackArcSetAnalysis& feedback_arcs,
+    std::ostream& os) const {
+    if (feedback_arcs.edges.empty()) {
+        os << "未发现循环依赖\n";
+        return;
+    }
+
+    os << "========================================\n";
+    os << "   打破循环的最小边集\n";
+    os << "   生成时间: " << GetCurrentTimestamp() << "\n";
+    os << "   边数: " << feedback_arcs.edges.size() << " (可直接删除 " << feedback_arcs.removable_edges << ")\n";
+    os << "   总代价: " << feedback_arcs.total_cost << "\n";
+    os << "   涉及强连通分量: " << feedback_arcs.cyclic_components << "\n";
+    os << "========================================\n\n";
+
+    for (size_t index = 0; index < feedback_arcs.edges.size(); ++index) {
+        const auto& edge = feedback_arcs.edges[index];
+        os << (index + 1) << ". " << edge.from_target << " → " << edge.to_target << "\n";
+        os << "   代价: " << edge.cost << " · 分量规模: " << edge.component_size << " · " << edge.reason << "\n";
+    }
+}
+
+void OutputReport::GenerateFeedbackArcMarkdownReport(
+    const FeedbackArcSetAnalysis& feedback_arcs,
+    std::ostream& os) const {
+    os << "# 打破循环的最小边集\n\n";
+    os << "- **生成时间**: " << GetCurrentTimestamp() << "\n";
+    os << "- **边数**: " << feedback_arcs.edges.size() << " (可直接删除 " << feedback_arcs.removable_edges << ")\n";
+    os << "- **总代价**: " << feedback_arcs.total_cost << "\n";
+    os << "- **涉及强连通分量**: " << feedback_arcs.cyclic_components << "\n\n";
+
+    if (feedback_arcs.edges.empty()) {
+        os << "未发现循环依赖\n";
+        return;
+    }
+
+    os << "删除下表中的全部依赖后，依赖图不再有环。\n\n";
+    os << "| # | 依赖 | 代价 | 分量规模 | 说明 |\n";
+    os << "|---|---|---|---|---|\n";
+    for (size_t index = 0; index < feedback_arcs.edges.size(); ++index) {
+        const auto& edge = feedback_arcs.edges[index];
+        os << "| " << (index + 1) << " | `" << edge.from_target << "` → `" << edge.to_target << "` | "
+           << edge.cost << " | " << edge.component_size << " | " << edge.reason << " |\n";
+    }
+}
+
+void OutputReport::GenerateFeedbackArcJsonReport(
+    const FeedbackArcSetAnalysis& feedback_arcs,
+    std::ostream& os) const {
+    os << "{\n";
+    os << "  \"report\": {\n";
+    os << "    \"timestamp\": \"" << EscapeJsonString(GetCurrentTimestamp()) << "\",\n";
+    os << "    \"mode\": \"fas\",\n";
+    os << "    \"total_edges\": " << feedback_arcs.edges.size() << ",\n";
+    os << "    \"removable_edges\": " << feedback_arcs.removable_edges << ",\n";
+    os << "    \"total_cost\": " << feedback_arcs.total_cost << ",\n";
+    os << "    \"cyclic_components\": " << feedback_arcs.cyclic_components << ",\n";
+    os << "    \"edges\": [\n";
+
+    for (size_t index = 0; index < feedback_arcs.edges.size(); ++index) {
+        const auto& edge = feedback_arcs.edges[index];
+        os << "      {\n";
+        os << "        \"rank\": " << (index + 1) << ",\n";
+        os << "        \"from\": \"" << EscapeJsonString(edge.from_target) << "\",\n";
+        os << "        \"to\": \"" << EscapeJsonString(edge.to_target) << "\",\n";
+        os << "        \"cost\": " << edge.cost << ",\n";
+        os << "        \"removable\": " << (edge.removable ? "true" : "false") << ",\n";
+        os << "        \"component_size\": " << edge.component_size << ",\n";
+        os << "        \"reason\": \"" << EscapeJsonString(edge.reason) << "\"\n";
+        os << "      }";
+        if (index + 1 < feedback_arcs.edges.size()) {
+            os << ",";
+        }
+        os << "\n";
+    }
+
+    os << "    ]\n";
+    os << "  }\n";
+    os << "}\n";
+}
+
+void OutputReport::GenerateFeedbackArcHtmlReport(
+    const FeedbackArcSetAnalysis& feedback_arcs,
+    std::ostream& os) const {
+    WriteHtmlDocumentStart(os, "打破循环的最小边集");
+    WriteHtmlHeader(os,
+                    "打破循环的最小边集",
+                    {{"生成时间", GetCurrentTimestamp()},
+                     {"边数", std::to_string(feedback_arcs.edges.size())}});
+
+    os << "  <section class=\"panel\">\n";
+    os << "    <div class=\"panel-header\">\n";
+    os << "      <h2>概览</h2>\n";
+    os << "      <p>删除下列全部依赖后依赖图不再有环；源码未引用的依赖代价最低，排在前面。</p>\n";
+    os << "    </div>\n";
+    os << "    <div class=\"metric-grid\">\n";
+    WriteHtmlMetricCard(os, "边数", std::to_string(feedback_arcs.edges.size()), "danger");
+    WriteHtmlMetricCard(os, "可直接删除", std::to_string(feedback_arcs.removable_edges), "success");
+    WriteHtmlMetricCard(os, "总代价", std::to_string(feedback_arcs.total_cost));
+    WriteHtmlMetricCard(os, "强连通分量", std::to_string(feedback_arcs.cyclic_components));
+    os << "    </div>\n";
+    os << "  </section>\n";
+
+    if (feedback_arcs.edges.empty()) {
+        os << "  <section class=\"panel empty-state\">\n";
+        os << "    <h2>没有发现循环依赖</h2>\n";
+        os << "    <p>当前工作区未检测到循环链路。</p>\n";
+        os << "  </section>\n";
+        WriteHtmlDocumentEnd(os);
+        return;
+    }
+
+    os << "  <section class=\"panel\">\n";
+    os << "    <div class=\"panel-header\">\n";
+    os << "      <h2>待删除的依赖</h2>\n";
+    os << "      <p>按删除代价从低到高排列。</p>\n";
+    os << "    </div>\n";
+    os << "    <div class=\"stack-list\">\n";
+    for (size_t index = 0; index < feedback_arcs.edges.size(); ++index) {
+        const auto& edge = feedback_arcs.edges[index];
+        os << "      <article class=\"item-card" << (edge.removable ? " tone-success" : " tone-warning") << "\">\n";
+        os << "        <div class=\"item-main\">\n";
+        os << "          <h3>" << (index + 1) << ". "
+           << EscapeHtmlString(edge.from_target + " → " + edge.to_target) << "</h3>\n";
+        os << "          <p class=\"muted\">代价 " << edge.cost << " · 分量规模 " << edge.component_size << " · "
+           << EscapeHtmlString(edge.reason) << "</p>\n";
+        os << "        </div>\n";
+        os << "      </article>\n";
+    }
+    os << "    </div>\n";
+    os << "  </section>\n";
+    WriteHtmlDocumentEnd(os);
+}
+
+void OutputReport::GenerateTransitiveReductionConsoleReport(
+    const TransitiveReductionAnalysis& reduction,
+    std::ostream& os) const {
+    if (reduction.edges.empty()) {
+        os << "未发现冗余依赖边\n";
+        return;
+    }
+
+    os << "========================================\n";
+    os << "   传递约简：冗余依赖边\n";
+    os << "   生成时间: " << GetCurrentTimestamp() << "\n";
+    os << "   冗余边: " << reduction.edges.size() << " / " << reduction.total_edges << "\n";
+    os << "   可删除: " << reduction.safe_to_drop << " · strict deps 下需保留: " << reduction.keep_for_strict_deps
+       << "\n";
+    os << "========================================\n\n";
+
+    for (size_t index = 0; index < reduction.edges.size(); ++index) {
+        const auto& edge = reduction.edges[index];
+        os << (index + 1) << ". " << edge.from_target << " → " << edge.to_target << "\n";
+        os << "   经由: " << edge.via_target << " · " << edge.reason << "\n";
+    }
+}
+
+void OutputReport::GenerateTransitiveReductionMarkdownReport(
+    const TransitiveReductionAnalysis& reduction,
+    std::ostream& os) const {
+    os << "# 传递约简：冗余依赖边\n\n";
+    os << "- **生成时间**: " << GetCurrentTimestamp() << "\n";
+    os << "- **冗余边**: " << reduction.edges.size() << " / " << reduction.total_edges << "\n";
+    os << "- **可删除**: " << reduction.safe_to_drop << "\n";
+    os << "- **strict deps 下需保留**: " << reduction.keep_for_strict_deps << "\n\n";
+
+    if (reduction.edges.empty()) {
+        os << "未发现冗余依赖边\n";
+        return;
+    }
+
+    os << "下表中的依赖已能经由另一个直接依赖传递得到，删除后依赖关系不变。\n\n";
+    os << "| # | 依赖 | 经由 | 可删除 | 说明 |\n";
+    os << "|---|---|---|---|---|\n";
+    for (size_t index = 0; index < reduction.edges.size(); ++index) {
+        const auto& edge = reduction.edges[index];
+        os << "| " << (index + 1) << " | `" << edge.from_target << "` → `" << edge.to_target << "` | `"
+           << edge.via_target << "` | " << (edge.used_directly ? "否" : "是") << " | " << edge.reason << " |\n";
+    }
+}
+
+void OutputReport::GenerateTransitiveReductionJsonReport(
+    const TransitiveReductionAnalysis& reduction,
+    std::ostream& os) const {
+    os << "{\n";
+    os << "  \"transitive_reduction_report\": {\n";
+    os << "    \"timestamp\": \"" << EscapeJsonString(GetCurrentTimestamp()) << "\",\n";
+    os << "    \"total_edges\": " << reduction.total_edges << ",\n";
+    os << "    \"redundant_edges\": " << reduction.edges.size() << ",\n";
+    os << "    \"safe_to_drop\": " << reduction.safe_to_drop << ",\n";
+    os << "    \"keep_for_strict_deps\": " << reduction.keep_for_strict_deps << ",\n";
+    os << "    \"edges\": [\n";
+
+    for (size_t index = 0; index < reduction.edges.size(); ++index) {
+        const auto& edge = reduction.edges[index];
+        os << "      {\n";
+        os << "        \"from\": \"" << EscapeJsonString(edge.from_target) << "\",\n";
+        os << "        \"to\": \"" << EscapeJsonString(edge.to_target) << "\",\n";
+        os << "        \"via\": \"" << EscapeJsonString(edge.via_target) << "\",\n";
+        os << "        \"safe_to_drop\": " << (edge.used_directly ? "false" : "true") << ",\n";
+        os << "        \"reason\": \"" << EscapeJsonString(edge.reason) << "\"\n";
+        os << "      }";
+        if (index + 1 < reduction.edges.size()) {
+            os << ",";
+        }
+        os << "\n";
+    }
+
+    os << "    ]\n";
+    os << "  }\n";
+    os << "}\n";
+}
+
+void OutputReport::GenerateTransitiveReductionHtmlReport(
+    const TransitiveReductionAnalysis& reduction,
+    std::ostream& os) const {
+    WriteHtmlDocumentStart(os, "传递约简：冗余依赖边");
+    WriteHtmlHeader(os,
+                    "传递约简：冗余依赖边",
+                    {{"生成时间", GetCurrentTimestamp()},
+                     {"冗余边", std::to_string(reduction.edges.size())}});
+
+    os << "  <section class=\"panel\">\n";
+    os << "    <div class=\"panel-header\">\n";
+    os << "      <h2>概览</h2>\n";
+    os << "      <p>冗余边已能经由另一个直接依赖传递得到；源码未直接引用的可以删除，直接引用的在 strict deps 下需保留。</p>\n";
+    os << "    </div>\n";
+    os << "    <div class=\"metric-grid\">\n";
+    WriteHtmlMetricCard(os, "冗余边", std::to_string(reduction.edges.size()), "warning");
+    WriteHtmlMetricCard(os, "可删除", std::to_string(reduction.safe_to_drop), "success");
+    WriteHtmlMetricCard(os, "需保留", std::to_string(reduction.keep_for_strict_deps));
+    WriteHtmlMetricCard(os, "cc 依赖边", std::to_string(reduction.total_edges));
+    os << "    </div>\n";
+    os << "  </section>\n";
+
+    if (reduction.edges.empty()) {
+        os << "  <section class=\"panel empty-state\">\n";
+        os << "    <h2>没有发现冗余依赖边</h2>\n";
+        os << "    <p>每条 cc 依赖都无法由其他直接依赖传递得到。</p>\n";
+        os << "  </section>\n";
+        WriteHtmlDocumentEnd(os);
+        return;
+    }
+
+    os << "  <section class=\"panel\">\n";
+    os << "    <div class=\"panel-header\">\n";
+    os << "      <h2>冗余依赖边</h2>\n";
+    os << "      <p>可删除的排在前面。</p>\n";
+    os << "    </div>\n";
+    os << "    <div class=\"stack-list\">\n";
+    for (size_t index = 0; index < reduction.edges.size(); ++index) {
+        const auto& edge = reduction.edges[index];
+        os << "      <article class=\"item-card" << (edge.used_directly ? " tone-warning" : " tone-success") << "\">\n";
+        os << "        <div class=\"item-main\">\n";
+        os << "          <h3>" << (index + 1) << ". "
+           << EscapeHtmlString(edge.from_target + " → " + edge.to_target) << "</h3>\n";
+        os << "          <p class=\"muted\">经由 " << EscapeHtmlString(edge.via_target) << " · "
+           << EscapeHtmlString(edge.reason) << "</p>\n";
+        os << "        </div>\n";
+        os << "      </article>\n";
+    }
+    os << "    </div>\n";
+    os << "  </section>\n";
+    WriteHtmlDocumentEnd(os);
+}
+
 void OutputReport::GenerateBuildTimeConsoleReport(
     const bazel_analyzer::AnalysisResult& result,
     std::ostream& os) const {
@@ -17,17 +17,31 @@ public:
     std::string RenderCycleReport(
         const std::vector<CycleAnalysis>& cycles,
         const OutputFormat& format) const;
+    // SCC 报告模式：按强连通分量汇总
+    std::string RenderCycleReport(
+        const std::vector<ComponentAnalysis>& components,
+        const OutputFormat& format) const;
+    // FAS 报告模式：打破全部循环的边集
+    std::string RenderCycleReport(
+        const FeedbackArcSetAnalysis& feedback_arcs,
+        const OutputFormat& format) const;
     std::string RenderUnusedDependenciesReport(
         const std::vector<RemovableDependency>& unused_dependencies,
         const OutputFormat& format) const;
+    std::string RenderTransitiveReductionReport(
+        const TransitiveReductionAnalysis& reduction,
+        const OutputFormat& format) const;
     std::string RenderBuildTimeReport(
         const bazel_analyzer::AnalysisResult& result,
         const OutputFormat& format) const;
 
     void GenerateCycleReport(const std::vector<CycleAnalysis>& cycles, const OutputFormat& format) const;
+    void GenerateCycleReport(const std::vector<ComponentAnalysis>& components, const OutputFormat& format) const;
+    void GenerateCycleReport(const FeedbackArcSetAnalysis& feedback_arcs, const OutputFormat& format) const;
     void GenerateUnusedDependenciesReport(
         const std::vector<RemovableDependency>& unused_dependencies,
         const OutputFormat& format) const;
+    void GenerateTransitiveReductionReport(const TransitiveReductionAnalysis& reduction, const OutputFormat& format) const;
     void GenerateBuildTimeReport(
         const bazel_analyzer::AnalysisResult& result,
         const OutputFormat& format) const;
@@ -37,10 +51,22 @@ private:
         const std::vector<CycleAnalysis>& cycles,
         const OutputFormat& format,
         std::ostream& output_stream) const;
+    void GenerateCycleReport(
+        const std::vector<ComponentAnalysis>& components,
+        const OutputFormat& format,
+        std::ostream& output_stream) const;
+    void GenerateCycleReport(
+        const FeedbackArcSetAnalysis& feedback_arcs,
+        const OutputFormat& format,
+        std::ostream& output_stream) const;
     void GenerateUnusedDependenciesReport(
         const std::vector<RemovableDependency>& unused_dependencies,
         const OutputFormat& format,
         std::ostream& output_stream) const;
+    void GenerateTransitiveReductionReport(
+        const TransitiveReductionAnalysis& reduction,
+        const OutputFormat& format,
+        std::ostream& output_stream) const;
     void GenerateBuildTimeReport(
         const bazel_analyzer::AnalysisResult& result,
         const OutputFormat& format,
@@ -51,6 +77,21 @@ private:
     void GenerateCycleJsonReport(const std::vector<CycleAnalysis>& cycles, std::ostream& os) const;
     void GenerateCycleHtmlReport(const std::vector<CycleAnalysis>& cycles, std::ostream& os) const;
 
+    void GenerateComponentConsoleReport(const std::vector<ComponentAnalysis>& components, std::ostream& os) const;
+    void GenerateComponentMarkdownReport(const std::vector<ComponentAnalysis>& components, std::ostream& os) const;
+    void GenerateComponentJsonReport(const std::vector<ComponentAnalysis>& components, std::ostream& os) const;
+    void GenerateComponentHtmlReport(const std::vector<ComponentAnalysis>& components, std::ostream& os) const;
+
+    void GenerateFeedbackArcConsoleReport(const FeedbackArcSetAnalysis& feedback_arcs, std::ostream& os) const;
+    void GenerateFeedbackArcMarkdownReport(const FeedbackArcSetAnalysis& feedback_arcs, std::ostream& os) const;
+    void GenerateFeedbackArcJsonReport(const FeedbackArcSetAnalysis& feedback_arcs, std::ostream& os) const;
+    void GenerateFeedbackArcHtmlReport(const FeedbackArcSetAnalysis& feedback_arcs, std::ostream& os) const;
+
+    void GenerateTransitiveReductionConsoleReport(const TransitiveReductionAnalysis& reduction, std::ostream& os) const;
+    void GenerateTransitiveReductionMarkdownReport(const TransitiveReductionAnalysis& reduction, std::ostream& os) const;
+    void GenerateTransitiveReductionJsonReport(const TransitiveReductionAnalysis& reduction, std::ostream& os) const;
+    void GenerateTransitiveReductionHtmlReport(const TransitiveReductionAnalysis& reduction, std::ostream& os) const;
+
     void GenerateUnusedDependenciesConsoleReport(
         const std::vector<RemovableDependency>& unused_dependencies,
         std::ostream& os) const;
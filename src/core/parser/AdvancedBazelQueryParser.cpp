@@ -1,10 +1,15 @@
 #include "AdvancedBazelQueryParser.h"
-#include "pipe.h"
+#include "BuildFileReader.h"
+#include "WorkspaceSnapshot.h"
+#include "WorkspaceWatcher.h"
+#include "process/ProcessEngine.h"
+#include <chrono>
 #include <filesystem>
 #include <future>
 #include <mutex>
 #include <functional>
 #include <memory>
+#include <set>
 #include <vector>
 
 namespace fs = std::filesystem;
@@ -13,9 +18,92 @@ namespace {
 
 struct ParsedWorkspaceCacheEntry {
     std::shared_ptr<std::unordered_map<std::string, BazelTarget>> targets;
-    std::string fingerprint;
+    WorkspaceManifest manifest;
 };
 
+// 单次增量查询最多合并的包数，避免命令行过长
+constexpr size_t kMaxPackagesPerQuery = 200;
+
+// bazel 命令超时：卡死的查询会被终止，而不是永久占住 --ui 服务的工作线程
+constexpr std::chrono::minutes kBazelQueryTimeout{30};
+constexpr std::chrono::minutes kBazelProbeTimeout{2};
+
+// 回退路径批量查询：每次调用合并 K 个 label，K 按观测到的耗时与输出量自适应
+constexpr size_t kInitialTargetsPerQuery = 16;
+constexpr size_t kMaxTargetsPerQuery = 4096;
+// 单个 argv 参数在 Linux 上限制为 128KB（MAX_ARG_STRLEN），留出余量
+constexpr size_t kMaxQueryExpressionBytes = 96 * 1024;
+// 每次调用的目标耗时：快于一半则加倍 K，慢于两倍则减半
+constexpr std::chrono::seconds kTargetQueryLatency{5};
+// 单次输出超过该值时缩小 K，限制解析时的峰值内存
+constexpr size_t kMaxQueryOutputBytes = 64 * 1024 * 1024;
+
+// 自适应批大小：以 bazel 调用的实际耗时和输出量调整下一批的 label 数
+class AdaptiveQueryBatch {
+public:
+    // 从 begin 开始取下一批，返回批尾下标（同时受命令行长度限制）
+    size_t NextEnd(const std::vector<std::string>& labels, size_t begin) const {
+        size_t end = begin;
+        size_t expression_bytes = 0;
+        while (end < labels.size() && end - begin < size_) {
+            expression_bytes += labels[end].size() + 3;
+            if (end > begin && expression_bytes > kMaxQueryExpressionBytes) {
+                break;
+            }
+            ++end;
+        }
+        return end;
+    }
+
+    void Observe(size_t count, std::chrono::steady_clock::duration elapsed, size_t output_bytes) {
+        if (output_bytes > kMaxQueryOutputBytes || elapsed > kTargetQueryLatency * 2) {
+            Shrink();
+        } else if (count >= size_ && elapsed * 2 < kTargetQueryLatency &&
+                   output_bytes * 2 < kMaxQueryOutputBytes) {
+            size_ = std::min(kMaxTargetsPerQuery, size_ * 2);
+        }
+    }
+
+    void Shrink() { size_ = std::max<size_t>(1, size_ / 2); }
+
+    size_t Size() const { return size_; }
+
+private:
+    size_t size_{kInitialTargetsPerQuery};
+};
+
+// set("//a:x" "//b:y" ...)：label 逐个加引号，避免 '-'、'+' 等字符被当作查询运算符
+std::string BuildLabelSetExpression(const std::vector<std::string>& labels, size_t begin, size_t end) {
+    std::string expression = "set(";
+    for (size_t index = begin; index < end; ++index) {
+        if (index > begin) {
+            expression += ' ';
+        }
+        expression += '"';
+        expression += labels[index];
+        expression += '"';
+    }
+    expression += ')';
+    return expression;
+}
+
+// 取 stderr 末尾若干行用于日志
+std::string TailLines(const std::string& text, size_t max_lines) {
+    size_t pos = text.size();
+    while (pos > 0 && (text[pos - 1] == '\n' || text[pos - 1] == '\r')) {
+        --pos;
+    }
+    const size_t end = pos;
+    size_t lines = 0;
+    while (pos > 0) {
+        if (text[pos - 1] == '\n' && ++lines == max_lines) {
+            break;
+        }
+        --pos;
+    }
+    return text.substr(pos, end - pos);
+}
+
 std::mutex& GetParsedWorkspaceCacheMutex() {
     static std::mutex mutex;
     return mutex;
@@ -26,54 +114,62 @@ std::unordered_map<std::string, ParsedWorkspaceCacheEntry>& GetParsedWorkspaceCa
     return cache;
 }
 
-std::string BuildWorkspaceFingerprint(const std::string& workspace_path) {
-    fs::path workspace(workspace_path);
-    if (!fs::exists(workspace) || !fs::is_directory(workspace)) {
-        return "missing";
-    }
+std::string BuildParserCacheKey(const std::string& workspace_path,
+                                const std::string& bazel_binary,
+                                ParseStrategy strategy) {
+    return workspace_path + '\n' + bazel_binary + '\n' +
+           (strategy == ParseStrategy::BUILD_FILE_READER ? "build-files" : "query");
+}
 
-    uintmax_t file_count = 0;
-    long long latest_write = 0;
-    auto update_from_path = [&](const fs::path& path) {
-        std::error_code ec;
-        const auto time = fs::last_write_time(path, ec);
-        if (ec) {
-            return;
-        }
-        const auto raw = time.time_since_epoch().count();
-        if (raw > latest_write) {
-            latest_write = raw;
-        }
-        ++file_count;
-    };
+// 磁盘快照跨进程复用：同一个相对路径在不同 cwd 下指向不同工作区，因此额外带上绝对路径
+std::string BuildSnapshotKey(const std::string& workspace_path,
+                             const std::string& bazel_binary,
+                             ParseStrategy strategy) {
+    std::error_code ec;
+    const fs::path absolute_path = fs::weakly_canonical(fs::absolute(workspace_path, ec), ec);
+    return absolute_path.string() + '\n' + BuildParserCacheKey(workspace_path, bazel_binary, strategy);
+}
 
-    for (const auto& name : {"WORKSPACE", "WORKSPACE.bazel", "MODULE.bazel"}) {
-        fs::path path = workspace / name;
-        if (fs::exists(path)) {
-            update_from_path(path);
-        }
-    }
+// bazel 混入 stdout 的进度/提示行
+bool IsBazelNoiseLine(std::string_view line) {
+    return line.find("Loading:") != std::string_view::npos ||
+           line.find("INFO:") != std::string_view::npos;
+}
 
-    std::error_code ec;
-    for (fs::recursive_directory_iterator it(workspace, ec), end; it != end; it.increment(ec)) {
-        if (ec) {
-            break;
+// --output=label_kind 的一行："<kind> <rule|file> <label>"，字段均为原行上的视图
+struct LabelKindFields {
+    std::string_view kind;
+    std::string_view type;
+    std::string_view label;
+};
+
+bool SplitLabelKindLine(std::string_view line, LabelKindFields& fields) {
+    std::string_view* slots[] = {&fields.kind, &fields.type, &fields.label};
+    size_t pos = 0;
+    for (std::string_view* slot : slots) {
+        while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r')) {
+            ++pos;
         }
-        if (!it->is_regular_file()) {
-            continue;
+        const size_t start = pos;
+        while (pos < line.size() && line[pos] != ' ' && line[pos] != '\t' && line[pos] != '\r') {
+            ++pos;
         }
-
-        const std::string filename = it->path().filename().string();
-        if (filename == "BUILD" || filename == "BUILD.bazel") {
-            update_from_path(it->path());
+        if (pos == start) {
+            return false;
         }
+        *slot = line.substr(start, pos - start);
     }
-
-    return std::to_string(file_count) + ":" + std::to_string(latest_write);
+    return true;
 }
 
-std::string BuildParserCacheKey(const std::string& workspace_path, const std::string& bazel_binary) {
-    return workspace_path + '\n' + bazel_binary;
+std::string_view TrimLineView(std::string_view line) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) {
+        line.remove_suffix(1);
+    }
+    while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) {
+        line.remove_prefix(1);
+    }
+    return line;
 }
 
 }  // namespace
@@ -81,6 +177,7 @@ std::string BuildParserCacheKey(const std::string& workspace_path, const std::st
 void AdvancedBazelQueryParser::ClearWorkspaceCache() {
     std::lock_guard<std::mutex> lock(GetParsedWorkspaceCacheMutex());
     GetParsedWorkspaceCache().clear();
+    WorkspaceSnapshot::ClearAll();
 }
 
 size_t AdvancedBazelQueryParser::GetWorkspaceCacheSize() {
@@ -88,77 +185,185 @@ size_t AdvancedBazelQueryParser::GetWorkspaceCacheSize() {
     return GetParsedWorkspaceCache().size();
 }
 
+size_t AdvancedBazelQueryParser::GetWorkspaceSnapshotCount() {
+    return WorkspaceSnapshot::Count();
+}
+
 AdvancedBazelQueryParser::AdvancedBazelQueryParser(
-    const std::string& workspace_path, const std::string& bazel_binary)
-    : workspace_path(workspace_path), bazel_binary(bazel_binary) {
-    original_dir = fs::current_path().string();
-    query_etr_command = " --keep_going --incompatible_disallow_empty_glob=false ";
+    const std::string& workspace_path, const std::string& bazel_binary, ParseStrategy strategy)
+    : workspace_path(workspace_path), bazel_binary(bazel_binary), strategy(strategy) {
+    // bazel 子进程在工作区目录中启动；本进程 cwd 不变，不同工作区可以并发解析
+    std::error_code ec;
+    if (!workspace_path.empty() && fs::is_directory(workspace_path, ec)) {
+        command_directory = workspace_path;
+    }
+    query_extra_args = {"--keep_going", "--incompatible_disallow_empty_glob=false"};
 }
 
 std::unordered_map<std::string, BazelTarget> AdvancedBazelQueryParser::ParseWorkspace() {
-    std::unordered_map<std::string, BazelTarget> targets;
-    const std::string cache_key = BuildParserCacheKey(workspace_path, bazel_binary);
-    const std::string fingerprint = BuildWorkspaceFingerprint(workspace_path);
+    const std::string cache_key = BuildParserCacheKey(workspace_path, bazel_binary, strategy);
+    const std::string snapshot_key = BuildSnapshotKey(workspace_path, bazel_binary, strategy);
 
+    // 上一次的解析结果：优先进程内缓存，其次上一次进程留下的磁盘快照
+    ParsedWorkspaceCacheEntry previous;
     {
         std::lock_guard<std::mutex> lock(GetParsedWorkspaceCacheMutex());
         auto& cache = GetParsedWorkspaceCache();
         auto it = cache.find(cache_key);
-        if (it != cache.end() && it->second.fingerprint == fingerprint && it->second.targets) {
-            LOG_INFO("Reusing cached parsed workspace targets");
-            return *it->second.targets;
+        if (it != cache.end() && it->second.targets) {
+            previous = it->second;
         }
     }
-    
-    try {
-        ChangeToWorkspaceDirectory();
-        
-        if (!ValidateBazelEnvironment()) {
-            throw std::runtime_error("Bazel environment validation failed");
+    bool from_snapshot = false;
+    if (!previous.targets) {
+        auto loaded = std::make_shared<std::unordered_map<std::string, BazelTarget>>();
+        if (WorkspaceSnapshot::Load(snapshot_key, *loaded, previous.manifest)) {
+            previous.targets = std::move(loaded);
+            from_snapshot = true;
         }
-        
-        // 优先尝试一次性查询
-        targets = ParseWithComprehensiveQuery();
-        
-    } catch (const std::exception& e) {
-        LOG_WARN("Comprehensive query failed: " + std::string(e.what()) +
-                 ", falling back to concurrent queries");
-        
-        // 回退到并发查询
-        targets = ParseWithConcurrentQueries();
     }
 
-    RestoreOriginalDirectory();
+    // --ui 模式下由 inotify watcher 增量维护清单，否则遍历工作区
+    const auto watcher = WorkspaceWatcher::Acquire(workspace_path);
+    const WorkspaceManifest manifest =
+        watcher ? watcher->CurrentManifest()
+                : WorkspaceManifest::Scan(workspace_path, previous.targets ? &previous.manifest : nullptr);
+
+    std::unordered_map<std::string, BazelTarget> targets;
+    bool parsed = false;
+    // 磁盘快照与本次结果完全一致时不再重写
+    bool snapshot_up_to_date = false;
+    if (previous.targets) {
+        const WorkspaceManifestDiff diff = manifest.DiffFrom(previous.manifest);
+        if (diff.Empty()) {
+            if (!from_snapshot && manifest == previous.manifest) {
+                LOG_INFO("Reusing cached parsed workspace targets");
+                return *previous.targets;
+            }
+            LOG_INFO(from_snapshot ? "Loaded parsed workspace targets from snapshot"
+                                   : "Reusing cached parsed workspace targets");
+            targets = *previous.targets;
+            parsed = true;
+            snapshot_up_to_date = from_snapshot && manifest == previous.manifest;
+        } else if (diff.global_changed) {
+            LOG_INFO("Global Bazel inputs changed, re-parsing the whole workspace");
+        } else {
+            try {
+                targets = *previous.targets;
+                parsed = ReparseChangedPackages(diff, manifest, targets);
+            } catch (const std::exception& e) {
+                LOG_WARN("Incremental package query failed: " + std::string(e.what()) +
+                         ", re-parsing the whole workspace");
+            }
+        }
+    }
+
+    if (!parsed && strategy == ParseStrategy::BUILD_FILE_READER) {
+        targets = ParseWithBuildFileReader(manifest);
+        parsed = true;
+    }
+
+    if (!parsed) {
+        try {
+            if (!ValidateBazelEnvironment()) {
+                throw std::runtime_error("Bazel environment validation failed");
+            }
+
+            // 优先尝试一次性查询：单次 bazel 调用输出全部 cc 规则
+            targets = ParseWithComprehensiveQuery();
+
+        } catch (const std::exception& e) {
+            LOG_WARN("Comprehensive query failed: " + std::string(e.what()) +
+                     ", falling back to concurrent queries");
+
+            // 最后的回退：逐 target 并发查询
+            targets = ParseWithConcurrentQueries();
+        }
+    }
+
+    if (!targets.empty() && !snapshot_up_to_date) {
+        WorkspaceSnapshot::Save(snapshot_key, manifest, targets);
+    }
 
     {
         std::lock_guard<std::mutex> lock(GetParsedWorkspaceCacheMutex());
         GetParsedWorkspaceCache()[cache_key] =
             ParsedWorkspaceCacheEntry{
                 std::make_shared<std::unordered_map<std::string, BazelTarget>>(targets),
-                fingerprint};
+                manifest};
     }
 
     return targets;
 }
 
-void AdvancedBazelQueryParser::ChangeToWorkspaceDirectory() {
-    if (!workspace_path.empty() && fs::exists(workspace_path)) {
-        fs::current_path(workspace_path);
-        LOG_INFO("Changed to workspace directory: " + workspace_path);
+bool AdvancedBazelQueryParser::ReparseChangedPackages(
+    const WorkspaceManifestDiff& diff,
+    const WorkspaceManifest& manifest,
+    std::unordered_map<std::string, BazelTarget>& targets) {
+    std::set<std::string> affected(diff.modified_packages.begin(), diff.modified_packages.end());
+
+    // 包的新增 / 删除会改变父包的边界（glob 结果随之变化），父包也需要重新查询
+    auto add_with_parent = [&](const std::string& package) {
+        affected.insert(package);
+        fs::path parent = fs::path(package).parent_path();
+        while (true) {
+            const std::string parent_package = parent.generic_string();
+            if (manifest.packages.count(parent_package) > 0) {
+                affected.insert(parent_package);
+                break;
+            }
+            if (parent_package.empty()) {
+                break;
+            }
+            parent = parent.parent_path();
+        }
+    };
+    for (const auto& package : diff.added_packages) {
+        add_with_parent(package);
+    }
+    for (const auto& package : diff.removed_packages) {
+        add_with_parent(package);
     }
-}
 
-void AdvancedBazelQueryParser::RestoreOriginalDirectory() {
-    fs::current_path(original_dir);
-    LOG_INFO("Restored original directory: " + original_dir);
+    // 变化面太大时整体查询更划算
+    if (affected.size() * 2 > manifest.packages.size()) {
+        LOG_INFO("Too many packages changed (" + std::to_string(affected.size()) +
+                 "), re-parsing the whole workspace");
+        return false;
+    }
+
+    for (auto it = targets.begin(); it != targets.end();) {
+        if (affected.count(WorkspaceManifest::PackageOfLabel(it->first)) > 0) {
+            it = targets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    std::vector<std::string> packages;
+    for (const auto& package : affected) {
+        if (manifest.packages.count(package) > 0) {
+            packages.push_back(package);
+        }
+    }
+
+    if (strategy == ParseStrategy::BUILD_FILE_READER) {
+        LOG_INFO("Re-reading " + std::to_string(packages.size()) + " changed packages");
+        ReadPackagesFromBuildFiles(packages, targets);
+        return true;
+    }
+
+    LOG_INFO("Re-querying " + std::to_string(packages.size()) + " changed packages");
+    QueryPackagesAsXml(packages, targets);
+    return true;
 }
 
 bool AdvancedBazelQueryParser::ValidateBazelEnvironment() {
     try {
-        std::string version_output = ExecuteBazelCommand("--version");
+        std::string version_output = ExecuteBazelCommand({"--version"});
         LOG_INFO("Bazel version: " + version_output);
         
-        std::string workspace_info = ExecuteBazelCommand("info workspace");
+        std::string workspace_info = ExecuteBazelCommand({"info", "workspace"});
         LOG_INFO("Workspace info: " + workspace_info);
         
         return true;
@@ -170,51 +375,218 @@ bool AdvancedBazelQueryParser::ValidateBazelEnvironment() {
 
 std::unordered_map<std::string, BazelTarget> AdvancedBazelQueryParser::ParseWithComprehensiveQuery() {
     std::unordered_map<std::string, BazelTarget> targets;
-    
-    std::string query = "query 'kind(\"cc_.* rule\", //...)' --output=label_kind" + query_etr_command;
-    std::string output = ExecuteBazelCommand(query);
-    
-    std::vector<std::string> lines = SplitLines(output);
-    
-    for (const auto& line : lines) {
-        if (line.empty()) continue;
-        
-        BazelTarget target = ParseTargetFromLabelKind(line);
-        if (target.empty()) {
-            continue;
-        }
 
-        QueryTargetDetails(target);
-        targets.insert({target.full_label, target});
+    // 一次 bazel 调用拿到所有 cc 规则及其 deps/srcs/hdrs 属性，避免逐 target 查询
+    const int exit_code = QueryCcRulesAsXml("//...", targets);
+    if (targets.empty() && exit_code != 0) {
+        throw std::runtime_error("bazel query failed without returning any targets (exit code " +
+                                 std::to_string(exit_code) + ")");
     }
-    
+
     LOG_INFO("Comprehensive query found " + std::to_string(targets.size()) + " targets");
     return targets;
 }
 
-BazelTarget AdvancedBazelQueryParser::ParseTargetFromLabelKind(const std::string& line) {
+std::unordered_map<std::string, BazelTarget> AdvancedBazelQueryParser::ParseWithBuildFileReader(
+    const WorkspaceManifest& manifest) {
+    std::unordered_map<std::string, BazelTarget> targets;
+    std::vector<std::string> packages;
+    packages.reserve(manifest.packages.size());
+    for (const auto& [package, _] : manifest.packages) {
+        packages.push_back(package);
+    }
+
+    ReadPackagesFromBuildFiles(packages, targets);
+    LOG_INFO("BUILD file reader found " + std::to_string(targets.size()) + " targets in " +
+             std::to_string(packages.size()) + " packages");
+    return targets;
+}
+
+void AdvancedBazelQueryParser::ReadPackagesFromBuildFiles(
+    const std::vector<std::string>& packages,
+    std::unordered_map<std::string, BazelTarget>& targets) {
+    if (packages.empty()) {
+        return;
+    }
+
+    const BuildFileReader reader(workspace_path);
+    const size_t worker_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+    const size_t batch_size = (packages.size() + worker_count - 1) / worker_count;
+    std::vector<std::future<std::vector<BuildFileReader::PackageResult>>> futures;
+
+    // 每个包相互独立，按批并行读取
+    for (size_t begin = 0; begin < packages.size(); begin += batch_size) {
+        const size_t end = std::min(packages.size(), begin + batch_size);
+        futures.push_back(std::async(std::launch::async, [&reader, &packages, begin, end]() {
+            std::vector<BuildFileReader::PackageResult> results;
+            results.reserve(end - begin);
+            for (size_t index = begin; index < end; ++index) {
+                results.push_back(reader.ReadPackage(packages[index]));
+            }
+            return results;
+        }));
+    }
+
+    std::vector<std::string> fallback_packages;
+    size_t package_index = 0;
+    for (auto& future : futures) {
+        for (auto& result : future.get()) {
+            const std::string& package = packages[package_index++];
+            if (!result.supported) {
+                LOG_DEBUG("BUILD file reader cannot evaluate //" + package + ": " + result.unsupported_reason);
+                fallback_packages.push_back(package);
+                continue;
+            }
+            for (auto& rule : result.rules) {
+                BazelTarget target = BuildTargetFromQueryRule(std::move(rule));
+                if (!target.empty()) {
+                    targets[target.full_label] = std::move(target);
+                }
+            }
+        }
+    }
+
+    if (fallback_packages.empty()) {
+        return;
+    }
+
+    // 含宏或无法求值构造的包交给 bazel query，合并成尽量少的调用
+    LOG_INFO("Falling back to bazel query for " + std::to_string(fallback_packages.size()) + " packages");
+    try {
+        QueryPackagesAsXml(fallback_packages, targets);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Fallback package query failed: " + std::string(e.what()));
+    }
+}
+
+void AdvancedBazelQueryParser::QueryPackagesAsXml(const std::vector<std::string>& packages,
+                                                  std::unordered_map<std::string, BazelTarget>& targets) {
+    for (size_t begin = 0; begin < packages.size(); begin += kMaxPackagesPerQuery) {
+        const size_t end = std::min(packages.size(), begin + kMaxPackagesPerQuery);
+        std::string scope;
+        for (size_t index = begin; index < end; ++index) {
+            if (!scope.empty()) {
+                scope += " + ";
+            }
+            scope += "//" + packages[index] + ":*";
+        }
+
+        const int exit_code = QueryCcRulesAsXml(scope, targets);
+        if (exit_code != 0) {
+            LOG_WARN("Package query exited with code " + std::to_string(exit_code) +
+                     ", results may be partial");
+        }
+    }
+}
+
+int AdvancedBazelQueryParser::QueryCcRulesAsXml(const std::string& scope,
+                                                std::unordered_map<std::string, BazelTarget>& targets) {
+    return QueryRulesAsXml("kind(\"cc_.* rule\", " + scope + ")", targets);
+}
+
+int AdvancedBazelQueryParser::QueryRulesAsXml(const std::string& expression,
+                                              std::unordered_map<std::string, BazelTarget>& targets,
+                                              size_t* output_bytes) {
+    // 输出边产生边解析，不在内存中保留完整 XML
+    const std::vector<std::string> query = BuildQueryArgs(expression, "xml");
+
+    BazelQueryXmlReader reader([this, &targets](QueryRule&& rule) {
+        BazelTarget target = BuildTargetFromQueryRule(std::move(rule));
+        if (!target.empty()) {
+            targets[target.full_label] = std::move(target);
+        }
+    });
+    size_t bytes = 0;
+    const int exit_code = ExecuteBazelCommandStreaming(query, [&reader, &bytes](std::string_view line) {
+        bytes += line.size() + 1;
+        reader.ConsumeLine(line);
+    });
+    if (output_bytes != nullptr) {
+        *output_bytes = bytes;
+    }
+
+    if (!reader.SawQueryRoot()) {
+        throw std::runtime_error("bazel query did not produce XML output");
+    }
+    return exit_code;
+}
+
+BazelTarget AdvancedBazelQueryParser::BuildTargetFromQueryRule(QueryRule&& rule) {
     BazelTarget target;
-    
-    std::istringstream iss(line);
-    std::string rule_type, rule_word, target_label;
-    
-    if (iss >> rule_type >> rule_word >> target_label) {
-        target.rule_type = rule_type;
-        
-        // 解析目标标签
-        size_t last_colon = target_label.find_last_of(':');
-        if (last_colon != std::string::npos) {
-            target.name = target_label.substr(last_colon + 1);
-            std::string target_path = target_label.substr(0, last_colon);
-            
-            target.path = ConvertBazelLabelToPath(target_path);
-        } else {
-            target.path = ConvertBazelLabelToPath(target_label);
-            target.name = target_label;
+    target.full_label = std::move(rule.label);
+    target.rule_type = rule.rule_class.empty() ? "unknown" : std::move(rule.rule_class);
+
+    size_t last_colon = target.full_label.find_last_of(':');
+    if (last_colon != std::string::npos) {
+        target.name = target.full_label.substr(last_colon + 1);
+        target.path = ConvertBazelLabelToPath(target.full_label.substr(0, last_colon));
+    } else {
+        target.name = target.full_label;
+        target.path = ConvertBazelLabelToPath(target.full_label);
+    }
+
+    target.deps.reserve(rule.deps.size());
+    for (auto& dep : rule.deps) {
+        if (dep.empty() || dep == target.full_label) {
+            continue;
         }
+#ifndef CHECK_EXTERN_DEPS
+        if (dep.find("@") == 0) {
+            continue;
+        }
+#endif // CHECK_EXTERN_DEPS
+        target.deps.push_back(std::move(dep));
+    }
+
+    for (const auto& src : rule.srcs) {
+        AppendFileLabel(target, src);
+    }
+    for (const auto& hdr : rule.hdrs) {
+        AppendFileLabel(target, hdr);
+    }
+
+    return target;
+}
+
+void AdvancedBazelQueryParser::AppendFileLabel(BazelTarget& target, const std::string& label) {
+    std::string file_path = ConvertBazelLabelToPath(label);
+    if (file_path.empty()) {
+        return;
+    }
+
+    auto lower_ext_pos = file_path.find_last_of('.');
+    std::string ext = (lower_ext_pos != std::string::npos)
+                          ? file_path.substr(lower_ext_pos)
+                          : "";
+
+    if (ext == ".h" || ext == ".hpp" || ext == ".hh" || ext == ".hxx") {
+        target.hdrs.push_back(std::move(file_path));
+    } else {
+        target.srcs.push_back(std::move(file_path));
     }
+}
+
+BazelTarget AdvancedBazelQueryParser::ParseTargetFromLabelKind(std::string_view line) {
+    BazelTarget target;
     
-    target.full_label = target_label;
+    LabelKindFields fields;
+    if (!SplitLabelKindLine(line, fields)) {
+        return target;
+    }
+
+    target.rule_type = std::string(fields.kind);
+    target.full_label = std::string(fields.label);
+
+    // 解析目标标签
+    const std::string_view target_label = fields.label;
+    size_t last_colon = target_label.find_last_of(':');
+    if (last_colon != std::string_view::npos) {
+        target.name = std::string(target_label.substr(last_colon + 1));
+        target.path = ConvertBazelLabelToPath(std::string(target_label.substr(0, last_colon)));
+    } else {
+        target.path = ConvertBazelLabelToPath(target.full_label);
+        target.name = target.full_label;
+    }
  
     return target;
 }
@@ -224,60 +596,42 @@ void AdvancedBazelQueryParser::QueryTargetDetails(BazelTarget& target) {
         std::string target_label = target.full_label.empty() ? 
             target.path + target.name : target.full_label;
         try {
-            std::string unified_query =
-                "query 'kind(\".* rule\", " + target_label + ") "
+            const std::vector<std::string> unified_query = BuildQueryArgs(
+                "kind(\".* rule\", " + target_label + ") "
                 "union kind(\".* rule\", deps(" + target_label + ", 1)) "
                 "union labels(srcs, " + target_label + ") "
-                "union labels(hdrs, " + target_label + ")' "
-                "--output=label_kind" + query_etr_command;
-
-            std::string unified_output = ExecuteBazelCommand(unified_query);
-            std::vector<std::string> lines = SplitLines(unified_output);
+                "union labels(hdrs, " + target_label + ")",
+                "label_kind");
 
-            for (const auto& line : lines) {
-                if (line.empty()) continue;
-
-                std::istringstream iss(line);
-                std::string kind_word;
-                std::string type_word;
-                std::string label;
+            ExecuteBazelCommandStreaming(unified_query, [this, &target, &target_label](std::string_view raw_line) {
+                const std::string_view line = TrimLineView(raw_line);
+                if (line.empty() || IsBazelNoiseLine(line)) {
+                    return;
+                }
 
-                if (!(iss >> kind_word >> type_word >> label)) {
-                    continue;
+                LabelKindFields fields;
+                if (!SplitLabelKindLine(line, fields)) {
+                    return;
                 }
 
-                if (type_word == "rule") {
-                    if (label == target_label) {
+                if (fields.type == "rule") {
+                    if (fields.label == target_label) {
                         if (target.rule_type.empty()) {
-                            target.rule_type = kind_word;
+                            target.rule_type = std::string(fields.kind);
                         }
-                        continue;
+                        return;
                     }
 
 #ifndef CHECK_EXTERN_DEPS
-                    if (!label.empty() && label.find("@") != 0) {
-                        target.deps.push_back(label);
+                    if (fields.label.front() != '@') {
+                        target.deps.emplace_back(fields.label);
                     }
 #endif // CHECK_EXTERN_DEPS
-                    continue;
+                    return;
                 }
 
-                std::string file_path = ConvertBazelLabelToPath(label);
-                if (file_path.empty()) {
-                    continue;
-                }
-
-                auto lower_ext_pos = file_path.find_last_of('.');
-                std::string ext = (lower_ext_pos != std::string::npos)
-                                      ? file_path.substr(lower_ext_pos)
-                                      : "";
-
-                if (ext == ".h" || ext == ".hpp" || ext == ".hh" || ext == ".hxx") {
-                    target.hdrs.push_back(file_path);
-                } else {
-                    target.srcs.push_back(file_path);
-                }
-            }
+                AppendFileLabel(target, std::string(fields.label));
+            });
 
             // 未拿到规则类型
             if (target.rule_type.empty()) {
@@ -298,8 +652,7 @@ std::unordered_map<std::string, BazelTarget> AdvancedBazelQueryParser::ParseWith
     
     try {
         // 获取所有C++相关的目标，而不是所有目标，提高效率
-        std::string targets_output = ExecuteBazelCommand("query 'kind(\"cc_.* rule\", //...)' --output=label" + query_etr_command);
-        std::vector<std::string> target_labels = SplitLines(targets_output);
+        std::vector<std::string> target_labels = QueryLabelList(BuildQueryArgs("kind(\"cc_.* rule\", //...)", "label"));
         
         LOG_INFO("Found " + std::to_string(target_labels.size()) + " C++ targets to query individually");
         
@@ -354,8 +707,7 @@ std::unordered_map<std::string, BazelTarget> AdvancedBazelQueryParser::ParseWith
     
     try {
         // 获取所有C++相关的目标
-        std::string targets_output = ExecuteBazelCommand("query 'kind(\"cc_.* rule\", //...)' --output=label" + query_etr_command);
-        std::vector<std::string> target_labels = SplitLines(targets_output);
+        std::vector<std::string> target_labels = QueryLabelList(BuildQueryArgs("kind(\"cc_.* rule\", //...)", "label"));
         
         LOG_INFO("Found " + std::to_string(target_labels.size()) + " C++ targets to query concurrently");
         
@@ -373,56 +725,104 @@ std::unordered_map<std::string, BazelTarget> AdvancedBazelQueryParser::ParseWith
 
 void AdvancedBazelQueryParser::QueryTargetDetailsBatch(const std::vector<std::string>& target_labels,
                                                       std::unordered_map<std::string, BazelTarget>& targets) {
-    const size_t worker_count = std::max<size_t>(1, std::thread::hardware_concurrency());
-    const size_t batch_size = std::max<size_t>(1, std::min(target_labels.size(), worker_count * 4));
-    std::vector<std::future<std::vector<BazelTarget>>> futures;
-    
-    // 分批处理目标
-    for (size_t i = 0; i < target_labels.size(); i += batch_size) {
-        size_t end = std::min(i + batch_size, target_labels.size());
-        std::vector<std::string> batch(target_labels.begin() + i, target_labels.begin() + end);
-        
-        // 异步处理每个批次
-        futures.push_back(std::async(std::launch::async, [this, batch]() {
-            return ProcessTargetBatch(batch);
-        }));
-    }
-    
-    // 收集结果
-    std::mutex targets_mutex;
-    for (auto& future : futures) {
+    // bazel server 对查询串行加锁，并发调用只会互相等待；改为顺序执行合并查询，
+    // 每次用 XML 输出取得 K 个目标的规则属性，再按规则名拆回各个目标
+    AdaptiveQueryBatch batch;
+    std::vector<std::pair<size_t, size_t>> ranges;   // 待查询区间，失败时二分后压回
+    std::vector<std::string> single_labels;          // 需要逐个查询的 label
+    bool xml_available = true;
+    bool xml_seen = false;                           // 是否有批次成功输出过 XML
+    size_t invocations = 0;
+    size_t next = 0;
+
+    while (next < target_labels.size() || !ranges.empty()) {
+        if (ranges.empty()) {
+            const size_t end = batch.NextEnd(target_labels, next);
+            ranges.emplace_back(next, end);
+            next = end;
+        }
+        const auto [begin, end] = ranges.back();
+        ranges.pop_back();
+
+        if (!xml_available) {
+            single_labels.insert(single_labels.end(), target_labels.begin() + begin, target_labels.begin() + end);
+            continue;
+        }
+
+        std::unordered_map<std::string, BazelTarget> batch_targets;
+        size_t output_bytes = 0;
+        int exit_code = 0;
+        bool produced_xml = true;
+        const auto started = std::chrono::steady_clock::now();
         try {
-            auto batch_results = future.get();
-            {
-                std::lock_guard<std::mutex> lock(targets_mutex);
-                for (auto& target : batch_results) {
-                    if (!target.empty()) {
-                        targets[target.full_label] = std::move(target);
-                    }
-                }
-            }
+            ++invocations;
+            exit_code = QueryRulesAsXml(
+                "kind(\".* rule\", " + BuildLabelSetExpression(target_labels, begin, end) + ")",
+                batch_targets, &output_bytes);
         } catch (const std::exception& e) {
-            LOG_ERROR("Batch processing failed: " + std::string(e.what()));
+            LOG_DEBUG("Batched query of " + std::to_string(end - begin) + " targets failed: " + e.what());
+            produced_xml = false;
+            exit_code = -1;
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - started;
+        xml_seen = xml_seen || produced_xml;
+
+        // --keep_going 下个别坏目标只让退出码非零；结果缺目标时才需要重试
+        bool complete = produced_xml;
+        if (complete && exit_code != 0) {
+            for (size_t index = begin; index < end && complete; ++index) {
+                complete = batch_targets.count(target_labels[index]) > 0;
+            }
+        }
+
+        for (auto& [label, target] : batch_targets) {
+            targets[label] = std::move(target);
+        }
+
+        if (complete) {
+            batch.Observe(end - begin, elapsed, output_bytes);
+            continue;
+        }
+
+        batch.Shrink();
+        if (end - begin > 1) {
+            // 二分定位导致失败的目标，其余目标仍按批查询
+            const size_t middle = begin + (end - begin) / 2;
+            ranges.emplace_back(middle, end);
+            ranges.emplace_back(begin, middle);
+            continue;
+        }
+        if (targets.count(target_labels[begin]) > 0) {
+            continue;
+        }
+
+        ++invocations;
+        BazelTarget target = ProcessSingleTarget(target_labels[begin]);
+        // 从未拿到过 XML，而逐个查询却成功，说明 XML 输出本身不可用
+        if (!xml_seen && target.rule_type != "unknown") {
+            LOG_WARN("bazel query XML output unavailable, querying remaining targets one by one");
+            xml_available = false;
+        }
+        if (!target.empty()) {
+            targets[target.full_label] = std::move(target);
         }
     }
-}
 
-std::vector<BazelTarget> AdvancedBazelQueryParser::ProcessTargetBatch(const std::vector<std::string>& batch_labels) {
-    std::vector<BazelTarget> batch_results;
-    batch_results.reserve(batch_labels.size());
-    
-    for (const auto& label : batch_labels) {
+    for (const auto& label : single_labels) {
         try {
-            auto target = ProcessSingleTarget(label);
+            BazelTarget target = ProcessSingleTarget(label);
+            ++invocations;
             if (!target.empty()) {
-                batch_results.push_back(std::move(target));
+                targets[target.full_label] = std::move(target);
             }
         } catch (const std::exception& e) {
             LOG_ERROR("Failed to process target " + label + ": " + std::string(e.what()));
         }
     }
-    
-    return batch_results;
+
+    LOG_INFO("Queried " + std::to_string(target_labels.size()) + " targets with " +
+             std::to_string(invocations) + " bazel invocations (final batch size " +
+             std::to_string(batch.Size()) + ")");
 }
 
 BazelTarget AdvancedBazelQueryParser::ProcessSingleTarget(const std::string& label) {
@@ -451,8 +851,7 @@ BazelTarget AdvancedBazelQueryParser::ProcessSingleTarget(const std::string& lab
 std::unordered_map<std::string, BazelTarget> AdvancedBazelQueryParser::ParseAllTargetsFallback() {
     std::unordered_map<std::string, BazelTarget> targets;
     
-    std::string targets_output = ExecuteBazelCommand("query '//...' --output=label" + query_etr_command);
-    std::vector<std::string> target_labels = SplitLines(targets_output);
+    std::vector<std::string> target_labels = QueryLabelList(BuildQueryArgs("//...", "label"));
     
     LOG_INFO("Fallback: Found " + std::to_string(target_labels.size()) + " total targets to query");
     
@@ -501,8 +900,7 @@ std::unordered_map<std::string, BazelTarget> AdvancedBazelQueryParser::ParseAllT
 std::unordered_map<std::string, BazelTarget> AdvancedBazelQueryParser::ParseAllTargetsConcurrentFallback() {
     std::unordered_map<std::string, BazelTarget> targets;
     
-    std::string targets_output = ExecuteBazelCommand("query '//...' --output=label" + query_etr_command);
-    std::vector<std::string> target_labels = SplitLines(targets_output);
+    std::vector<std::string> target_labels = QueryLabelList(BuildQueryArgs("//...", "label"));
     
     LOG_INFO("Concurrent fallback: Found " + std::to_string(target_labels.size()) + " total targets to query");
     
@@ -522,22 +920,77 @@ std::unordered_map<std::string, BazelTarget> AdvancedBazelQueryParser::ParseAllT
     return targets;
 }
 
-std::string AdvancedBazelQueryParser::ExecuteBazelCommand(const std::string& command) {
-    std::string full_command = bazel_binary + " " + command;
-    LOG_DEBUG("Executing Bazel command: " + full_command);
-    
-    return PipeCommandExecutor::execute(full_command);
+std::vector<std::string> AdvancedBazelQueryParser::BuildQueryArgs(const std::string& expression,
+                                                                 const std::string& output) const {
+    std::vector<std::string> args = {"query", expression, "--output=" + output};
+    args.insert(args.end(), query_extra_args.begin(), query_extra_args.end());
+    return args;
+}
+
+ProcessRequest AdvancedBazelQueryParser::MakeBazelRequest(const std::vector<std::string>& args) const {
+    ProcessRequest request;
+    request.argv.reserve(args.size() + 1);
+    request.argv.push_back(bazel_binary);
+    request.argv.insert(request.argv.end(), args.begin(), args.end());
+    request.working_directory = command_directory;
+    return request;
+}
+
+std::string AdvancedBazelQueryParser::ExecuteBazelCommand(const std::vector<std::string>& args) {
+    ProcessRequest request = MakeBazelRequest(args);
+    request.timeout = kBazelProbeTimeout;
+    LOG_DEBUG("Executing Bazel command: " + bazel_binary + " " + args.front());
+
+    ProcessResult result = ProcessEngine::Instance().Run(std::move(request));
+    if (result.timed_out) {
+        throw std::runtime_error("bazel " + args.front() + " timed out");
+    }
+    if (result.exit_code != 0) {
+        LOG_WARN("bazel " + args.front() + " exited with code " + std::to_string(result.exit_code) +
+                 ": " + TailLines(result.stderr_text, 5));
+    }
+    return std::move(result.stdout_text);
+}
+
+int AdvancedBazelQueryParser::ExecuteBazelCommandStreaming(
+    const std::vector<std::string>& args,
+    const std::function<void(std::string_view)>& on_line) {
+    ProcessRequest request = MakeBazelRequest(args);
+    request.timeout = kBazelQueryTimeout;
+    request.on_stdout_line = on_line;
+    LOG_DEBUG("Executing Bazel command (streaming): " + bazel_binary + " " + args.front() +
+              (args.size() > 1 ? " " + args[1] : std::string()));
+
+    // stderr 单独收集：进度信息不再混入 stdout，失败时用于诊断
+    const ProcessResult result = ProcessEngine::Instance().Run(std::move(request));
+    if (result.timed_out) {
+        throw std::runtime_error("bazel " + args.front() + " timed out after " +
+                                 std::to_string(kBazelQueryTimeout.count()) + " minutes");
+    }
+    if (result.exit_code != 0) {
+        LOG_WARN("bazel " + args.front() + " exited with code " + std::to_string(result.exit_code) +
+                 ": " + TailLines(result.stderr_text, 5));
+    }
+    return result.term_signal != 0 ? -1 : result.exit_code;
+}
+
+std::vector<std::string> AdvancedBazelQueryParser::QueryLabelList(const std::vector<std::string>& args) {
+    std::vector<std::string> labels;
+    ExecuteBazelCommandStreaming(args, [&labels](std::string_view raw_line) {
+        const std::string_view line = TrimLineView(raw_line);
+        if (!line.empty() && !IsBazelNoiseLine(line)) {
+            labels.emplace_back(line);
+        }
+    });
+    return labels;
 }
 
 std::string AdvancedBazelQueryParser::ExtractRuleType(const std::string& kind_output) {
     std::vector<std::string> lines = SplitLines(kind_output);
     for (const auto& line : lines) {
-        std::istringstream iss(line);
-        std::string rule_type, rule_word, target_label;
-        if (iss >> rule_type >> rule_word >> target_label) {
-            if (rule_word == "rule") {
-                return rule_type;
-            }
+        LabelKindFields fields;
+        if (SplitLabelKindLine(line, fields) && fields.type == "rule") {
+            return std::string(fields.kind);
         }
     }
     return "unknown";
@@ -565,18 +1018,17 @@ std::vector<std::string> AdvancedBazelQueryParser::ExtractDependencies(const std
 
 std::vector<std::string> AdvancedBazelQueryParser::SplitLines(const std::string& input) {
     std::vector<std::string> lines;
-    std::istringstream iss(input);
-    std::string line;
+    std::string_view remaining(input);
     
-    while (std::getline(iss, line)) {
-        if(line.find("Loading:") != std::string::npos || 
-            line.find("INFO:") != std::string::npos ) {
-            continue;
-        }
+    while (!remaining.empty()) {
+        const size_t line_end = remaining.find('\n');
+        const std::string_view line = remaining.substr(0, line_end);
+        remaining = line_end == std::string_view::npos ? std::string_view() : remaining.substr(line_end + 1);
 
-        if (!line.empty()) {
-            lines.push_back(line);
+        if (line.empty() || IsBazelNoiseLine(line)) {
+            continue;
         }
+        lines.emplace_back(line);
     }
     
     return lines;
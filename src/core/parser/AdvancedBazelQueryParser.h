@@ -13,41 +13,65 @@
 #include <algorithm>
 #include <mutex>
 #include <functional>
+#include <string_view>
 
 #include "struct.h"
 #include "log/logger.h"
+#include "parser/BazelQueryXmlReader.h"
+#include "parser/WorkspaceManifest.h"
+#include "process/ProcessEngine.h"
 
 class AdvancedBazelQueryParser {
 public:
     AdvancedBazelQueryParser(const std::string& workspace_path,
-                           const std::string& bazel_binary = "bazel");
+                           const std::string& bazel_binary = "bazel",
+                           ParseStrategy strategy = ParseStrategy::BAZEL_QUERY);
     
     std::unordered_map<std::string, BazelTarget> ParseWorkspace();
     static void ClearWorkspaceCache();
     static size_t GetWorkspaceCacheSize();
+    static size_t GetWorkspaceSnapshotCount();
     
 private:
     // 配置相关
     std::string workspace_path;
     std::string bazel_binary;
-    std::string original_dir;
-    std::string query_etr_command;
+    std::string command_directory;               // bazel 子进程的工作目录（工作区不存在时为空）
+    std::vector<std::string> query_extra_args;   // 所有 bazel query 共用的附加参数
+    ParseStrategy strategy;
     
-    // 查询策略
-    enum class QueryStrategy {
-        COMPREHENSIVE,  // 一次性查询
-        CONCURRENT      // 并发查询（新的策略）
-    };
-    
-    // 主要查询实现
+    // 主要查询实现：一次性 XML 查询，失败时回退到逐 target 并发查询
     std::unordered_map<std::string, BazelTarget> ParseWithComprehensiveQuery();
+    std::unordered_map<std::string, BazelTarget> ParseWithBuildFileReader(const WorkspaceManifest& manifest);
     std::unordered_map<std::string, BazelTarget> ParseWithConcurrentQueries();
     std::unordered_map<std::string, BazelTarget> ParseWithIndividualQueries();
+
+    // 增量查询：只重新查询 BUILD 内容变化的包并合并进 targets；变化面过大时返回 false
+    bool ReparseChangedPackages(const WorkspaceManifestDiff& diff,
+                                const WorkspaceManifest& manifest,
+                                std::unordered_map<std::string, BazelTarget>& targets);
+
+    // 并行读取指定包的 BUILD 文件，无法求值的包合并成 bazel query 兜底
+    void ReadPackagesFromBuildFiles(const std::vector<std::string>& packages,
+                                    std::unordered_map<std::string, BazelTarget>& targets);
+
+    // 按包查询（//pkg:*，多个包合并到同一次调用）并写入 targets
+    void QueryPackagesAsXml(const std::vector<std::string>& packages,
+                            std::unordered_map<std::string, BazelTarget>& targets);
+
+    // 以 XML 输出查询 scope 内的全部 cc 规则并写入 targets，返回 bazel 退出码
+    int QueryCcRulesAsXml(const std::string& scope,
+                          std::unordered_map<std::string, BazelTarget>& targets);
+
+    // 以 XML 输出执行 expression 并把其中的规则写入 targets，返回 bazel 退出码；
+    // output_bytes 非空时写入 stdout 字节数
+    int QueryRulesAsXml(const std::string& expression,
+                        std::unordered_map<std::string, BazelTarget>& targets,
+                        size_t* output_bytes = nullptr);
     
-    // 并发查询相关方法
+    // 批量查询目标详情：每次 bazel 调用合并 K 个 label（K 自适应），失败时二分重试
     void QueryTargetDetailsBatch(const std::vector<std::string>& target_labels,
                                 std::unordered_map<std::string, BazelTarget>& targets);
-    std::vector<BazelTarget> ProcessTargetBatch(const std::vector<std::string>& batch_labels);
     BazelTarget ProcessSingleTarget(const std::string& label);
     
     // 回退策略
@@ -60,11 +84,30 @@ private:
     // 解析输出内容
     std::string ExtractRuleTypeFromLabel(const std::string& label);
 
-    // 命令执行
-    std::string ExecuteBazelCommand(const std::string& command);
+    // 组装 bazel query 参数（argv 形式，不经过 shell，无需引号转义）
+    std::vector<std::string> BuildQueryArgs(const std::string& expression, const std::string& output) const;
+
+    // 组装在工作区目录中运行的 bazel 子进程请求
+    ProcessRequest MakeBazelRequest(const std::vector<std::string>& args) const;
+
+    // 命令执行：返回 stdout，stderr 仅在失败时记录日志
+    std::string ExecuteBazelCommand(const std::vector<std::string>& args);
+
+    // 流式命令执行：子进程运行期间逐行回调 stdout，返回退出码；超时抛出异常
+    int ExecuteBazelCommandStreaming(const std::vector<std::string>& args,
+                                     const std::function<void(std::string_view)>& on_line);
+
+    // 流式读取 --output=label 结果
+    std::vector<std::string> QueryLabelList(const std::vector<std::string>& args);
     
-    // 解析单个目标
-    BazelTarget ParseTargetFromLabelKind(const std::string& line);
+    // 解析单个目标（label_kind 行，零拷贝切分）
+    BazelTarget ParseTargetFromLabelKind(std::string_view line);
+
+    // 将 XML 查询得到的规则转换为 BazelTarget
+    BazelTarget BuildTargetFromQueryRule(QueryRule&& rule);
+
+    // 将文件标签按扩展名归入 srcs / hdrs
+    void AppendFileLabel(BazelTarget& target, const std::string& label);
 
     // 转换Bazel标签为实际文件路径
     std::string ConvertBazelLabelToPath(const std::string& bazel_label);
@@ -78,10 +121,6 @@ private:
     // 提取依赖列表
     std::vector<std::string> ExtractDependencies(const std::string& target_label, const std::string& deps_output);
     
-    // 目录管理
-    void ChangeToWorkspaceDirectory();
-    void RestoreOriginalDirectory();
-    
     // 环境验证
     bool ValidateBazelEnvironment();
 };
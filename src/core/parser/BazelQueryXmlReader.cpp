@@ -0,0 +1,219 @@
+#include "BazelQueryXmlReader.h"
+
+#include <utility>
+
+namespace {
+
+std::string_view TrimView(std::string_view value) {
+    size_t start = 0;
+    while (start < value.size() &&
+           (value[start] == ' ' || value[start] == '\t' || value[start] == '\r' || value[start] == '\n')) {
+        ++start;
+    }
+    size_t end = value.size();
+    while (end > start &&
+           (value[end - 1] == ' ' || value[end - 1] == '\t' || value[end - 1] == '\r' ||
+            value[end - 1] == '\n')) {
+        --end;
+    }
+    return value.substr(start, end - start);
+}
+
+bool StartsWith(std::string_view value, std::string_view prefix) {
+    return value.size() >= prefix.size() && value.compare(0, prefix.size(), prefix) == 0;
+}
+
+void AppendDecodedXml(std::string_view raw, std::string& output) {
+    output.reserve(output.size() + raw.size());
+    for (size_t index = 0; index < raw.size(); ++index) {
+        const char ch = raw[index];
+        if (ch != '&') {
+            output.push_back(ch);
+            continue;
+        }
+
+        const size_t semicolon = raw.find(';', index + 1);
+        if (semicolon == std::string_view::npos) {
+            output.push_back(ch);
+            continue;
+        }
+
+        const std::string_view entity = raw.substr(index + 1, semicolon - index - 1);
+        if (entity == "amp") {
+            output.push_back('&');
+        } else if (entity == "lt") {
+            output.push_back('<');
+        } else if (entity == "gt") {
+            output.push_back('>');
+        } else if (entity == "quot") {
+            output.push_back('"');
+        } else if (entity == "apos") {
+            output.push_back('\'');
+        } else if (entity.size() > 1 && entity[0] == '#') {
+            unsigned long code = 0;
+            const bool hex = entity[1] == 'x' || entity[1] == 'X';
+            for (size_t pos = hex ? 2 : 1; pos < entity.size(); ++pos) {
+                const char digit = entity[pos];
+                if (digit >= '0' && digit <= '9') {
+                    code = code * (hex ? 16 : 10) + static_cast<unsigned long>(digit - '0');
+                } else if (hex && digit >= 'a' && digit <= 'f') {
+                    code = code * 16 + static_cast<unsigned long>(digit - 'a' + 10);
+                } else if (hex && digit >= 'A' && digit <= 'F') {
+                    code = code * 16 + static_cast<unsigned long>(digit - 'A' + 10);
+                }
+            }
+            // 标签只会出现 ASCII 字符，非 ASCII 的实体原样保留
+            if (code > 0 && code < 0x80) {
+                output.push_back(static_cast<char>(code));
+            } else {
+                output.append(raw.substr(index, semicolon - index + 1));
+            }
+        } else {
+            output.append(raw.substr(index, semicolon - index + 1));
+        }
+        index = semicolon;
+    }
+}
+
+// 读取形如 name="value" 的属性；属性名前必须是空白，避免 classname 误匹配 name
+bool ExtractAttribute(std::string_view tag, std::string_view attribute, std::string& value) {
+    size_t search_from = 0;
+    while (true) {
+        const size_t pos = tag.find(attribute, search_from);
+        if (pos == std::string_view::npos) {
+            return false;
+        }
+        search_from = pos + attribute.size();
+
+        const bool boundary_ok = pos > 0 && (tag[pos - 1] == ' ' || tag[pos - 1] == '\t');
+        if (!boundary_ok || search_from + 1 >= tag.size() || tag[search_from] != '=' ||
+            tag[search_from + 1] != '"') {
+            continue;
+        }
+
+        const size_t value_start = search_from + 2;
+        const size_t value_end = tag.find('"', value_start);
+        if (value_end == std::string_view::npos) {
+            return false;
+        }
+
+        value.clear();
+        AppendDecodedXml(tag.substr(value_start, value_end - value_start), value);
+        return true;
+    }
+}
+
+}  // namespace
+
+BazelQueryXmlReader::BazelQueryXmlReader(RuleCallback on_rule) : on_rule_(std::move(on_rule)) {
+}
+
+void BazelQueryXmlReader::ConsumeText(std::string_view text) {
+    size_t line_start = 0;
+    while (line_start < text.size()) {
+        size_t line_end = text.find('\n', line_start);
+        if (line_end == std::string_view::npos) {
+            line_end = text.size();
+        }
+        ConsumeLine(text.substr(line_start, line_end - line_start));
+        line_start = line_end + 1;
+    }
+}
+
+void BazelQueryXmlReader::ConsumeLine(std::string_view line) {
+    const std::string_view tag = TrimView(line);
+    if (tag.empty() || tag[0] != '<') {
+        return;
+    }
+
+    if (StartsWith(tag, "<query")) {
+        saw_query_root_ = true;
+        return;
+    }
+
+    if (StartsWith(tag, "<rule ")) {
+        if (in_rule_) {
+            FinishRule();
+        }
+        current_rule_ = QueryRule{};
+        ExtractAttribute(tag, "class", current_rule_.rule_class);
+        ExtractAttribute(tag, "name", current_rule_.label);
+        in_rule_ = true;
+        current_list_ = ListKind::NONE;
+        if (tag.size() >= 2 && tag.compare(tag.size() - 2, 2, "/>") == 0) {
+            FinishRule();
+        }
+        return;
+    }
+
+    if (!in_rule_) {
+        return;
+    }
+
+    if (StartsWith(tag, "</rule>")) {
+        FinishRule();
+        return;
+    }
+
+    if (StartsWith(tag, "<list ")) {
+        std::string list_name;
+        ExtractAttribute(tag, "name", list_name);
+        if (list_name == "deps" || list_name == "implementation_deps") {
+            current_list_ = ListKind::DEPS;
+        } else if (list_name == "srcs") {
+            current_list_ = ListKind::SRCS;
+        } else if (list_name == "hdrs") {
+            current_list_ = ListKind::HDRS;
+        } else {
+            current_list_ = ListKind::OTHER;
+        }
+        if (tag.compare(tag.size() - 2, 2, "/>") == 0) {
+            current_list_ = ListKind::NONE;
+        }
+        return;
+    }
+
+    if (StartsWith(tag, "</list>")) {
+        current_list_ = ListKind::NONE;
+        return;
+    }
+
+    if (!StartsWith(tag, "<label ")) {
+        return;
+    }
+
+    std::vector<std::string>* destination = nullptr;
+    switch (current_list_) {
+        case ListKind::DEPS:
+            destination = &current_rule_.deps;
+            break;
+        case ListKind::SRCS:
+            destination = &current_rule_.srcs;
+            break;
+        case ListKind::HDRS:
+            destination = &current_rule_.hdrs;
+            break;
+        case ListKind::NONE:
+        case ListKind::OTHER:
+            break;
+    }
+    if (destination == nullptr) {
+        return;
+    }
+
+    std::string value;
+    if (ExtractAttribute(tag, "value", value) && !value.empty()) {
+        destination->push_back(std::move(value));
+    }
+}
+
+void BazelQueryXmlReader::FinishRule() {
+    in_rule_ = false;
+    current_list_ = ListKind::NONE;
+    if (current_rule_.label.empty()) {
+        return;
+    }
+    ++rule_count_;
+    on_rule_(std::move(current_rule_));
+    current_rule_ = QueryRule{};
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// bazel query --output=xml 中的单条规则（只保留依赖分析需要的属性）
+struct QueryRule {
+    std::string rule_class;                 // 规则类型，例如 cc_library
+    std::string label;                      // 规则完整标签
+    std::vector<std::string> deps;          // deps / implementation_deps 中的标签
+    std::vector<std::string> srcs;          // srcs 中的标签
+    std::vector<std::string> hdrs;          // hdrs 中的标签
+};
+
+// 逐行读取 bazel query --output=xml 输出。
+// Bazel 的 XML 输出每个元素独占一行，因此按行解析即可，无需完整 XML 解析器；
+// 混入的 stderr 文本（Loading: / INFO: 等）不以 '<' 开头，会被自动忽略。
+class BazelQueryXmlReader {
+public:
+    using RuleCallback = std::function<void(QueryRule&&)>;
+
+    explicit BazelQueryXmlReader(RuleCallback on_rule);
+
+    // 输入一行输出（可以带行尾换行符）
+    void ConsumeLine(std::string_view line);
+
+    // 一次性输入整段输出
+    void ConsumeText(std::string_view text);
+
+    // 是否见到过 <query> 根节点，用于判断输出是否为合法 XML
+    bool SawQueryRoot() const { return saw_query_root_; }
+
+    // 已产出的规则数量
+    size_t RuleCount() const { return rule_count_; }
+
+private:
+    enum class ListKind {
+        NONE,
+        DEPS,
+        SRCS,
+        HDRS,
+        OTHER
+    };
+
+    void FinishRule();
+
+    RuleCallback on_rule_;
+    QueryRule current_rule_;
+    bool in_rule_{false};
+    bool saw_query_root_{false};
+    ListKind current_list_{ListKind::NONE};
+    size_t rule_count_{0};
+};
@@ -0,0 +1,854 @@
+#include "BuildFileReader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// BUILD 中常见、且不会产生 cc_* 规则的原生函数，读取时直接忽略
+const std::set<std::string>& GetIgnoredFunctions() {
+    static const std::set<std::string> functions = {
+        "package", "licenses", "exports_files", "package_group", "filegroup", "genrule",
+        "config_setting", "alias", "test_suite", "sh_binary", "sh_library", "sh_test",
+        "py_binary", "py_library", "py_test", "proto_library", "java_binary", "java_library",
+        "java_test", "constraint_setting", "constraint_value", "platform", "toolchain",
+        "workspace"};
+    return functions;
+}
+
+bool IsSupportedCcRule(const std::string& name) {
+    return name == "cc_library" || name == "cc_binary" || name == "cc_test";
+}
+
+struct Token {
+    enum class Kind {
+        NAME,
+        STRING,
+        NUMBER,
+        PUNCT
+    };
+
+    Kind kind{Kind::PUNCT};
+    std::string text;
+    bool line_start{false};   // 括号外且位于新一行的开头，即新语句的开始
+};
+
+bool Tokenize(std::string_view source, std::vector<Token>& tokens, std::string& error) {
+    size_t pos = 0;
+    int depth = 0;
+    bool at_line_start = true;
+
+    auto push = [&](Token::Kind kind, std::string text) {
+        Token token;
+        token.kind = kind;
+        token.text = std::move(text);
+        token.line_start = at_line_start && depth == 0;
+        at_line_start = false;
+        tokens.push_back(std::move(token));
+    };
+
+    while (pos < source.size()) {
+        const char ch = source[pos];
+        if (ch == '\n') {
+            at_line_start = true;
+            ++pos;
+            continue;
+        }
+        if (ch == ' ' || ch == '\t' || ch == '\r') {
+            ++pos;
+            continue;
+        }
+        if (ch == '\\' && pos + 1 < source.size() && source[pos + 1] == '\n') {
+            pos += 2;
+            continue;
+        }
+        if (ch == '#') {
+            while (pos < source.size() && source[pos] != '\n') {
+                ++pos;
+            }
+            continue;
+        }
+
+        const bool raw_prefix = (ch == 'r' || ch == 'R') && pos + 1 < source.size() &&
+                                (source[pos + 1] == '"' || source[pos + 1] == '\'');
+        if (ch == '"' || ch == '\'' || raw_prefix) {
+            const bool raw = raw_prefix;
+            if (raw) {
+                ++pos;
+            }
+            const char quote = source[pos];
+            const bool triple = pos + 2 < source.size() && source[pos + 1] == quote && source[pos + 2] == quote;
+            pos += triple ? 3 : 1;
+
+            std::string value;
+            bool closed = false;
+            while (pos < source.size()) {
+                const char current = source[pos];
+                if (current == quote) {
+                    if (!triple) {
+                        ++pos;
+                        closed = true;
+                        break;
+                    }
+                    if (pos + 2 < source.size() && source[pos + 1] == quote && source[pos + 2] == quote) {
+                        pos += 3;
+                        closed = true;
+                        break;
+                    }
+                }
+                if (current == '\n' && !triple) {
+                    break;
+                }
+                if (current == '\\' && pos + 1 < source.size()) {
+                    const char escaped = source[pos + 1];
+                    if (raw) {
+                        value.push_back(current);
+                        value.push_back(escaped);
+                    } else if (escaped == 'n') {
+                        value.push_back('\n');
+                    } else if (escaped == 't') {
+                        value.push_back('\t');
+                    } else if (escaped != '\n') {
+                        value.push_back(escaped);
+                    }
+                    pos += 2;
+                    continue;
+                }
+                value.push_back(current);
+                ++pos;
+            }
+            if (!closed) {
+                error = "unterminated string literal";
+                return false;
+            }
+            push(Token::Kind::STRING, std::move(value));
+            continue;
+        }
+
+        if (std::isalpha(static_cast<unsigned char>(ch)) || ch == '_') {
+            const size_t start = pos;
+            while (pos < source.size() &&
+                   (std::isalnum(static_cast<unsigned char>(source[pos])) || source[pos] == '_')) {
+                ++pos;
+            }
+            push(Token::Kind::NAME, std::string(source.substr(start, pos - start)));
+            continue;
+        }
+
+        if (std::isdigit(static_cast<unsigned char>(ch))) {
+            const size_t start = pos;
+            while (pos < source.size() &&
+                   (std::isalnum(static_cast<unsigned char>(source[pos])) || source[pos] == '.')) {
+                ++pos;
+            }
+            push(Token::Kind::NUMBER, std::string(source.substr(start, pos - start)));
+            continue;
+        }
+
+        // 比较运算符需要整体识别，避免 "==" 被当成关键字参数的 "="
+        if (pos + 1 < source.size() && source[pos + 1] == '=' &&
+            (ch == '=' || ch == '!' || ch == '<' || ch == '>' || ch == '+' || ch == '-' ||
+             ch == '*' || ch == '/' || ch == '%' || ch == '|' || ch == '&')) {
+            push(Token::Kind::PUNCT, std::string(source.substr(pos, 2)));
+            pos += 2;
+            continue;
+        }
+
+        if (ch == '(' || ch == '[' || ch == '{') {
+            push(Token::Kind::PUNCT, std::string(1, ch));
+            ++depth;
+            ++pos;
+            continue;
+        }
+        if (ch == ')' || ch == ']' || ch == '}') {
+            --depth;
+            if (depth < 0) {
+                error = "unbalanced brackets";
+                return false;
+            }
+            push(Token::Kind::PUNCT, std::string(1, ch));
+            ++pos;
+            continue;
+        }
+
+        push(Token::Kind::PUNCT, std::string(1, ch));
+        ++pos;
+    }
+
+    if (depth != 0) {
+        error = "unbalanced brackets";
+        return false;
+    }
+    return true;
+}
+
+// 只区分能确定求值的字符串 / 字符串列表 / 十进制整数字面量，其余一律视为不透明值
+struct Value {
+    enum class Kind {
+        STRING,
+        LIST,
+        INT,        // str 为字面量的数字串
+        OPAQUE
+    };
+
+    Kind kind{Kind::OPAQUE};
+    std::string str;
+    std::vector<std::string> list;
+
+    static Value Opaque() { return Value{}; }
+    static Value String(std::string value) {
+        Value result;
+        result.kind = Kind::STRING;
+        result.str = std::move(value);
+        return result;
+    }
+    static Value List(std::vector<std::string> values) {
+        Value result;
+        result.kind = Kind::LIST;
+        result.list = std::move(values);
+        return result;
+    }
+    static Value Int(std::string digits) {
+        Value result;
+        result.kind = Kind::INT;
+        result.str = std::move(digits);
+        return result;
+    }
+
+    bool IsZero() const {
+        return kind == Kind::INT && std::all_of(str.begin(), str.end(), [](char ch) { return ch == '0'; });
+    }
+};
+
+// glob() 的模式匹配：'*' 匹配段内任意字符，'**' 匹配零个或多个路径段
+bool MatchSegment(std::string_view pattern, std::string_view name) {
+    size_t p = 0;
+    size_t n = 0;
+    size_t star = std::string_view::npos;
+    size_t star_match = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            star_match = n;
+        } else if (p < pattern.size() && pattern[p] == name[n]) {
+            ++p;
+            ++n;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            n = ++star_match;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+std::vector<std::string_view> SplitPath(std::string_view path) {
+    std::vector<std::string_view> segments;
+    size_t start = 0;
+    while (start <= path.size()) {
+        const size_t slash = path.find('/', start);
+        const size_t end = slash == std::string_view::npos ? path.size() : slash;
+        if (end > start) {
+            segments.push_back(path.substr(start, end - start));
+        }
+        if (slash == std::string_view::npos) {
+            break;
+        }
+        start = slash + 1;
+    }
+    return segments;
+}
+
+bool MatchGlobSegments(const std::vector<std::string_view>& pattern, size_t pattern_index,
+                       const std::vector<std::string_view>& path, size_t path_index) {
+    if (pattern_index == pattern.size()) {
+        return path_index == path.size();
+    }
+    if (pattern[pattern_index] == "**") {
+        for (size_t next = path_index; next <= path.size(); ++next) {
+            if (MatchGlobSegments(pattern, pattern_index + 1, path, next)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    if (path_index == path.size() || !MatchSegment(pattern[pattern_index], path[path_index])) {
+        return false;
+    }
+    return MatchGlobSegments(pattern, pattern_index + 1, path, path_index + 1);
+}
+
+bool MatchGlob(std::string_view pattern, std::string_view path) {
+    return MatchGlobSegments(SplitPath(pattern), 0, SplitPath(path), 0);
+}
+
+std::string NormalizeLabel(const std::string& raw, const std::string& package) {
+    std::string label = raw;
+    if (label.rfind("@@//", 0) == 0) {
+        label.erase(0, 2);
+    } else if (label.rfind("@//", 0) == 0) {
+        label.erase(0, 1);
+    }
+
+    if (label.rfind("//", 0) == 0 || label[0] == '@') {
+        const size_t slashes = label.find("//");
+        if (slashes == std::string::npos) {
+            // @repo 简写为 @repo//:repo
+            return label + "//:" + label.substr(label[1] == '@' ? 2 : 1);
+        }
+        if (label.find(':', slashes) == std::string::npos) {
+            const size_t last_slash = label.find_last_of('/');
+            label += ":" + label.substr(last_slash + 1);
+        }
+        return label;
+    }
+
+    if (label[0] == ':') {
+        return "//" + package + label;
+    }
+    return "//" + package + ":" + label;
+}
+
+class PackageEvaluator {
+public:
+    PackageEvaluator(std::vector<Token> tokens, std::string package, fs::path package_dir)
+        : tokens_(std::move(tokens)), package_(std::move(package)), package_dir_(std::move(package_dir)) {}
+
+    BuildFileReader::PackageResult Evaluate() {
+        while (pos_ < tokens_.size() && result_.unsupported_reason.empty()) {
+            EvaluateStatement();
+        }
+        result_.supported = result_.unsupported_reason.empty();
+        if (!result_.supported) {
+            result_.rules.clear();
+        }
+        return std::move(result_);
+    }
+
+private:
+    const Token* Peek(size_t offset = 0) const {
+        return pos_ + offset < tokens_.size() ? &tokens_[pos_ + offset] : nullptr;
+    }
+
+    bool PeekPunct(const char* text, size_t offset = 0) const {
+        const Token* token = Peek(offset);
+        return token != nullptr && token->kind == Token::Kind::PUNCT && token->text == text;
+    }
+
+    bool PeekName(size_t offset = 0) const {
+        const Token* token = Peek(offset);
+        return token != nullptr && token->kind == Token::Kind::NAME;
+    }
+
+    void Unsupported(const std::string& reason) {
+        if (result_.unsupported_reason.empty()) {
+            result_.unsupported_reason = reason;
+        }
+        pos_ = tokens_.size();
+    }
+
+    bool AtExpressionEnd() const {
+        const Token* token = Peek();
+        if (token == nullptr || token->line_start) {
+            return true;
+        }
+        return token->kind == Token::Kind::PUNCT &&
+               (token->text == "," || token->text == ")" || token->text == "]" ||
+                token->text == "}" || token->text == ":");
+    }
+
+    // 跳过当前表达式剩余部分（括号内的内容整体跳过）
+    void SkipToExpressionEnd() {
+        int depth = 0;
+        while (pos_ < tokens_.size()) {
+            const Token& token = tokens_[pos_];
+            if (depth == 0 && AtExpressionEnd()) {
+                return;
+            }
+            if (token.kind == Token::Kind::PUNCT) {
+                if (token.text == "(" || token.text == "[" || token.text == "{") {
+                    ++depth;
+                } else if (token.text == ")" || token.text == "]" || token.text == "}") {
+                    --depth;
+                }
+            }
+            ++pos_;
+        }
+    }
+
+    // 跳过一对括号（当前位置为左括号）
+    void SkipBracketed() {
+        int depth = 0;
+        do {
+            const Token& token = tokens_[pos_];
+            if (token.kind == Token::Kind::PUNCT) {
+                if (token.text == "(" || token.text == "[" || token.text == "{") {
+                    ++depth;
+                } else if (token.text == ")" || token.text == "]" || token.text == "}") {
+                    --depth;
+                }
+            }
+            ++pos_;
+        } while (depth > 0 && pos_ < tokens_.size());
+    }
+
+    void EvaluateStatement() {
+        const Token* token = Peek();
+        if (token->kind == Token::Kind::PUNCT && token->text == ";") {
+            ++pos_;
+            return;
+        }
+        if (token->kind == Token::Kind::STRING) {
+            // 文件开头的文档字符串
+            ParseExpression();
+            if (!AtStatementEnd()) {
+                Unsupported("unsupported top-level expression");
+            }
+            return;
+        }
+        if (token->kind != Token::Kind::NAME) {
+            Unsupported("unsupported top-level statement");
+            return;
+        }
+
+        if (PeekPunct("(", 1)) {
+            const std::string name = token->text;
+            pos_ += 2;
+            EvaluateCall(name);
+            return;
+        }
+        if (PeekPunct("=", 1)) {
+            const std::string name = token->text;
+            pos_ += 2;
+            variables_[name] = ParseExpression();
+            if (!AtStatementEnd()) {
+                Unsupported("unsupported assignment to " + name);
+            }
+            return;
+        }
+
+        Unsupported("unsupported statement starting with " + token->text);
+    }
+
+    bool AtStatementEnd() const {
+        const Token* token = Peek();
+        return token == nullptr || token->line_start || (token->kind == Token::Kind::PUNCT && token->text == ";");
+    }
+
+    struct CallArguments {
+        std::vector<Value> positional;
+        std::vector<std::pair<std::string, Value>> keywords;
+    };
+
+    // 解析到右括号为止（左括号已消费）
+    bool ParseArguments(CallArguments& arguments) {
+        while (!PeekPunct(")")) {
+            if (pos_ >= tokens_.size()) {
+                Unsupported("unterminated call");
+                return false;
+            }
+            if (PeekPunct("*") || PeekPunct("**")) {
+                Unsupported("unsupported *args / **kwargs");
+                return false;
+            }
+            if (PeekName() && PeekPunct("=", 1)) {
+                std::string key = Peek()->text;
+                pos_ += 2;
+                arguments.keywords.emplace_back(std::move(key), ParseExpression());
+            } else {
+                arguments.positional.push_back(ParseExpression());
+            }
+            if (PeekPunct(",")) {
+                ++pos_;
+            } else if (!PeekPunct(")")) {
+                Unsupported("unexpected token in call arguments");
+                return false;
+            }
+        }
+        ++pos_;
+        return true;
+    }
+
+    void EvaluateCall(const std::string& name) {
+        if (name == "load") {
+            EvaluateLoad();
+            return;
+        }
+
+        auto alias_it = cc_aliases_.find(name);
+        if (alias_it != cc_aliases_.end()) {
+            EvaluateCcRule(alias_it->second);
+            return;
+        }
+        if (macros_.count(name) > 0) {
+            Unsupported("calls loaded macro " + name);
+            return;
+        }
+        if (IsSupportedCcRule(name)) {
+            EvaluateCcRule(name);
+            return;
+        }
+        if (name.rfind("cc_", 0) == 0) {
+            Unsupported("unsupported rule " + name);
+            return;
+        }
+        if (GetIgnoredFunctions().count(name) > 0 || ignored_loads_.count(name) > 0) {
+            CallArguments arguments;
+            ParseArguments(arguments);
+            return;
+        }
+
+        Unsupported("unknown function " + name);
+    }
+
+    void EvaluateLoad() {
+        CallArguments arguments;
+        if (!ParseArguments(arguments)) {
+            return;
+        }
+        if (arguments.positional.empty() || arguments.positional[0].kind != Value::Kind::STRING) {
+            Unsupported("malformed load()");
+            return;
+        }
+
+        const std::string& file = arguments.positional[0].str;
+        const bool from_rules_cc = file.rfind("@rules_cc//", 0) == 0;
+        const bool external = !file.empty() && file[0] == '@';
+        auto bind = [&](const std::string& local, const std::string& symbol) {
+            if (from_rules_cc && IsSupportedCcRule(symbol)) {
+                cc_aliases_[local] = symbol;
+            } else if (external && GetIgnoredFunctions().count(symbol) > 0) {
+                // 外部规则集提供的同名非 cc 规则（如 rules_python 的 py_library）
+                ignored_loads_.insert(local);
+            } else {
+                macros_.insert(local);
+            }
+        };
+
+        for (size_t index = 1; index < arguments.positional.size(); ++index) {
+            const Value& symbol = arguments.positional[index];
+            if (symbol.kind != Value::Kind::STRING) {
+                Unsupported("malformed load()");
+                return;
+            }
+            bind(symbol.str, symbol.str);
+        }
+        for (const auto& [local, symbol] : arguments.keywords) {
+            if (symbol.kind != Value::Kind::STRING) {
+                Unsupported("malformed load()");
+                return;
+            }
+            bind(local, symbol.str);
+        }
+    }
+
+    void EvaluateCcRule(const std::string& rule_class) {
+        CallArguments arguments;
+        if (!ParseArguments(arguments)) {
+            return;
+        }
+        if (!arguments.positional.empty()) {
+            Unsupported(rule_class + " with positional arguments");
+            return;
+        }
+
+        QueryRule rule;
+        rule.rule_class = rule_class;
+        for (const auto& [key, value] : arguments.keywords) {
+            std::vector<std::string>* destination = nullptr;
+            if (key == "name") {
+                if (value.kind != Value::Kind::STRING || value.str.empty()) {
+                    Unsupported(rule_class + " without a literal name");
+                    return;
+                }
+                rule.label = "//" + package_ + ":" + value.str;
+                continue;
+            }
+            if (key == "deps" || key == "implementation_deps") {
+                destination = &rule.deps;
+            } else if (key == "srcs") {
+                destination = &rule.srcs;
+            } else if (key == "hdrs") {
+                destination = &rule.hdrs;
+            } else {
+                continue;
+            }
+
+            if (value.kind != Value::Kind::LIST) {
+                Unsupported(rule_class + " attribute " + key + " is not a literal list");
+                return;
+            }
+            for (const auto& item : value.list) {
+                if (!item.empty()) {
+                    destination->push_back(NormalizeLabel(item, package_));
+                }
+            }
+        }
+
+        if (rule.label.empty()) {
+            Unsupported(rule_class + " without a literal name");
+            return;
+        }
+        result_.rules.push_back(std::move(rule));
+    }
+
+    Value ParseExpression() {
+        Value value = ParseTerm();
+        while (result_.unsupported_reason.empty() && !AtExpressionEnd()) {
+            if (!PeekPunct("+")) {
+                // 其余运算符、方法调用、下标、条件表达式等都不求值
+                SkipToExpressionEnd();
+                return Value::Opaque();
+            }
+            ++pos_;
+            value = Concat(value, ParseTerm());
+        }
+        return value;
+    }
+
+    static Value Concat(const Value& left, const Value& right) {
+        if (left.kind == Value::Kind::STRING && right.kind == Value::Kind::STRING) {
+            return Value::String(left.str + right.str);
+        }
+        if (left.kind == Value::Kind::LIST && right.kind == Value::Kind::LIST) {
+            std::vector<std::string> merged = left.list;
+            merged.insert(merged.end(), right.list.begin(), right.list.end());
+            return Value::List(std::move(merged));
+        }
+        return Value::Opaque();
+    }
+
+    Value ParseTerm() {
+        const Token* token = Peek();
+        if (token == nullptr) {
+            Unsupported("unexpected end of file");
+            return Value::Opaque();
+        }
+
+        if (token->kind == Token::Kind::STRING) {
+            std::string value = token->text;
+            ++pos_;
+            // 相邻字符串字面量隐式拼接
+            while (Peek() != nullptr && Peek()->kind == Token::Kind::STRING && !Peek()->line_start) {
+                value += Peek()->text;
+                ++pos_;
+            }
+            return Value::String(std::move(value));
+        }
+
+        if (token->kind == Token::Kind::PUNCT && token->text == "[") {
+            return ParseList();
+        }
+
+        if (token->kind == Token::Kind::PUNCT && token->text == "(") {
+            const size_t start = pos_;
+            ++pos_;
+            Value value = ParseExpression();
+            if (PeekPunct(")")) {
+                ++pos_;
+                return value;
+            }
+            if (!result_.unsupported_reason.empty()) {
+                return Value::Opaque();
+            }
+            // 元组等，整体跳过
+            pos_ = start;
+            SkipBracketed();
+            return Value::Opaque();
+        }
+
+        if (token->kind == Token::Kind::NAME) {
+            const std::string name = token->text;
+            ++pos_;
+            if (PeekPunct("(")) {
+                ++pos_;
+                if (name == "glob") {
+                    return ParseGlob();
+                }
+                CallArguments ignored;
+                ParseArguments(ignored);
+                return Value::Opaque();
+            }
+            auto it = variables_.find(name);
+            return it != variables_.end() ? it->second : Value::Opaque();
+        }
+
+        if (token->kind == Token::Kind::PUNCT && token->text == "{") {
+            SkipBracketed();
+            return Value::Opaque();
+        }
+
+        if (token->kind == Token::Kind::NUMBER) {
+            ++pos_;
+            const bool decimal = std::all_of(token->text.begin(), token->text.end(),
+                                             [](char ch) { return std::isdigit(static_cast<unsigned char>(ch)); });
+            return decimal ? Value::Int(token->text) : Value::Opaque();
+        }
+
+        if (token->kind == Token::Kind::PUNCT && token->text == "-") {
+            ++pos_;
+            ParseTerm();
+            return Value::Opaque();
+        }
+
+        Unsupported("unexpected token " + token->text);
+        return Value::Opaque();
+    }
+
+    Value ParseList() {
+        ++pos_;
+        std::vector<std::string> items;
+        bool literal = true;
+        while (!PeekPunct("]")) {
+            if (pos_ >= tokens_.size() || !result_.unsupported_reason.empty()) {
+                Unsupported("unterminated list");
+                return Value::Opaque();
+            }
+            Value item = ParseExpression();
+            if (item.kind == Value::Kind::STRING) {
+                items.push_back(std::move(item.str));
+            } else {
+                literal = false;
+            }
+            if (PeekPunct(",")) {
+                ++pos_;
+            } else if (!PeekPunct("]")) {
+                // 列表推导式等
+                SkipToExpressionEnd();
+                literal = false;
+                if (!PeekPunct("]")) {
+                    Unsupported("malformed list");
+                    return Value::Opaque();
+                }
+            }
+        }
+        ++pos_;
+        return literal ? Value::List(std::move(items)) : Value::Opaque();
+    }
+
+    Value ParseGlob() {
+        CallArguments arguments;
+        if (!ParseArguments(arguments)) {
+            return Value::Opaque();
+        }
+
+        const Value* include = arguments.positional.empty() ? nullptr : &arguments.positional[0];
+        const Value* exclude = arguments.positional.size() > 1 ? &arguments.positional[1] : nullptr;
+        for (const auto& [key, value] : arguments.keywords) {
+            if (key == "include") {
+                include = &value;
+            } else if (key == "exclude") {
+                exclude = &value;
+            } else if (key == "exclude_directories") {
+                // 非 0 的整数与默认值 1 相同（不匹配目录）；0 需要目录语义，非字面量无法确定，都交给 bazel
+                if (value.kind != Value::Kind::INT || value.IsZero()) {
+                    return Value::Opaque();
+                }
+            }
+        }
+        if (include == nullptr || include->kind != Value::Kind::LIST ||
+            (exclude != nullptr && exclude->kind != Value::Kind::LIST)) {
+            return Value::Opaque();
+        }
+
+        const std::vector<std::string>& files = ListPackageFiles();
+        std::vector<std::string> matched;
+        for (const auto& file : files) {
+            const bool included = std::any_of(include->list.begin(), include->list.end(),
+                                              [&](const std::string& pattern) { return MatchGlob(pattern, file); });
+            if (!included) {
+                continue;
+            }
+            const bool excluded = exclude != nullptr &&
+                                  std::any_of(exclude->list.begin(), exclude->list.end(),
+                                              [&](const std::string& pattern) { return MatchGlob(pattern, file); });
+            if (!excluded) {
+                matched.push_back(file);
+            }
+        }
+        return Value::List(std::move(matched));
+    }
+
+    // 包内全部文件（相对包目录，已排序），不进入含 BUILD 文件的子包；首次 glob 时才遍历
+    const std::vector<std::string>& ListPackageFiles() {
+        if (package_files_) {
+            return *package_files_;
+        }
+        package_files_.emplace();
+
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(package_dir_, ec), end; !ec && it != end; it.increment(ec)) {
+            std::error_code entry_ec;
+            if (it->is_directory(entry_ec)) {
+                if (fs::exists(it->path() / "BUILD", entry_ec) ||
+                    fs::exists(it->path() / "BUILD.bazel", entry_ec)) {
+                    it.disable_recursion_pending();
+                }
+                continue;
+            }
+            if (it->is_regular_file(entry_ec)) {
+                package_files_->push_back(it->path().lexically_relative(package_dir_).generic_string());
+            }
+        }
+        std::sort(package_files_->begin(), package_files_->end());
+        return *package_files_;
+    }
+
+    std::vector<Token> tokens_;
+    size_t pos_{0};
+    std::string package_;
+    fs::path package_dir_;
+    std::map<std::string, Value> variables_;
+    std::map<std::string, std::string> cc_aliases_;   // load 进来的 rules_cc 规则：本地名 -> 规则名
+    std::set<std::string> macros_;
+    std::set<std::string> ignored_loads_;
+    std::optional<std::vector<std::string>> package_files_;
+    BuildFileReader::PackageResult result_;
+};
+
+}  // namespace
+
+BuildFileReader::BuildFileReader(std::string workspace_path) : workspace_path_(std::move(workspace_path)) {
+}
+
+BuildFileReader::PackageResult BuildFileReader::ReadPackage(const std::string& package) const {
+    PackageResult result;
+    const fs::path package_dir = package.empty() ? fs::path(workspace_path_) : fs::path(workspace_path_) / package;
+
+    fs::path build_file = package_dir / "BUILD.bazel";
+    std::error_code ec;
+    if (!fs::is_regular_file(build_file, ec)) {
+        build_file = package_dir / "BUILD";
+    }
+
+    std::ifstream input(build_file, std::ios::binary);
+    if (!input) {
+        result.unsupported_reason = "cannot read " + build_file.string();
+        return result;
+    }
+    std::ostringstream buffer;
+    buffer << input.rdbuf();
+    const std::string source = buffer.str();
+
+    std::vector<Token> tokens;
+    if (!Tokenize(source, tokens, result.unsupported_reason)) {
+        return result;
+    }
+
+    return PackageEvaluator(std::move(tokens), package, package_dir).Evaluate();
+}
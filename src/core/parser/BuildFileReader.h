@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "parser/BazelQueryXmlReader.h"
+
+// 不经过 bazel 直接读取 BUILD / BUILD.bazel 的受限 Starlark 读取器。
+// 只求值 cc_library / cc_binary / cc_test 的字面量 deps / srcs / hdrs、字符串与列表变量、
+// 列表拼接以及 glob()；遇到 load 进来的宏、select()、列表推导等无法求值的构造时，
+// 整个包标记为不支持，由调用方回退到 bazel query。
+class BuildFileReader {
+public:
+    struct PackageResult {
+        bool supported{false};
+        std::string unsupported_reason;
+        std::vector<QueryRule> rules;   // 与 bazel query --output=xml 的规则形状一致，标签已规范化
+    };
+
+    explicit BuildFileReader(std::string workspace_path);
+
+    // 读取单个包（包路径相对工作区，根包为空串）；线程安全，可并行调用
+    PackageResult ReadPackage(const std::string& package) const;
+
+private:
+    std::string workspace_path_;
+};
@@ -0,0 +1,269 @@
+#include "WorkspaceManifest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::uint64_t HashFileContent(const fs::path& path) {
+    std::uint64_t hash = 1469598103934665603ull;
+    std::ifstream input(path, std::ios::binary);
+    char buffer[16 * 1024];
+    while (input) {
+        input.read(buffer, sizeof(buffer));
+        const std::streamsize count = input.gcount();
+        for (std::streamsize index = 0; index < count; ++index) {
+            hash ^= static_cast<unsigned char>(buffer[index]);
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+bool ReadFileState(const fs::path& path,
+                   const std::string& key,
+                   const std::map<std::string, WorkspaceFileState>* previous_files,
+                   WorkspaceFileState& state) {
+    std::error_code ec;
+    const auto write_time = fs::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    const auto size = fs::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+
+    state.mtime = static_cast<long long>(write_time.time_since_epoch().count());
+    state.size = static_cast<std::uint64_t>(size);
+
+    if (previous_files != nullptr) {
+        auto it = previous_files->find(key);
+        if (it != previous_files->end() && it->second.mtime == state.mtime &&
+            it->second.size == state.size) {
+            state.content_hash = it->second.content_hash;
+            return true;
+        }
+    }
+
+    state.content_hash = HashFileContent(path);
+    return true;
+}
+
+std::string PackageOfBuildFile(const fs::path& relative) {
+    std::string package = relative.parent_path().generic_string();
+    if (package == ".") {
+        package.clear();
+    }
+    return package;
+}
+
+void MixHash(std::uint64_t& hash, std::uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        hash ^= (value >> shift) & 0xff;
+        hash *= 1099511628211ull;
+    }
+}
+
+void MixHash(std::uint64_t& hash, const std::string& text) {
+    for (unsigned char ch : text) {
+        hash ^= ch;
+        hash *= 1099511628211ull;
+    }
+    MixHash(hash, static_cast<std::uint64_t>(text.size()));
+}
+
+}  // namespace
+
+bool WorkspaceManifest::IsBuildFileName(const std::string& filename) {
+    return filename == "BUILD" || filename == "BUILD.bazel";
+}
+
+bool WorkspaceManifest::IsGlobalInputName(const std::string& filename) {
+    if (filename == "WORKSPACE" || filename == "WORKSPACE.bazel" || filename == "MODULE.bazel") {
+        return true;
+    }
+    return filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".bzl") == 0;
+}
+
+std::vector<std::string> WorkspaceManifest::LoadIgnoredDirectories(const std::string& workspace_path) {
+    std::vector<std::string> ignored;
+    std::ifstream input(fs::path(workspace_path) / ".bazelignore");
+    std::string line;
+    while (std::getline(input, line)) {
+        const size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') {
+            continue;
+        }
+        const size_t end = line.find_last_not_of(" \t\r/");
+        if (end == std::string::npos || end < begin) {
+            continue;
+        }
+        ignored.push_back(fs::path(line.substr(begin, end - begin + 1)).lexically_normal().generic_string());
+    }
+    return ignored;
+}
+
+bool WorkspaceManifest::IsIgnoredDirectory(const std::string& relative_dir,
+                                           const std::vector<std::string>& ignored) {
+    if (relative_dir == ".git") {
+        return true;
+    }
+    // bazel-out / bazel-bin 等便捷链接只出现在工作区根目录
+    if (relative_dir.rfind("bazel-", 0) == 0 && relative_dir.find('/') == std::string::npos) {
+        return true;
+    }
+    for (const auto& path : ignored) {
+        if (relative_dir == path ||
+            (relative_dir.size() > path.size() && relative_dir.compare(0, path.size(), path) == 0 &&
+             relative_dir[path.size()] == '/')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+WorkspaceManifest WorkspaceManifest::Scan(const std::string& workspace_path,
+                                          const WorkspaceManifest* previous) {
+    WorkspaceManifest manifest;
+    const fs::path workspace(workspace_path);
+    std::error_code ec;
+    if (!fs::is_directory(workspace, ec)) {
+        return manifest;
+    }
+
+    const std::vector<std::string> ignored = LoadIgnoredDirectories(workspace_path);
+    for (fs::recursive_directory_iterator it(workspace, ec), end; it != end; it.increment(ec)) {
+        if (ec) {
+            break;
+        }
+        if (it->is_directory(ec) && !it->is_symlink(ec)) {
+            if (IsIgnoredDirectory(it->path().lexically_relative(workspace).generic_string(), ignored)) {
+                it.disable_recursion_pending();
+            }
+            continue;
+        }
+        if (!it->is_regular_file(ec)) {
+            continue;
+        }
+
+        const std::string filename = it->path().filename().string();
+        const bool is_build = IsBuildFileName(filename);
+        if (!is_build && !IsGlobalInputName(filename)) {
+            continue;
+        }
+
+        const fs::path relative = it->path().lexically_relative(workspace);
+        WorkspaceFileState state;
+        if (is_build) {
+            const std::string package = PackageOfBuildFile(relative);
+            // 同一目录同时存在 BUILD 与 BUILD.bazel 时 Bazel 使用 BUILD.bazel
+            if (filename == "BUILD" && fs::exists(it->path().parent_path() / "BUILD.bazel")) {
+                continue;
+            }
+            if (ReadFileState(it->path(), package, previous ? &previous->packages : nullptr, state)) {
+                manifest.packages[package] = state;
+            }
+        } else {
+            const std::string key = relative.generic_string();
+            if (ReadFileState(it->path(), key, previous ? &previous->global_files : nullptr, state)) {
+                manifest.global_files[key] = state;
+            }
+        }
+    }
+
+    return manifest;
+}
+
+void WorkspaceManifest::Refresh(const std::string& workspace_path,
+                                const std::vector<std::string>& relative_files) {
+    const fs::path workspace(workspace_path);
+    for (const auto& relative_file : relative_files) {
+        const fs::path relative(relative_file);
+        const std::string filename = relative.filename().string();
+        WorkspaceFileState state;
+
+        if (IsBuildFileName(filename)) {
+            // 重新按 BUILD.bazel 优先的规则确定包的 BUILD 文件
+            const std::string package = PackageOfBuildFile(relative);
+            const fs::path directory = workspace / relative.parent_path();
+            std::error_code ec;
+            fs::path build_file = directory / "BUILD.bazel";
+            if (!fs::is_regular_file(build_file, ec)) {
+                build_file = directory / "BUILD";
+            }
+            if (fs::is_regular_file(build_file, ec) && ReadFileState(build_file, package, &packages, state)) {
+                packages[package] = state;
+            } else {
+                packages.erase(package);
+            }
+        } else if (IsGlobalInputName(filename)) {
+            const std::string key = relative.generic_string();
+            std::error_code ec;
+            if (fs::is_regular_file(workspace / relative, ec) &&
+                ReadFileState(workspace / relative, key, &global_files, state)) {
+                global_files[key] = state;
+            } else {
+                global_files.erase(key);
+            }
+        }
+    }
+}
+
+std::uint64_t WorkspaceManifest::Fingerprint() const {
+    std::uint64_t hash = 1469598103934665603ull;
+    for (const auto* files : {&packages, &global_files}) {
+        MixHash(hash, static_cast<std::uint64_t>(files->size()));
+        for (const auto& [key, state] : *files) {
+            MixHash(hash, key);
+            MixHash(hash, state.content_hash);
+        }
+    }
+    return hash;
+}
+
+WorkspaceManifestDiff WorkspaceManifest::DiffFrom(const WorkspaceManifest& previous) const {
+    WorkspaceManifestDiff diff;
+
+    if (global_files.size() != previous.global_files.size()) {
+        diff.global_changed = true;
+    } else {
+        auto current_it = global_files.begin();
+        auto previous_it = previous.global_files.begin();
+        for (; current_it != global_files.end(); ++current_it, ++previous_it) {
+            if (current_it->first != previous_it->first ||
+                current_it->second.content_hash != previous_it->second.content_hash) {
+                diff.global_changed = true;
+                break;
+            }
+        }
+    }
+
+    for (const auto& [package, state] : packages) {
+        auto it = previous.packages.find(package);
+        if (it == previous.packages.end()) {
+            diff.added_packages.push_back(package);
+        } else if (it->second.content_hash != state.content_hash) {
+            diff.modified_packages.push_back(package);
+        }
+    }
+    for (const auto& [package, _] : previous.packages) {
+        if (packages.find(package) == packages.end()) {
+            diff.removed_packages.push_back(package);
+        }
+    }
+
+    return diff;
+}
+
+std::string WorkspaceManifest::PackageOfLabel(const std::string& label) {
+    size_t start = 0;
+    if (label.rfind("//", 0) == 0) {
+        start = 2;
+    }
+    const size_t colon = label.find(':', start);
+    return label.substr(start, colon == std::string::npos ? std::string::npos : colon - start);
+}
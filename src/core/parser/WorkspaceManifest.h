@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// 单个输入文件的状态：mtime + size 用于快速判断是否需要重新读取，内容哈希用于确认是否真的变化
+struct WorkspaceFileState {
+    long long mtime{0};
+    std::uint64_t size{0};
+    std::uint64_t content_hash{0};
+
+    bool operator==(const WorkspaceFileState& other) const {
+        return mtime == other.mtime && size == other.size && content_hash == other.content_hash;
+    }
+    bool operator!=(const WorkspaceFileState& other) const { return !(*this == other); }
+};
+
+// 两次扫描之间的内容差异（只比较内容哈希，单纯 touch 不算变化）
+struct WorkspaceManifestDiff {
+    bool global_changed{false};                 // WORKSPACE / MODULE.bazel / *.bzl 有变化
+    std::vector<std::string> added_packages;    // 新出现的包
+    std::vector<std::string> modified_packages; // BUILD 内容变化的包
+    std::vector<std::string> removed_packages;  // 已删除的包
+
+    bool Empty() const {
+        return !global_changed && added_packages.empty() && modified_packages.empty() &&
+               removed_packages.empty();
+    }
+};
+
+// 工作区输入文件清单：每个包的 BUILD 文件状态 + 影响所有包的全局输入
+struct WorkspaceManifest {
+    // 包路径（相对工作区，根包为空串）-> BUILD / BUILD.bazel 状态
+    std::map<std::string, WorkspaceFileState> packages;
+    // 全局输入（相对路径）-> 状态；.bzl 可能被任意包 load，保守地视为全局输入
+    std::map<std::string, WorkspaceFileState> global_files;
+
+    // 扫描工作区；previous 中 mtime 与 size 都未变的文件直接沿用其哈希，不再读取内容
+    static WorkspaceManifest Scan(const std::string& workspace_path,
+                                  const WorkspaceManifest* previous = nullptr);
+
+    // 只重新读取给定的文件（相对工作区路径），文件已删除时移除对应条目；其余条目保持不变
+    void Refresh(const std::string& workspace_path, const std::vector<std::string>& relative_files);
+
+    // 计算相对 previous 的内容差异
+    WorkspaceManifestDiff DiffFrom(const WorkspaceManifest& previous) const;
+
+    // 清单内容的 64 位指纹（包路径 + 内容哈希），与 mtime 无关
+    std::uint64_t Fingerprint() const;
+
+    // 标签所属的包路径，例如 //a/b:c -> a/b，//:c -> ""
+    static std::string PackageOfLabel(const std::string& label);
+
+    static bool IsBuildFileName(const std::string& filename);
+    static bool IsGlobalInputName(const std::string& filename);
+
+    // 扫描时跳过的目录：.git、根目录下的 bazel-* 便捷链接以及 .bazelignore 中列出的路径
+    static std::vector<std::string> LoadIgnoredDirectories(const std::string& workspace_path);
+    static bool IsIgnoredDirectory(const std::string& relative_dir, const std::vector<std::string>& ignored);
+
+    bool operator==(const WorkspaceManifest& other) const {
+        return packages == other.packages && global_files == other.global_files;
+    }
+    bool operator!=(const WorkspaceManifest& other) const { return !(*this == other); }
+};
@@ -0,0 +1,330 @@
+#include "WorkspaceSnapshot.h"
+
+#include "log/logger.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kSnapshotMagic[8] = {'B', 'D', 'C', 'S', 'N', 'A', 'P', '\0'};
+constexpr const char* kSnapshotExtension = ".snapshot";
+// 同时作为字节序标记：在不同字节序机器上读出的值不同，快照自然失效
+constexpr std::uint32_t kEndianMarker = 0x01020304u;
+
+std::uint64_t HashKey(const std::string& value) {
+    std::uint64_t hash = 1469598103934665603ull;
+    for (unsigned char ch : value) {
+        hash ^= ch;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+class SnapshotWriter {
+public:
+    void WriteBytes(const void* data, size_t size) {
+        buffer_.append(static_cast<const char*>(data), size);
+    }
+
+    void WriteU32(std::uint32_t value) {
+        WriteBytes(&value, sizeof(value));
+    }
+
+    void WriteU64(std::uint64_t value) {
+        WriteBytes(&value, sizeof(value));
+    }
+
+    void WriteString(const std::string& value) {
+        WriteU32(static_cast<std::uint32_t>(value.size()));
+        buffer_.append(value);
+    }
+
+    void WriteStringList(const std::vector<std::string>& values) {
+        WriteU32(static_cast<std::uint32_t>(values.size()));
+        for (const auto& value : values) {
+            WriteString(value);
+        }
+    }
+
+    void WriteFileStates(const std::map<std::string, WorkspaceFileState>& files) {
+        WriteU32(static_cast<std::uint32_t>(files.size()));
+        for (const auto& [path, state] : files) {
+            WriteString(path);
+            WriteU64(static_cast<std::uint64_t>(state.mtime));
+            WriteU64(state.size);
+            WriteU64(state.content_hash);
+        }
+    }
+
+    const std::string& Buffer() const { return buffer_; }
+
+private:
+    std::string buffer_;
+};
+
+class SnapshotReader {
+public:
+    explicit SnapshotReader(std::string_view data) : data_(data) {}
+
+    bool ReadBytes(void* output, size_t size) {
+        if (data_.size() - pos_ < size) {
+            return false;
+        }
+        std::memcpy(output, data_.data() + pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+    bool ReadU32(std::uint32_t& value) {
+        return ReadBytes(&value, sizeof(value));
+    }
+
+    bool ReadU64(std::uint64_t& value) {
+        return ReadBytes(&value, sizeof(value));
+    }
+
+    bool ReadString(std::string& value) {
+        std::uint32_t size = 0;
+        if (!ReadU32(size) || data_.size() - pos_ < size) {
+            return false;
+        }
+        value.assign(data_.data() + pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+    bool ReadStringList(std::vector<std::string>& values) {
+        std::uint32_t count = 0;
+        if (!ReadU32(count) || count > data_.size() - pos_) {
+            return false;
+        }
+        values.resize(count);
+        for (auto& value : values) {
+            if (!ReadString(value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ReadFileStates(std::map<std::string, WorkspaceFileState>& files) {
+        std::uint32_t count = 0;
+        if (!ReadU32(count) || count > data_.size() - pos_) {
+            return false;
+        }
+        files.clear();
+        for (std::uint32_t index = 0; index < count; ++index) {
+            std::string path;
+            std::uint64_t mtime = 0;
+            WorkspaceFileState state;
+            if (!ReadString(path) || !ReadU64(mtime) || !ReadU64(state.size) ||
+                !ReadU64(state.content_hash)) {
+                return false;
+            }
+            state.mtime = static_cast<long long>(mtime);
+            files.emplace_hint(files.end(), std::move(path), state);
+        }
+        return true;
+    }
+
+    bool AtEnd() const { return pos_ == data_.size(); }
+
+private:
+    std::string_view data_;
+    size_t pos_{0};
+};
+
+}  // namespace
+
+fs::path WorkspaceSnapshot::GetCacheDirectory() {
+    if (const char* override_dir = std::getenv("BAZEL_DEPS_CHECKER_CACHE_DIR");
+        override_dir != nullptr && override_dir[0] != '\0') {
+        return fs::path(override_dir);
+    }
+    if (const char* xdg_cache = std::getenv("XDG_CACHE_HOME"); xdg_cache != nullptr && xdg_cache[0] != '\0') {
+        return fs::path(xdg_cache) / "bazel-deps-checker";
+    }
+    if (const char* home = std::getenv("HOME"); home != nullptr && home[0] != '\0') {
+        return fs::path(home) / ".cache" / "bazel-deps-checker";
+    }
+
+    std::error_code ec;
+    const fs::path temp_dir = fs::temp_directory_path(ec);
+    if (!ec) {
+        return temp_dir / "bazel-deps-checker-cache";
+    }
+    return fs::path("bazel-deps-checker-cache");
+}
+
+fs::path WorkspaceSnapshot::GetSnapshotPath(const std::string& cache_key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(HashKey(cache_key)));
+    return GetCacheDirectory() / (std::string("workspace-") + name + kSnapshotExtension);
+}
+
+bool WorkspaceSnapshot::Load(const std::string& cache_key,
+                             std::unordered_map<std::string, BazelTarget>& targets,
+                             WorkspaceManifest& manifest) {
+    const fs::path snapshot_path = GetSnapshotPath(cache_key);
+    std::ifstream input(snapshot_path, std::ios::binary | std::ios::ate);
+    if (!input) {
+        return false;
+    }
+
+    const std::streamsize file_size = input.tellg();
+    if (file_size <= 0) {
+        return false;
+    }
+    std::string data(static_cast<size_t>(file_size), '\0');
+    input.seekg(0);
+    if (!input.read(data.data(), file_size)) {
+        return false;
+    }
+
+    SnapshotReader reader(data);
+    char magic[sizeof(kSnapshotMagic)];
+    std::uint32_t endian_marker = 0;
+    std::uint32_t version = 0;
+    std::string stored_key;
+    if (!reader.ReadBytes(magic, sizeof(magic)) ||
+        std::memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0 ||
+        !reader.ReadU32(endian_marker) || endian_marker != kEndianMarker ||
+        !reader.ReadU32(version) || version != kFormatVersion ||
+        !reader.ReadString(stored_key) || stored_key != cache_key) {
+        return false;
+    }
+
+    WorkspaceManifest stored_manifest;
+    if (!reader.ReadFileStates(stored_manifest.packages) ||
+        !reader.ReadFileStates(stored_manifest.global_files)) {
+        LOG_WARN("Corrupted workspace snapshot: " + snapshot_path.string());
+        return false;
+    }
+
+    std::uint32_t target_count = 0;
+    if (!reader.ReadU32(target_count)) {
+        return false;
+    }
+
+    std::unordered_map<std::string, BazelTarget> loaded;
+    loaded.reserve(target_count);
+    for (std::uint32_t index = 0; index < target_count; ++index) {
+        BazelTarget target;
+        if (!reader.ReadString(target.name) ||
+            !reader.ReadString(target.path) ||
+            !reader.ReadString(target.full_label) ||
+            !reader.ReadString(target.rule_type) ||
+            !reader.ReadStringList(target.deps) ||
+            !reader.ReadStringList(target.srcs) ||
+            !reader.ReadStringList(target.hdrs)) {
+            LOG_WARN("Corrupted workspace snapshot: " + snapshot_path.string());
+            return false;
+        }
+        std::string label = target.full_label;
+        loaded.emplace(std::move(label), std::move(target));
+    }
+
+    if (!reader.AtEnd()) {
+        LOG_WARN("Corrupted workspace snapshot: " + snapshot_path.string());
+        return false;
+    }
+
+    targets = std::move(loaded);
+    manifest = std::move(stored_manifest);
+    return true;
+}
+
+bool WorkspaceSnapshot::Save(const std::string& cache_key,
+                             const WorkspaceManifest& manifest,
+                             const std::unordered_map<std::string, BazelTarget>& targets) {
+    SnapshotWriter writer;
+    writer.WriteBytes(kSnapshotMagic, sizeof(kSnapshotMagic));
+    writer.WriteU32(kEndianMarker);
+    writer.WriteU32(kFormatVersion);
+    writer.WriteString(cache_key);
+    writer.WriteFileStates(manifest.packages);
+    writer.WriteFileStates(manifest.global_files);
+    writer.WriteU32(static_cast<std::uint32_t>(targets.size()));
+    for (const auto& [_, target] : targets) {
+        writer.WriteString(target.name);
+        writer.WriteString(target.path);
+        writer.WriteString(target.full_label);
+        writer.WriteString(target.rule_type);
+        writer.WriteStringList(target.deps);
+        writer.WriteStringList(target.srcs);
+        writer.WriteStringList(target.hdrs);
+    }
+
+    const fs::path snapshot_path = GetSnapshotPath(cache_key);
+    std::error_code ec;
+    fs::create_directories(snapshot_path.parent_path(), ec);
+    if (ec) {
+        LOG_WARN("Failed to create snapshot directory: " + snapshot_path.parent_path().string());
+        return false;
+    }
+
+    // 同一进程内可能同时保存同一快照（例如同一工作区的并发 --ui 任务），临时文件名再加序号
+    static std::atomic<std::uint64_t> save_sequence{0};
+    fs::path temp_path = snapshot_path;
+    temp_path += ".tmp." + std::to_string(::getpid()) + "." +
+                 std::to_string(save_sequence.fetch_add(1, std::memory_order_relaxed));
+    {
+        std::ofstream output(temp_path, std::ios::binary | std::ios::trunc);
+        if (!output) {
+            LOG_WARN("Failed to write workspace snapshot: " + temp_path.string());
+            return false;
+        }
+        const std::string& buffer = writer.Buffer();
+        output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!output) {
+            output.close();
+            fs::remove(temp_path, ec);
+            LOG_WARN("Failed to write workspace snapshot: " + temp_path.string());
+            return false;
+        }
+    }
+
+    fs::rename(temp_path, snapshot_path, ec);
+    if (ec) {
+        fs::remove(temp_path, ec);
+        LOG_WARN("Failed to publish workspace snapshot: " + snapshot_path.string());
+        return false;
+    }
+    return true;
+}
+
+void WorkspaceSnapshot::ClearAll() {
+    const fs::path cache_dir = GetCacheDirectory();
+    std::error_code ec;
+    for (fs::directory_iterator it(cache_dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string filename = it->path().filename().string();
+        if (filename.rfind("workspace-", 0) == 0 &&
+            filename.find(kSnapshotExtension) != std::string::npos) {
+            std::error_code remove_ec;
+            fs::remove(it->path(), remove_ec);
+        }
+    }
+}
+
+size_t WorkspaceSnapshot::Count() {
+    const fs::path cache_dir = GetCacheDirectory();
+    size_t count = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(cache_dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const fs::path& path = it->path();
+        if (path.extension() == kSnapshotExtension &&
+            path.filename().string().rfind("workspace-", 0) == 0) {
+            ++count;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+#include "struct.h"
+#include "parser/WorkspaceManifest.h"
+
+// 解析结果的磁盘快照：让新进程在工作区未变化时跳过 bazel query。
+// 文件按缓存 key 命名，内部记录格式版本与生成时的工作区清单，调用方据此判断哪些包需要重新查询。
+class WorkspaceSnapshot {
+public:
+    // 格式变化时递增，旧版本快照会被直接忽略
+    static constexpr std::uint32_t kFormatVersion = 2;
+
+    // 快照目录：$BAZEL_DEPS_CHECKER_CACHE_DIR > $XDG_CACHE_HOME/bazel-deps-checker
+    //          > ~/.cache/bazel-deps-checker > 系统临时目录
+    static std::filesystem::path GetCacheDirectory();
+
+    // 读取快照（整个文件一次读入），版本或 key 不匹配时返回 false
+    static bool Load(const std::string& cache_key,
+                     std::unordered_map<std::string, BazelTarget>& targets,
+                     WorkspaceManifest& manifest);
+
+    // 写入快照（先写临时文件再 rename，避免并发进程读到半截文件）
+    static bool Save(const std::string& cache_key,
+                     const WorkspaceManifest& manifest,
+                     const std::unordered_map<std::string, BazelTarget>& targets);
+
+    // 删除所有快照文件
+    static void ClearAll();
+
+    // 当前磁盘上的快照数量
+    static size_t Count();
+
+private:
+    static std::filesystem::path GetSnapshotPath(const std::string& cache_key);
+};
@@ -0,0 +1,360 @@
+#include "WorkspaceWatcher.h"
+
+#include "log/logger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 一个 --ui 进程同时监听的工作区上限，超出后新工作区退回到完整扫描
+constexpr size_t kMaxWatchedWorkspaces = 16;
+
+struct WatcherRegistry {
+    std::mutex mutex;
+    bool enabled{false};
+    // 启动失败的工作区记为 nullptr，避免每个请求都重新尝试一次完整的目录遍历
+    std::unordered_map<std::string, std::shared_ptr<WorkspaceWatcher>> watchers;
+};
+
+WatcherRegistry& GetWatcherRegistry() {
+    static WatcherRegistry registry;
+    return registry;
+}
+
+std::string NormalizeWorkspacePath(const std::string& workspace_path) {
+    std::error_code ec;
+    const fs::path canonical = fs::weakly_canonical(fs::absolute(workspace_path, ec), ec);
+    return ec ? workspace_path : canonical.string();
+}
+
+bool IsTrackedSourceName(const std::string& filename) {
+    static const char* const kExtensions[] = {
+        ".c", ".cc", ".cpp", ".cxx", ".c++", ".m", ".mm",
+        ".h", ".hh", ".hpp", ".hxx", ".h++", ".inc", ".inl",
+    };
+    const size_t dot = filename.find_last_of('.');
+    if (dot == std::string::npos) {
+        return false;
+    }
+    std::string extension = filename.substr(dot);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+    return std::find(std::begin(kExtensions), std::end(kExtensions), extension) != std::end(kExtensions);
+}
+
+std::string JoinRelative(const std::string& directory, const std::string& name) {
+    return directory.empty() ? name : directory + "/" + name;
+}
+
+}  // namespace
+
+void WorkspaceWatcher::SetEnabled(bool enabled) {
+    auto& registry = GetWatcherRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.enabled = enabled;
+    if (!enabled) {
+        registry.watchers.clear();
+    }
+}
+
+std::shared_ptr<WorkspaceWatcher> WorkspaceWatcher::Acquire(const std::string& workspace_path) {
+    auto& registry = GetWatcherRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (!registry.enabled) {
+        return nullptr;
+    }
+
+    const std::string key = NormalizeWorkspacePath(workspace_path);
+    auto it = registry.watchers.find(key);
+    if (it != registry.watchers.end()) {
+        if (it->second && !it->second->IsLive()) {
+            it->second.reset();
+        }
+        return it->second;
+    }
+    if (registry.watchers.size() >= kMaxWatchedWorkspaces) {
+        return nullptr;
+    }
+
+    std::shared_ptr<WorkspaceWatcher> watcher(new WorkspaceWatcher(key));
+    if (!watcher->Start()) {
+        watcher.reset();
+    }
+    registry.watchers[key] = watcher;
+    return watcher;
+}
+
+size_t WorkspaceWatcher::ActiveCount() {
+    auto& registry = GetWatcherRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return static_cast<size_t>(std::count_if(
+        registry.watchers.begin(), registry.watchers.end(),
+        [](const auto& entry) { return entry.second && entry.second->IsLive(); }));
+}
+
+WorkspaceWatcher::WorkspaceWatcher(std::string workspace_path)
+    : workspace_path_(std::move(workspace_path)) {
+}
+
+WorkspaceWatcher::~WorkspaceWatcher() {
+    Stop();
+}
+
+WorkspaceManifest WorkspaceWatcher::CurrentManifest() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (full_rescan_) {
+        manifest_ = WorkspaceManifest::Scan(workspace_path_, &manifest_);
+        full_rescan_ = false;
+        dirty_inputs_.clear();
+    } else if (!dirty_inputs_.empty()) {
+        manifest_.Refresh(workspace_path_,
+                          std::vector<std::string>(dirty_inputs_.begin(), dirty_inputs_.end()));
+        dirty_inputs_.clear();
+    }
+    return manifest_;
+}
+
+std::vector<std::string> WorkspaceWatcher::ChangedFilesSince(std::uint64_t generation) const {
+    std::vector<std::string> changed;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [path, changed_at] : change_log_) {
+        if (changed_at > generation) {
+            changed.push_back(path);
+        }
+    }
+    return changed;
+}
+
+void WorkspaceWatcher::RecordChange(const std::string& relative_path, bool manifest_input) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::uint64_t generation = generation_.load(std::memory_order_relaxed) + 1;
+    change_log_[relative_path] = generation;
+    if (manifest_input) {
+        dirty_inputs_.insert(relative_path);
+    }
+    generation_.store(generation, std::memory_order_release);
+}
+
+#ifdef __linux__
+
+namespace {
+
+constexpr std::uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM |
+                                     IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW;
+
+}  // namespace
+
+bool WorkspaceWatcher::Start() {
+    ignored_directories_ = WorkspaceManifest::LoadIgnoredDirectories(workspace_path_);
+
+    inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+        LOG_WARN("inotify unavailable (" + std::string(std::strerror(errno)) +
+                 "), falling back to workspace scans for " + workspace_path_);
+        return false;
+    }
+    if (::pipe2(wake_pipe_, O_NONBLOCK | O_CLOEXEC) != 0 || !AddWatchesRecursive("")) {
+        Stop();
+        return false;
+    }
+
+    // 先建立 watch 再做初次扫描，期间发生的修改会以事件形式补上
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        manifest_ = WorkspaceManifest::Scan(workspace_path_);
+    }
+    live_.store(true, std::memory_order_release);
+    loop_thread_ = std::thread(&WorkspaceWatcher::EventLoop, this);
+    LOG_INFO("Watching workspace " + workspace_path_ + " (" + std::to_string(watch_dirs_.size()) +
+             " directories)");
+    return true;
+}
+
+void WorkspaceWatcher::Stop() {
+    live_.store(false, std::memory_order_release);
+    if (loop_thread_.joinable()) {
+        const char byte = 1;
+        [[maybe_unused]] const ssize_t written = ::write(wake_pipe_[1], &byte, 1);
+        loop_thread_.join();
+    }
+    for (int* fd : {&inotify_fd_, &wake_pipe_[0], &wake_pipe_[1]}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    watch_dirs_.clear();
+}
+
+bool WorkspaceWatcher::AddWatchesRecursive(const std::string& relative_dir) {
+    const fs::path workspace(workspace_path_);
+    const auto add_watch = [&](const fs::path& directory, const std::string& relative) {
+        const int wd = ::inotify_add_watch(inotify_fd_, directory.c_str(), kWatchMask);
+        if (wd >= 0) {
+            watch_dirs_[wd] = relative;
+            return true;
+        }
+        if (errno == ENOSPC || errno == ENOMEM) {
+            LOG_WARN("inotify watch limit reached for " + workspace_path_ +
+                     " (raise fs.inotify.max_user_watches), falling back to workspace scans");
+            return false;
+        }
+        // 目录在遍历过程中被删除等情况，由后续事件处理
+        return true;
+    };
+
+    const fs::path root = relative_dir.empty() ? workspace : workspace / relative_dir;
+    if (!add_watch(root, relative_dir)) {
+        return false;
+    }
+
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(root, ec), end; it != end; it.increment(ec)) {
+        if (ec) {
+            break;
+        }
+        if (!it->is_directory(ec) || it->is_symlink(ec)) {
+            continue;
+        }
+        const std::string relative = it->path().lexically_relative(workspace).generic_string();
+        if (WorkspaceManifest::IsIgnoredDirectory(relative, ignored_directories_)) {
+            it.disable_recursion_pending();
+            continue;
+        }
+        if (!add_watch(it->path(), relative)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void WorkspaceWatcher::ResetWatches() {
+    for (const auto& [wd, _] : watch_dirs_) {
+        ::inotify_rm_watch(inotify_fd_, wd);
+    }
+    watch_dirs_.clear();
+    if (!AddWatchesRecursive("")) {
+        live_.store(false, std::memory_order_release);
+    }
+}
+
+void WorkspaceWatcher::EventLoop() {
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    while (live_.load(std::memory_order_acquire)) {
+        pollfd fds[2] = {{inotify_fd_, POLLIN, 0}, {wake_pipe_[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_WARN("Workspace watcher poll failed: " + std::string(std::strerror(errno)));
+            live_.store(false, std::memory_order_release);
+            break;
+        }
+        if (fds[1].revents != 0) {
+            break;
+        }
+
+        while (true) {
+            const ssize_t length = ::read(inotify_fd_, buffer, sizeof(buffer));
+            if (length <= 0) {
+                break;
+            }
+            HandleEvents(buffer, static_cast<size_t>(length));
+        }
+    }
+}
+
+void WorkspaceWatcher::HandleEvents(const char* buffer, size_t length) {
+    bool reset_watches = false;
+    for (size_t offset = 0; offset < length;) {
+        const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+        offset += sizeof(struct inotify_event) + event->len;
+
+        if ((event->mask & IN_Q_OVERFLOW) != 0) {
+            // 事件丢失：无法知道具体变化，整体重扫
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                full_rescan_ = true;
+            }
+            RecordChange("", false);
+            continue;
+        }
+        if ((event->mask & IN_IGNORED) != 0) {
+            watch_dirs_.erase(event->wd);
+            continue;
+        }
+
+        const auto dir_it = watch_dirs_.find(event->wd);
+        if (dir_it == watch_dirs_.end() || event->len == 0) {
+            continue;
+        }
+        const std::string name(event->name);
+        const std::string relative = JoinRelative(dir_it->second, name);
+
+        if ((event->mask & IN_ISDIR) != 0) {
+            if (WorkspaceManifest::IsIgnoredDirectory(relative, ignored_directories_)) {
+                continue;
+            }
+            if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+                if (!AddWatchesRecursive(relative)) {
+                    live_.store(false, std::memory_order_release);
+                }
+            } else if ((event->mask & IN_MOVED_FROM) != 0) {
+                // 目录改名后旧 watch 仍指向原路径，批处理结束后整体重建
+                reset_watches = true;
+            }
+            // 目录增删可能带走或带来整包 BUILD 文件
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                full_rescan_ = true;
+            }
+            RecordChange(relative, false);
+            continue;
+        }
+
+        if (name == ".bazelignore" && dir_it->second.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                full_rescan_ = true;
+            }
+            RecordChange(relative, false);
+            continue;
+        }
+
+        const bool manifest_input =
+            WorkspaceManifest::IsBuildFileName(name) || WorkspaceManifest::IsGlobalInputName(name);
+        if (manifest_input || IsTrackedSourceName(name)) {
+            RecordChange(relative, manifest_input);
+        }
+    }
+
+    if (reset_watches) {
+        ResetWatches();
+    }
+}
+
+#else
+
+bool WorkspaceWatcher::Start() {
+    return false;
+}
+
+void WorkspaceWatcher::Stop() {
+    live_.store(false, std::memory_order_release);
+}
+
+#endif
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "parser/WorkspaceManifest.h"
+
+// 工作区变更跟踪器：初次完整扫描一次，之后通过 inotify 增量维护 BUILD / 全局输入的清单，
+// 并记录变化的源文件。调用方用 Generation() 做 O(1) 的缓存有效性判断，
+// 用 ChangedFilesSince() 取得精确的变更文件列表。
+//
+// 只在 --ui 常驻进程中启用（SetEnabled）；非 Linux 平台、inotify 不可用或 watch 数量超限时
+// Acquire() 返回空指针，调用方退回到 WorkspaceManifest::Scan。
+class WorkspaceWatcher {
+public:
+    // 开启 / 关闭全局监听；关闭时停止所有已有的 watcher
+    static void SetEnabled(bool enabled);
+
+    // 获取工作区共享的 watcher，不存在时创建；未启用或不可用时返回 nullptr
+    static std::shared_ptr<WorkspaceWatcher> Acquire(const std::string& workspace_path);
+
+    // 正在运行的 watcher 数量
+    static size_t ActiveCount();
+
+    WorkspaceWatcher(const WorkspaceWatcher&) = delete;
+    WorkspaceWatcher& operator=(const WorkspaceWatcher&) = delete;
+    ~WorkspaceWatcher();
+
+    // 任一被跟踪文件（BUILD、全局输入、C/C++ 源文件与头文件）变化时递增
+    std::uint64_t Generation() const { return generation_.load(std::memory_order_acquire); }
+
+    // 当前的输入文件清单：只重新读取上次调用以来有变化的 BUILD / 全局输入
+    WorkspaceManifest CurrentManifest();
+
+    // generation 之后变化过的文件（相对工作区路径，升序）
+    std::vector<std::string> ChangedFilesSince(std::uint64_t generation) const;
+
+    // 运行中新增目录超出 watch 上限等情况下不再可靠，调用方应改用完整扫描
+    bool IsLive() const { return live_.load(std::memory_order_acquire); }
+
+private:
+    explicit WorkspaceWatcher(std::string workspace_path);
+
+    bool Start();
+    void Stop();
+    void EventLoop();
+    void HandleEvents(const char* buffer, size_t length);
+    bool AddWatchesRecursive(const std::string& relative_dir);
+    void ResetWatches();
+    void RecordChange(const std::string& relative_path, bool manifest_input);
+
+    const std::string workspace_path_;
+    std::vector<std::string> ignored_directories_;
+
+    mutable std::mutex mutex_;
+    WorkspaceManifest manifest_;
+    std::set<std::string> dirty_inputs_;              // 待重新读取的 BUILD / 全局输入
+    bool full_rescan_{false};                         // 目录增删 / 事件队列溢出后整体重扫
+    std::map<std::string, std::uint64_t> change_log_; // 文件 -> 最近一次变化时的 generation
+    std::atomic<std::uint64_t> generation_{0};
+    std::atomic<bool> live_{false};
+
+    // 以下只在事件线程（及启动阶段）访问
+    int inotify_fd_{-1};
+    int wake_pipe_[2]{-1, -1};
+    std::unordered_map<int, std::string> watch_dirs_; // watch 描述符 -> 相对目录
+    std::thread loop_thread_;
+};
@@ -3,27 +3,50 @@
 #include "analysis/BuildTimeAnalyzer.h"
 #include "analysis/CycleDetector.h"
 #include "graph/DependencyGraph.h"
+#include "graph/GraphSnapshot.h"
+#include "graph/TargetTable.h"
+#include "log/logger.h"
 #include "output/OutputReport.h"
 #include "parser/AdvancedBazelQueryParser.h"
+#include "parser/WorkspaceManifest.h"
+#include "parser/WorkspaceSnapshot.h"
+#include "parser/WorkspaceWatcher.h"
 
-#include <filesystem>
 #include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <future>
 #include <mutex>
 #include <memory>
+#include <system_error>
 #include <unordered_map>
 #include <utility>
 
 namespace {
 
+// 一个工作区的依赖分析快照。构建完成后只以 const 形式发布，目标表与图结构不再变化；
+// 图和 CycleDetector 内部的按需缓存（传递闭包、边级别判定、整轮分析结果）都是线程安全的，
+// 因此多个请求线程可以同时读取同一个已预热的上下文，不需要外部加锁
 struct DependencyAnalysisContext {
-    std::unordered_map<std::string, BazelTarget> targets;
-    std::shared_ptr<DependencyGraph> dependency_graph;
-    std::shared_ptr<CycleDetector> cycle_detector;
+    // 解析结果转成驻留后的目标表后即释放逐目标的字符串映射
+    TargetTable targets;
+    std::shared_ptr<const DependencyGraph> dependency_graph;
+    std::shared_ptr<const CycleDetector> cycle_detector;
 };
 
+using SharedDependencyContext = std::shared_ptr<const DependencyAnalysisContext>;
+
 struct CachedDependencyContext {
-    std::shared_ptr<DependencyAnalysisContext> context;
+    SharedDependencyContext context;
+    std::string fingerprint;
+    WorkspaceManifest manifest;     // 非 watch 模式下用作下一次扫描的提示
+};
+
+// 正在构建的上下文：同一工作区、同一指纹的并发请求等待同一次构建，而不是各自解析工作区
+struct PendingDependencyContext {
     std::string fingerprint;
+    std::shared_future<SharedDependencyContext> context;
 };
 
 std::mutex& GetDependencyContextMutex() {
@@ -36,56 +59,187 @@ std::unordered_map<std::string, CachedDependencyContext>& GetDependencyContextCa
     return cache;
 }
 
+std::unordered_map<std::string, PendingDependencyContext>& GetPendingDependencyContexts() {
+    static std::unordered_map<std::string, PendingDependencyContext> pending;
+    return pending;
+}
+
 std::string BuildDependencyContextKey(const CommandLineArgs& args) {
-    return args.workspace_path + '\n' + args.bazel_binary;
+    return args.workspace_path + '\n' + args.bazel_binary + '\n' +
+           CommandLineArgs::ParseStrategyToString(args.parse_strategy);
 }
 
-std::string BuildWorkspaceFingerprint(const std::string& workspace_path) {
-    namespace fs = std::filesystem;
+// 依赖上下文的有效性指纹。--ui 模式下取 watcher 的变更计数（O(1)，源文件变化也会使上下文失效）；
+// 否则扫描工作区清单，previous 中 mtime 与 size 未变的文件沿用哈希，只做 stat
+std::string BuildWorkspaceFingerprint(const std::string& workspace_path,
+                                      const WorkspaceManifest* previous,
+                                      WorkspaceManifest& manifest) {
+    if (const auto watcher = WorkspaceWatcher::Acquire(workspace_path)) {
+        return "watch:" + std::to_string(watcher->Generation());
+    }
+    manifest = WorkspaceManifest::Scan(workspace_path, previous);
+    return "manifest:" + std::to_string(manifest.Fingerprint());
+}
 
-    fs::path workspace(workspace_path);
-    if (!fs::exists(workspace) || !fs::is_directory(workspace)) {
-        return "missing";
+// watch 模式下依赖上下文失效时记录具体变化的文件，便于排查缓存未命中
+void LogWorkspaceChanges(const std::string& workspace_path, const std::string& previous_fingerprint) {
+    static const std::string kWatchPrefix = "watch:";
+    if (previous_fingerprint.rfind(kWatchPrefix, 0) != 0) {
+        return;
+    }
+    const auto watcher = WorkspaceWatcher::Acquire(workspace_path);
+    if (!watcher) {
+        return;
     }
+    const auto changed = watcher->ChangedFilesSince(
+        std::stoull(previous_fingerprint.substr(kWatchPrefix.size())));
+    std::string preview;
+    for (size_t index = 0; index < changed.size() && index < 5; ++index) {
+        preview += (index == 0 ? "" : ", ") + (changed[index].empty() ? std::string(".") : changed[index]);
+    }
+    LOG_INFO("Workspace changed (" + std::to_string(changed.size()) + " files: " + preview +
+             (changed.size() > 5 ? ", ..." : "") + "), rebuilding dependency context");
+}
 
-    uintmax_t file_count = 0;
-    long long latest_write = 0;
-    auto update_from_path = [&](const fs::path& path) {
-        std::error_code ec;
-        const auto time = fs::last_write_time(path, ec);
-        if (ec) {
-            return;
-        }
-        const auto raw = time.time_since_epoch().count();
-        if (raw > latest_write) {
-            latest_write = raw;
+// 上一版本的上下文能否增量继承：两次之间只有 BUILD / 全局输入变化，源文件未变。
+// 清单指纹本身只覆盖这两类文件；watch 模式下逐个检查变化过的文件
+bool OnlyBuildInputsChanged(const std::string& workspace_path, const std::string& previous_fingerprint) {
+    static const std::string kWatchPrefix = "watch:";
+    if (previous_fingerprint.rfind(kWatchPrefix, 0) != 0) {
+        return true;
+    }
+    const auto watcher = WorkspaceWatcher::Acquire(workspace_path);
+    if (!watcher || !watcher->IsLive()) {
+        return false;
+    }
+    for (const auto& file : watcher->ChangedFilesSince(
+             std::stoull(previous_fingerprint.substr(kWatchPrefix.size())))) {
+        const std::string name = std::filesystem::path(file).filename().string();
+        if (!WorkspaceManifest::IsBuildFileName(name) && !WorkspaceManifest::IsGlobalInputName(name)) {
+            return false;
         }
-        ++file_count;
-    };
+    }
+    return true;
+}
 
-    for (const auto& name : {"WORKSPACE", "WORKSPACE.bazel", "MODULE.bazel"}) {
-        fs::path path = workspace / name;
-        if (fs::exists(path)) {
-            update_from_path(path);
-        }
+// 图快照的有效性指纹：BUILD / 全局输入的内容指纹，与 mtime 无关。scanned 为非 watch 模式下已扫描的清单
+std::uint64_t BuildInputsFingerprint(const std::string& workspace_path, const WorkspaceManifest& scanned) {
+    if (const auto watcher = WorkspaceWatcher::Acquire(workspace_path)) {
+        return watcher->CurrentManifest().Fingerprint();
     }
+    return scanned.Fingerprint();
+}
 
+// 图快照的 key：目标表中的源文件与头文件路径都是以工作区为前缀的绝对路径，
+// 因此与解析快照一样带上规范化后的工作区路径，工作区换了位置的快照不会被误用
+std::string BuildGraphSnapshotKey(const CommandLineArgs& args) {
     std::error_code ec;
-    for (fs::recursive_directory_iterator it(workspace, ec), end; it != end; it.increment(ec)) {
-        if (ec) {
-            break;
-        }
-        if (!it->is_regular_file()) {
-            continue;
-        }
+    const std::filesystem::path absolute_path =
+        std::filesystem::weakly_canonical(std::filesystem::absolute(args.workspace_path, ec), ec);
+    return absolute_path.string() + '\n' + args.bazel_binary + '\n' +
+           CommandLineArgs::ParseStrategyToString(args.parse_strategy);
+}
+
+constexpr char kGraphSnapshotPrefix[] = "graph-";
+constexpr char kGraphSnapshotExtension[] = ".graph";
+
+// --graph-snapshot 指定的文件，否则按上下文 key 放在工作区快照所在的缓存目录
+std::filesystem::path GetGraphSnapshotPath(const CommandLineArgs& args) {
+    if (!args.graph_snapshot_path.empty()) {
+        return std::filesystem::path(args.graph_snapshot_path);
+    }
+    std::uint64_t hash = 1469598103934665603ull;
+    for (unsigned char ch : BuildDependencyContextKey(args)) {
+        hash ^= ch;
+        hash *= 1099511628211ull;
+    }
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+    return WorkspaceSnapshot::GetCacheDirectory() / (kGraphSnapshotPrefix + std::string(name) + kGraphSnapshotExtension);
+}
 
-        const std::string filename = it->path().filename().string();
-        if (filename == "BUILD" || filename == "BUILD.bazel") {
-            update_from_path(it->path());
+void ClearGraphSnapshots() {
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(WorkspaceSnapshot::GetCacheDirectory(), ec), end;
+         !ec && it != end; it.increment(ec)) {
+        const std::filesystem::path& path = it->path();
+        if (path.extension() == kGraphSnapshotExtension &&
+            path.filename().string().rfind(kGraphSnapshotPrefix, 0) == 0) {
+            std::error_code remove_ec;
+            std::filesystem::remove(path, remove_ec);
         }
     }
+}
 
-    return std::to_string(file_count) + ":" + std::to_string(latest_write);
+// 快照的 key 与指纹都匹配时还原目标表与依赖图，否则返回 nullptr
+std::shared_ptr<DependencyGraph> LoadGraphSnapshot(const std::filesystem::path& snapshot_path,
+                                                   const std::string& snapshot_key,
+                                                   std::uint64_t build_inputs_fingerprint,
+                                                   TargetTable& targets) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto snapshot = GraphSnapshot::Open(snapshot_path);
+    if (!snapshot) {
+        return nullptr;
+    }
+    if (snapshot->Key() != snapshot_key || snapshot->SourceFingerprint() != build_inputs_fingerprint) {
+        LOG_INFO("Graph snapshot is stale, re-parsing workspace: " + snapshot_path.string());
+        return nullptr;
+    }
+    if (!snapshot->RestoreTargetTable(targets)) {
+        return nullptr;
+    }
+    std::shared_ptr<DependencyGraph> dependency_graph = snapshot->RestoreGraph(targets);
+    if (!dependency_graph) {
+        targets = TargetTable();
+        return nullptr;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    LOG_INFO("Loaded dependency graph snapshot (" + std::to_string(snapshot->FileBytes() / 1024) + " KiB) in " +
+             std::to_string(elapsed.count()) + " ms: " + snapshot_path.string());
+    return dependency_graph;
+}
+
+// previous 非空时在其基础上增量更新：未受影响目标的源码分析与边级别缓存直接沿用。
+// 否则先尝试图快照；快照缺失或过期时解析工作区，并把结果写回快照供下一个进程使用
+SharedDependencyContext BuildDependencyAnalysisContext(const CommandLineArgs& args,
+                                                       const SharedDependencyContext& previous,
+                                                       std::uint64_t build_inputs_fingerprint) {
+    const std::filesystem::path snapshot_path = GetGraphSnapshotPath(args);
+    const std::string snapshot_key = BuildGraphSnapshotKey(args);
+    auto context = std::make_shared<DependencyAnalysisContext>();
+    std::shared_ptr<DependencyGraph> dependency_graph;
+    if (!previous) {
+        dependency_graph = LoadGraphSnapshot(snapshot_path, snapshot_key, build_inputs_fingerprint, context->targets);
+    }
+    const bool from_snapshot = dependency_graph != nullptr;
+    if (!from_snapshot) {
+        AdvancedBazelQueryParser parser(args.workspace_path, args.bazel_binary, args.parse_strategy);
+        context->targets = TargetTable::Build(parser.ParseWorkspace());
+        dependency_graph = std::make_shared<DependencyGraph>(context->targets);
+    }
+    LOG_INFO("Target table: " + std::to_string(context->targets.TargetCount()) + " targets, " +
+             std::to_string(context->targets.LabelCount()) + " labels, " +
+             std::to_string(context->targets.MemoryBytes() / 1024) + " KiB");
+    LOG_INFO("Dependency graph: " + std::to_string(dependency_graph->EdgeCount()) +
+             " edges, " + std::to_string(dependency_graph->MemoryBytes() / 1024) + " KiB");
+    DependencyGraph::CycleEnumerationOptions cycle_options;
+    cycle_options.max_cycles_per_component = args.max_cycles_per_scc;
+    cycle_options.deadline = std::chrono::seconds(args.cycle_timeout_seconds);
+    // CycleDetector 构造时把源码分析器挂到图上；缓存迁移完成后两者都只读
+    auto cycle_detector = std::make_shared<CycleDetector>(
+        *dependency_graph, context->targets, args.workspace_path, cycle_options);
+    if (previous) {
+        const TargetTableDelta delta = TargetTable::Diff(previous->targets, context->targets);
+        const std::vector<bool> affected = dependency_graph->ApplyDelta(*previous->dependency_graph, delta);
+        cycle_detector->InheritCaches(*previous->cycle_detector, delta, affected);
+    }
+    if (!from_snapshot && context->targets.TargetCount() != 0) {
+        GraphSnapshot::Save(snapshot_path, snapshot_key, build_inputs_fingerprint, context->targets, *dependency_graph);
+    }
+    context->dependency_graph = std::move(dependency_graph);
+    context->cycle_detector = std::move(cycle_detector);
+    return context;
 }
 
 }  // namespace
@@ -132,8 +286,18 @@ public:
 
     void analyzeCycles(const CommandLineArgs& args) {
         EnsureDependencyAnalysisReady(args);
-        auto cycles = cycle_detector_->AnalyzeCycles();
-        report_->GenerateCycleReport(cycles, args.output_format);
+        const CycleReportData cycles = AnalyzeCycleReport(args);
+        switch (cycles.mode) {
+            case CycleReportMode::SCC_SUMMARY:
+                report_->GenerateCycleReport(cycles.components, args.output_format);
+                break;
+            case CycleReportMode::FEEDBACK_ARCS:
+                report_->GenerateCycleReport(cycles.feedback_arcs, args.output_format);
+                break;
+            case CycleReportMode::CYCLES:
+                report_->GenerateCycleReport(cycles.cycles, args.output_format);
+                break;
+        }
     }
 
     std::string renderCycles(const CommandLineArgs& args, OutputFormat format) {
@@ -141,9 +305,9 @@ public:
         const auto total_start = std::chrono::steady_clock::now();
         EnsureDependencyAnalysisReady(args);
         const auto analysis_start = std::chrono::steady_clock::now();
-        auto cycles = cycle_detector_->AnalyzeCycles();
+        const CycleReportData cycles = AnalyzeCycleReport(args);
         const auto render_start = std::chrono::steady_clock::now();
-        const std::string rendered = report_->RenderCycleReport(cycles, format);
+        const std::string rendered = RenderCycleReport(cycles, format);
         FinalizePerformance(total_start, analysis_start, render_start);
         return rendered;
     }
@@ -153,11 +317,43 @@ public:
         const auto total_start = std::chrono::steady_clock::now();
         EnsureDependencyAnalysisReady(args);
         const auto analysis_start = std::chrono::steady_clock::now();
-        auto cycles = cycle_detector_->AnalyzeCycles();
+        const CycleReportData cycles = AnalyzeCycleReport(args);
+        const auto render_start = std::chrono::steady_clock::now();
+        auto reports = std::make_pair(
+            RenderCycleReport(cycles, OutputFormat::JSON),
+            RenderCycleReport(cycles, OutputFormat::HTML));
+        FinalizePerformance(total_start, analysis_start, render_start);
+        return reports;
+    }
+
+    void analyzeTransitiveReduction(const CommandLineArgs& args) {
+        EnsureDependencyAnalysisReady(args);
+        const TransitiveReductionAnalysis reduction = cycle_detector_->AnalyzeTransitiveReduction();
+        report_->GenerateTransitiveReductionReport(reduction, args.output_format);
+    }
+
+    std::string renderTransitiveReduction(const CommandLineArgs& args, OutputFormat format) {
+        ResetPerformance();
+        const auto total_start = std::chrono::steady_clock::now();
+        EnsureDependencyAnalysisReady(args);
+        const auto analysis_start = std::chrono::steady_clock::now();
+        const TransitiveReductionAnalysis reduction = cycle_detector_->AnalyzeTransitiveReduction();
+        const auto render_start = std::chrono::steady_clock::now();
+        const std::string rendered = report_->RenderTransitiveReductionReport(reduction, format);
+        FinalizePerformance(total_start, analysis_start, render_start);
+        return rendered;
+    }
+
+    std::pair<std::string, std::string> renderTransitiveReductionJsonAndHtml(const CommandLineArgs& args) {
+        ResetPerformance();
+        const auto total_start = std::chrono::steady_clock::now();
+        EnsureDependencyAnalysisReady(args);
+        const auto analysis_start = std::chrono::steady_clock::now();
+        const TransitiveReductionAnalysis reduction = cycle_detector_->AnalyzeTransitiveReduction();
         const auto render_start = std::chrono::steady_clock::now();
         auto reports = std::make_pair(
-            report_->RenderCycleReport(cycles, OutputFormat::JSON),
-            report_->RenderCycleReport(cycles, OutputFormat::HTML));
+            report_->RenderTransitiveReductionReport(reduction, OutputFormat::JSON),
+            report_->RenderTransitiveReductionReport(reduction, OutputFormat::HTML));
         FinalizePerformance(total_start, analysis_start, render_start);
         return reports;
     }
@@ -236,13 +432,13 @@ public:
         EnsureDependencyAnalysisReady(args);
         const auto analysis_start = std::chrono::steady_clock::now();
 
-        auto cycles = cycle_detector_->AnalyzeCycles();
+        const CycleReportData cycles = AnalyzeCycleReport(args);
         auto unused_deps = cycle_detector_->AnalyzeUnusedDependencies();
 
         const auto render_start = std::chrono::steady_clock::now();
         BazelAnalyzerSDK::DualDependencyReports reports;
-        reports.cycle = {report_->RenderCycleReport(cycles, OutputFormat::JSON),
-                         report_->RenderCycleReport(cycles, OutputFormat::HTML)};
+        reports.cycle = {RenderCycleReport(cycles, OutputFormat::JSON),
+                         RenderCycleReport(cycles, OutputFormat::HTML)};
         reports.unused = {report_->RenderUnusedDependenciesReport(unused_deps, OutputFormat::JSON),
                           report_->RenderUnusedDependenciesReport(unused_deps, OutputFormat::HTML)};
         FinalizePerformance(total_start, analysis_start, render_start);
@@ -254,6 +450,43 @@ public:
     }
 
 private:
+    // 循环依赖报告的数据，按 --cycle-report 只填充其中一项
+    struct CycleReportData {
+        CycleReportMode mode{CycleReportMode::CYCLES};
+        std::vector<CycleAnalysis> cycles;
+        std::vector<ComponentAnalysis> components;
+        FeedbackArcSetAnalysis feedback_arcs;
+    };
+
+    CycleReportData AnalyzeCycleReport(const CommandLineArgs& args) const {
+        CycleReportData data;
+        data.mode = args.cycle_report_mode;
+        switch (data.mode) {
+            case CycleReportMode::SCC_SUMMARY:
+                data.components = cycle_detector_->AnalyzeComponents();
+                break;
+            case CycleReportMode::FEEDBACK_ARCS:
+                data.feedback_arcs = cycle_detector_->AnalyzeFeedbackArcSet();
+                break;
+            case CycleReportMode::CYCLES:
+                data.cycles = cycle_detector_->AnalyzeCycles();
+                break;
+        }
+        return data;
+    }
+
+    std::string RenderCycleReport(const CycleReportData& data, OutputFormat format) const {
+        switch (data.mode) {
+            case CycleReportMode::SCC_SUMMARY:
+                return report_->RenderCycleReport(data.components, format);
+            case CycleReportMode::FEEDBACK_ARCS:
+                return report_->RenderCycleReport(data.feedback_arcs, format);
+            case CycleReportMode::CYCLES:
+                break;
+        }
+        return report_->RenderCycleReport(data.cycles, format);
+    }
+
     static double ToMillis(std::chrono::steady_clock::duration duration) {
         return std::chrono::duration<double, std::milli>(duration).count();
     }
@@ -280,7 +513,22 @@ private:
 
         const auto start = std::chrono::steady_clock::now();
         const std::string cache_key = BuildDependencyContextKey(args);
-        const std::string fingerprint = BuildWorkspaceFingerprint(args.workspace_path);
+        WorkspaceManifest previous_manifest;
+        {
+            std::lock_guard<std::mutex> lock(GetDependencyContextMutex());
+            auto& cache = GetDependencyContextCache();
+            auto it = cache.find(cache_key);
+            if (it != cache.end()) {
+                previous_manifest = it->second.manifest;
+            }
+        }
+        WorkspaceManifest manifest;
+        const std::string fingerprint =
+            BuildWorkspaceFingerprint(args.workspace_path, &previous_manifest, manifest);
+
+        std::shared_future<SharedDependencyContext> pending;
+        std::promise<SharedDependencyContext> building;
+        SharedDependencyContext previous_context;
         {
             std::lock_guard<std::mutex> lock(GetDependencyContextMutex());
             auto& cache = GetDependencyContextCache();
@@ -290,38 +538,70 @@ private:
                     dependency_context_ = it->second.context;
                     last_performance_.reused_dependency_context = true;
                 } else {
+                    LogWorkspaceChanges(args.workspace_path, it->second.fingerprint);
+                    if (OnlyBuildInputsChanged(args.workspace_path, it->second.fingerprint)) {
+                        previous_context = it->second.context;
+                    }
                     cache.erase(it);
                 }
             }
+            if (!dependency_context_) {
+                auto& pending_contexts = GetPendingDependencyContexts();
+                const auto pending_it = pending_contexts.find(cache_key);
+                if (pending_it != pending_contexts.end() && pending_it->second.fingerprint == fingerprint) {
+                    pending = pending_it->second.context;
+                } else {
+                    // 指纹不同的旧构建仍会完成，但其结果不再进入缓存
+                    pending_contexts[cache_key] = PendingDependencyContext{fingerprint, building.get_future().share()};
+                }
+            }
         }
 
-        if (!dependency_context_) {
-            parser_ = std::make_unique<AdvancedBazelQueryParser>(args.workspace_path, args.bazel_binary);
-            auto context = std::make_shared<DependencyAnalysisContext>();
-            context->targets = parser_->ParseWorkspace();
-            context->dependency_graph = std::make_shared<DependencyGraph>(context->targets);
-            context->cycle_detector = std::make_shared<CycleDetector>(
-                *context->dependency_graph, context->targets, args.workspace_path);
-            dependency_context_ = std::move(context);
+        if (pending.valid()) {
+            // 其他请求正在构建同一份上下文，构建失败时在这里重新抛出同一个异常
+            dependency_context_ = pending.get();
+            last_performance_.reused_dependency_context = true;
+        } else if (!dependency_context_) {
+            SharedDependencyContext context;
+            try {
+                context = BuildDependencyAnalysisContext(
+                    args, previous_context, BuildInputsFingerprint(args.workspace_path, manifest));
+            } catch (...) {
+                building.set_exception(std::current_exception());
+                std::lock_guard<std::mutex> lock(GetDependencyContextMutex());
+                ErasePendingContext(cache_key, fingerprint);
+                throw;
+            }
+            building.set_value(context);
+            dependency_context_ = context;
 
             std::lock_guard<std::mutex> lock(GetDependencyContextMutex());
-            GetDependencyContextCache()[cache_key] =
-                CachedDependencyContext{dependency_context_, fingerprint};
+            if (ErasePendingContext(cache_key, fingerprint)) {
+                GetDependencyContextCache()[cache_key] =
+                    CachedDependencyContext{std::move(context), fingerprint, std::move(manifest)};
+            }
         }
 
-        targets_ = &dependency_context_->targets;
-        dependency_graph_ = dependency_context_->dependency_graph;
         cycle_detector_ = dependency_context_->cycle_detector;
         last_performance_.dependency_prepare_ms = ToMillis(std::chrono::steady_clock::now() - start);
     }
 
+    // 调用方持有上下文缓存锁；只删除指纹相同的构建登记，返回是否删除
+    static bool ErasePendingContext(const std::string& cache_key, const std::string& fingerprint) {
+        auto& pending_contexts = GetPendingDependencyContexts();
+        const auto it = pending_contexts.find(cache_key);
+        if (it == pending_contexts.end() || it->second.fingerprint != fingerprint) {
+            return false;
+        }
+        pending_contexts.erase(it);
+        return true;
+    }
+
+    SharedDependencyContext dependency_context_;
+    std::shared_ptr<const CycleDetector> cycle_detector_;
     std::unique_ptr<AdvancedBazelQueryParser> parser_;
-    std::shared_ptr<DependencyAnalysisContext> dependency_context_;
-    std::shared_ptr<DependencyGraph> dependency_graph_;
-    std::shared_ptr<CycleDetector> cycle_detector_;
     std::unique_ptr<OutputReport> report_;
     std::unique_ptr<bazel_analyzer::BuildTimeAnalyzer> build_time_analyzer_;
-    const std::unordered_map<std::string, BazelTarget>* targets_{nullptr};
     BazelAnalyzerSDK::PerformanceInfo last_performance_{};
 };
 
@@ -334,6 +614,7 @@ BazelAnalyzerSDK::~BazelAnalyzerSDK() = default;
 void BazelAnalyzerSDK::ClearDependencyContextCache() {
     std::lock_guard<std::mutex> lock(GetDependencyContextMutex());
     GetDependencyContextCache().clear();
+    ClearGraphSnapshots();
 }
 
 size_t BazelAnalyzerSDK::GetDependencyContextCacheSize() {
@@ -349,6 +630,9 @@ void BazelAnalyzerSDK::executeCommand() {
         case ExcuteFuction::CYCLIC_DEPENDENCY_DETECTION:
             impl_->analyzeCycles(args_);
             break;
+        case ExcuteFuction::TRANSITIVE_REDUCTION:
+            impl_->analyzeTransitiveReduction(args_);
+            break;
         case ExcuteFuction::BUILD_TIME_ANALYZE:
             impl_->analyzeBuildTime(args_);
             break;
@@ -361,6 +645,8 @@ std::string BazelAnalyzerSDK::renderReport(OutputFormat format) {
             return impl_->renderUnusedDependencies(args_, format);
         case ExcuteFuction::CYCLIC_DEPENDENCY_DETECTION:
             return impl_->renderCycles(args_, format);
+        case ExcuteFuction::TRANSITIVE_REDUCTION:
+            return impl_->renderTransitiveReduction(args_, format);
         case ExcuteFuction::BUILD_TIME_ANALYZE:
             return impl_->renderBuildTime(args_, format);
     }
@@ -374,6 +660,8 @@ std::pair<std::string, std::string> BazelAnalyzerSDK::renderJsonAndHtmlReports()
             return impl_->renderUnusedDependenciesJsonAndHtml(args_);
         case ExcuteFuction::CYCLIC_DEPENDENCY_DETECTION:
             return impl_->renderCyclesJsonAndHtml(args_);
+        case ExcuteFuction::TRANSITIVE_REDUCTION:
+            return impl_->renderTransitiveReductionJsonAndHtml(args_);
         case ExcuteFuction::BUILD_TIME_ANALYZE:
             return impl_->renderBuildTimeJsonAndHtml(args_);
     }
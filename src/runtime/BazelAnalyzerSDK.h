@@ -24,6 +24,7 @@ public:
     explicit BazelAnalyzerSDK(CommandLineArgs args);
     ~BazelAnalyzerSDK();
 
+    // 同时删除缓存目录中的图快照
     static void ClearDependencyContextCache();
     static size_t GetDependencyContextCacheSize();
 
@@ -1,7 +1,9 @@
 #include "WebServer.h"
 
+#include "concurrency/CacheBudget.h"
 #include "log/logger.h"
 #include "parser/AdvancedBazelQueryParser.h"
+#include "parser/WorkspaceWatcher.h"
 #include "runtime/BazelAnalyzerSDK.h"
 #include <nlohmann/json.hpp>
 
@@ -106,6 +108,8 @@ std::string ModeToString(ExcuteFuction function) {
             return "cycle";
         case ExcuteFuction::BUILD_TIME_ANALYZE:
             return "build-time";
+        case ExcuteFuction::TRANSITIVE_REDUCTION:
+            return "reduce";
     }
 
     return "cycle";
@@ -118,6 +122,9 @@ ExcuteFuction ParseMode(const std::string& mode) {
     if (mode == "build-time") {
         return ExcuteFuction::BUILD_TIME_ANALYZE;
     }
+    if (mode == "reduce") {
+        return ExcuteFuction::TRANSITIVE_REDUCTION;
+    }
     return ExcuteFuction::CYCLIC_DEPENDENCY_DETECTION;
 }
 
@@ -232,8 +239,21 @@ json BuildTaskSummaryJson(const WebServer::AnalysisTask& task) {
     };
 }
 
-WebServer::CachedAnalyzeResponse BuildCachedAnalyzeResponse(const std::string& response_body) {
-    WebServer::CachedAnalyzeResponse cache_entry{response_body, response_body};
+// 工作区受 watcher 监听时返回 true 并给出当前变更计数
+bool GetWorkspaceGeneration(const std::string& workspace_path, std::uint64_t& generation) {
+    const auto watcher = WorkspaceWatcher::Acquire(workspace_path);
+    if (!watcher) {
+        return false;
+    }
+    generation = watcher->Generation();
+    return true;
+}
+
+WebServer::CachedAnalyzeResponse BuildCachedAnalyzeResponse(const std::string& response_body,
+                                                            bool watched,
+                                                            std::uint64_t workspace_generation) {
+    WebServer::CachedAnalyzeResponse cache_entry{
+        response_body, response_body, watched, workspace_generation};
     try {
         json cached_response = json::parse(response_body);
         cached_response["cache_hit"] = true;
@@ -302,6 +322,8 @@ void FillTaskMetadataFromResponse(WebServer::AnalysisTask& task, const std::stri
 }  // namespace
 
 WebServer::WebServer(CommandLineArgs base_args) : base_args_(std::move(base_args)) {
+    // 常驻进程里用 inotify 跟踪工作区变化，代替每个请求一次的目录遍历
+    WorkspaceWatcher::SetEnabled(true);
     LoadTaskHistory();
 }
 
@@ -495,7 +517,20 @@ WebServer::HttpResponse WebServer::HandleAnalyzeRequest(const std::string& body)
         request_json.value("workspace_path", request_args.workspace_path);
     request_args.bazel_binary = request_json.value("bazel_binary", request_args.bazel_binary);
     request_args.include_tests = request_json.value("include_tests", request_args.include_tests);
+    if (request_json.contains("parser")) {
+        request_args.parse_strategy =
+            CommandLineArgs::ParseParseStrategy(request_json.value("parser", std::string("query")));
+    }
+    if (request_json.contains("cycle_report")) {
+        request_args.cycle_report_mode =
+            CommandLineArgs::ParseCycleReportMode(request_json.value("cycle_report", std::string("cycles")));
+    }
     request_args.execute_function = ParseMode(request_json.value("mode", ModeToString(request_args.execute_function)));
+    // --graph-snapshot 只对应启动时的工作区与解析方式，其他请求使用缓存目录中按工作区区分的快照
+    if (request_args.workspace_path != base_args_.workspace_path ||
+        request_args.parse_strategy != base_args_.parse_strategy) {
+        request_args.graph_snapshot_path.clear();
+    }
 
     if (request_args.bazel_binary.empty() || request_args.bazel_binary == "bazel") {
         const std::vector<std::string> detected_binaries = DetectBazelBinaries();
@@ -508,8 +543,16 @@ WebServer::HttpResponse WebServer::HandleAnalyzeRequest(const std::string& body)
 
     const std::string cache_key = BuildCacheKey(request_args);
     if (!force_refresh) {
+        std::uint64_t generation = 0;
+        const bool watched = GetWorkspaceGeneration(request_args.workspace_path, generation);
         std::lock_guard<std::mutex> lock(cache_mutex_);
-        const auto cached = analyze_cache_.find(cache_key);
+        auto cached = analyze_cache_.find(cache_key);
+        // 监听中的工作区在结果生成后有文件变化时，缓存失效（O(1) 判断，无需遍历工作区）
+        if (cached != analyze_cache_.end() && cached->second.watched &&
+            (!watched || cached->second.workspace_generation != generation)) {
+            analyze_cache_.erase(cached);
+            cached = analyze_cache_.end();
+        }
         if (cached != analyze_cache_.end()) {
             return HttpResponse{
                 200,
@@ -544,7 +587,9 @@ std::string WebServer::BuildCacheKey(const CommandLineArgs& args) const {
     os << args.workspace_path << '\n'
        << args.bazel_binary << '\n'
        << static_cast<int>(args.execute_function) << '\n'
-       << (args.include_tests ? "1" : "0");
+       << (args.include_tests ? "1" : "0") << '\n'
+       << CommandLineArgs::ParseStrategyToString(args.parse_strategy) << '\n'
+       << CommandLineArgs::CycleReportModeToString(args.cycle_report_mode);
     return os.str();
 }
 
@@ -719,12 +764,35 @@ WebServer::HttpResponse WebServer::HandleCacheStatusRequest() const {
         task_count = tasks_.size();
     }
 
+    // 可淘汰的分析备忘表：共享一个字节预算，按表名合并各工作区上下文中的同名表
+    const CacheBudget::Snapshot budget = CacheBudget::Instance().GetSnapshot();
+    json analysis_caches = json::array();
+    for (const auto& stats : budget.caches) {
+        analysis_caches.push_back({
+            {"name", stats.name},
+            {"instances", stats.instances},
+            {"entries", stats.entries},
+            {"bytes", stats.bytes},
+            {"hits", stats.hits},
+            {"misses", stats.misses},
+            {"evictions", stats.evictions},
+        });
+    }
+
     json response = {
         {"ok", true},
         {"response_cache_size", response_cache_size},
         {"dependency_context_cache_size", BazelAnalyzerSDK::GetDependencyContextCacheSize()},
         {"workspace_parser_cache_size", AdvancedBazelQueryParser::GetWorkspaceCacheSize()},
+        {"workspace_snapshot_count", AdvancedBazelQueryParser::GetWorkspaceSnapshotCount()},
+        {"workspace_watcher_count", WorkspaceWatcher::ActiveCount()},
         {"task_count", task_count},
+        {"analysis_cache", {
+            {"budget_bytes", budget.limit_bytes},
+            {"used_bytes", budget.used_bytes},
+            {"reclaims", budget.reclaims},
+            {"caches", analysis_caches},
+        }},
     };
 
     return HttpResponse{200, "application/json; charset=utf-8", response.dump(2)};
@@ -831,6 +899,9 @@ void WebServer::RunAnalyzeTask(
     std::string cache_key) const {
     try {
         UpdateTaskStatus(task_id, "running", "准备分析环境…");
+        // 在分析开始前取变更计数：分析期间发生的修改会让本次结果在下次请求时失效
+        std::uint64_t generation = 0;
+        const bool watched = GetWorkspaceGeneration(request_args.workspace_path, generation);
         BazelAnalyzerSDK sdk(request_args);
 
         if (request_args.execute_function == ExcuteFuction::CYCLIC_DEPENDENCY_DETECTION ||
@@ -853,8 +924,10 @@ void WebServer::RunAnalyzeTask(
 
             {
                 std::lock_guard<std::mutex> lock(cache_mutex_);
-                analyze_cache_[cycle_cache_key] = BuildCachedAnalyzeResponse(cycle_response_body);
-                analyze_cache_[unused_cache_key] = BuildCachedAnalyzeResponse(unused_response_body);
+                analyze_cache_[cycle_cache_key] =
+                    BuildCachedAnalyzeResponse(cycle_response_body, watched, generation);
+                analyze_cache_[unused_cache_key] =
+                    BuildCachedAnalyzeResponse(unused_response_body, watched, generation);
             }
 
             UpdateTaskStatus(
@@ -867,14 +940,15 @@ void WebServer::RunAnalyzeTask(
             return;
         }
 
-        UpdateTaskStatus(task_id, "running", "执行构建耗时分析…");
+        const bool reduction = request_args.execute_function == ExcuteFuction::TRANSITIVE_REDUCTION;
+        UpdateTaskStatus(task_id, "running", reduction ? "解析依赖图并计算传递约简…" : "执行构建耗时分析…");
         const auto reports = sdk.renderJsonAndHtmlReports();
-        UpdateTaskStatus(task_id, "running", "整理 build-time 报告输出…");
+        UpdateTaskStatus(task_id, "running", reduction ? "整理 reduce 报告输出…" : "整理 build-time 报告输出…");
         const std::string response_body =
             BuildAnalyzeResponseBody(request_args, reports, false, sdk.getLastPerformanceInfo());
         {
             std::lock_guard<std::mutex> lock(cache_mutex_);
-            analyze_cache_[cache_key] = BuildCachedAnalyzeResponse(response_body);
+            analyze_cache_[cache_key] = BuildCachedAnalyzeResponse(response_body, watched, generation);
         }
         UpdateTaskStatus(task_id, "completed", "分析完成。", response_body);
     } catch (const std::exception& error) {
@@ -34,6 +34,8 @@ public:
     struct CachedAnalyzeResponse {
         std::string response_body;
         std::string response_body_cache_hit;
+        bool watched{false};                    // 生成时工作区处于 inotify 监听下
+        std::uint64_t workspace_generation{0};  // 分析开始时的工作区变更计数
     };
 
     struct AnalysisTask {
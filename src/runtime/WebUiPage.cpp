@@ -278,7 +278,7 @@ std::string WebServer::BuildUiPage() {
     }
     .mode-grid {
       display: grid;
-      grid-template-columns: repeat(3, minmax(0, 1fr));
+      grid-template-columns: repeat(2, minmax(0, 1fr));
       gap: 10px;
     }
     .mode-card {
@@ -1171,6 +1171,10 @@ std::string WebServer::BuildUiPage() {
                   <strong>未使用依赖</strong>
                   <span>发现可移除依赖与置信度</span>
                 </button>
+                <button class="mode-card" type="button" data-mode="reduce">
+                  <strong>冗余依赖</strong>
+                  <span>传递约简，区分可删除与需保留</span>
+                </button>
                 <button class="mode-card" type="button" data-mode="build-time">
                   <strong>构建耗时</strong>
                   <span>查看阶段耗时与关键路径</span>
@@ -1179,6 +1183,7 @@ std::string WebServer::BuildUiPage() {
               <select id="mode" name="mode" hidden>
                 <option value="cycle" selected>循环依赖</option>
                 <option value="unused">未使用依赖</option>
+                <option value="reduce">冗余依赖</option>
                 <option value="build-time">构建耗时</option>
               </select>
             </div>
@@ -1363,6 +1368,7 @@ std::string WebServer::BuildUiPage() {
 
     function normalizeModeLabel(mode) {
       if (mode === 'unused') return '未使用依赖';
+      if (mode === 'reduce') return '冗余依赖';
       if (mode === 'build-time') return '构建耗时';
       return '循环依赖';
     }
@@ -1601,6 +1607,17 @@ std::string WebServer::BuildUiPage() {
         summaryText = delta > 0 ? '潜在可清理项比上次更多，适合安排一轮依赖治理。'
           : delta < 0 ? '未使用依赖较上次减少，清理已见效。'
           : '未使用依赖数量与上次接近，可重点看高置信度变化。';
+      } else if (currentPayload.mode === 'reduce') {
+        const currentReport = currentPayload.report.transitive_reduction_report || {};
+        const baselineReport = baselinePayload.report.transitive_reduction_report || {};
+        metricsHtml = `
+          ${buildTrendMetric('冗余依赖边', currentReport.redundant_edges ?? 0, baselineReport.redundant_edges ?? 0)}
+          ${buildTrendMetric('可删除', currentReport.safe_to_drop ?? 0, baselineReport.safe_to_drop ?? 0)}
+          ${buildTrendMetric('分析总耗时(ms)', Number((currentPayload.performance || {}).total_ms || 0).toFixed(2), Number((baselinePayload.performance || {}).total_ms || 0).toFixed(2), 'ms')}`;
+        const delta = Number(currentReport.safe_to_drop || 0) - Number(baselineReport.safe_to_drop || 0);
+        summaryText = delta > 0 ? '可删除的冗余依赖比上次更多，适合集中清理一轮 BUILD 文件。'
+          : delta < 0 ? '可删除的冗余依赖较上次减少，清理已见效。'
+          : '冗余依赖数量与上次接近，可重点看 strict deps 下需保留的边。';
       } else {
         const currentReport = currentPayload.report.build_time_report || {};
         const baselineReport = baselinePayload.report.build_time_report || {};
@@ -1675,6 +1692,23 @@ std::string WebServer::BuildUiPage() {
           </div>`;
       }
 
+      if (resultPayload.mode === 'reduce') {
+        const report = resultPayload.report.transitive_reduction_report || {};
+        return `
+          <div class="item">
+            <strong>冗余依赖摘要</strong>
+            <div class="metric-grid" style="margin-top:12px;">
+              ${renderMetric('冗余依赖边', report.redundant_edges ?? 0)}
+              ${renderMetric('可删除', report.safe_to_drop ?? 0)}
+              ${renderMetric('需保留', report.keep_for_strict_deps ?? 0)}
+            </div>
+            <div class="tag-list">
+              <span class="tag ${Number(report.safe_to_drop || 0) > 0 ? 'warning' : 'success'}">${Number(report.safe_to_drop || 0) > 0 ? '存在可删除的冗余依赖' : '暂无可删除项'}</span>
+              <span class="tag">分析总耗时：${escapeHtml(Number((resultPayload.performance || {}).total_ms || 0).toFixed(2))}ms</span>
+            </div>
+          </div>`;
+      }
+
       const report = resultPayload.report.build_time_report || {};
       const summary = report.summary || {};
       const phase = report.phase_stats || {};
@@ -2174,10 +2208,14 @@ std::string WebServer::BuildUiPage() {
         return;
       }
 
+      const analysisCache = latestCacheStatus.analysis_cache || {};
+      const toMiB = (bytes) => (Number(bytes || 0) / 1048576).toFixed(1);
+      const budgetText = Number(analysisCache.budget_bytes || 0) > 0 ? `${toMiB(analysisCache.budget_bytes)} MiB` : '不限';
       panel.innerHTML = `
         <div class="helper-card">
           <strong>缓存管理</strong>
           <span>响应缓存：${escapeHtml(latestCacheStatus.response_cache_size)} · 依赖上下文：${escapeHtml(latestCacheStatus.dependency_context_cache_size)} · Parser：${escapeHtml(latestCacheStatus.workspace_parser_cache_size)} · 任务数：${escapeHtml(latestCacheStatus.task_count)}</span>
+          <span>分析缓存：${escapeHtml(toMiB(analysisCache.used_bytes))} / ${escapeHtml(budgetText)} · 回收 ${escapeHtml(analysisCache.reclaims ?? 0)} 次</span>
           <div class="action-row" style="margin-top:12px;">
             <button id="refresh-cache-button" class="secondary-button" type="button">刷新缓存状态</button>
             <button id="clear-cache-button" class="secondary-button" type="button">清空全部缓存</button>
@@ -2265,6 +2303,7 @@ std::string WebServer::BuildUiPage() {
                   <option value="">全部模式</option>
                   <option value="cycle">循环依赖</option>
                   <option value="unused">未使用依赖</option>
+                  <option value="reduce">冗余依赖</option>
                   <option value="build-time">构建耗时</option>
                 </select>
               </div>
@@ -2475,6 +2514,12 @@ std::string WebServer::BuildUiPage() {
           lines.push(`## 未使用依赖摘要`, ``);
           lines.push(`- 未使用依赖：${report.total_unused_dependencies ?? 0}`);
           lines.push(`- 高置信度：${stats.high_confidence ?? 0}`);
+        } else if (resultPayload.mode === 'reduce') {
+          const report = resultPayload.report.transitive_reduction_report || {};
+          lines.push(`## 冗余依赖摘要`, ``);
+          lines.push(`- 冗余依赖边：${report.redundant_edges ?? 0} / ${report.total_edges ?? 0}`);
+          lines.push(`- 可删除：${report.safe_to_drop ?? 0}`);
+          lines.push(`- strict deps 下需保留：${report.keep_for_strict_deps ?? 0}`);
         } else {
           const summary = ((resultPayload.report || {}).build_time_report || {}).summary || {};
           lines.push(`## 构建耗时摘要`, ``);
@@ -2701,6 +2746,79 @@ std::string WebServer::BuildUiPage() {
         </div>`;
     }
 
+    function renderReductionSummary(payload) {
+      const report = payload.report.transitive_reduction_report || {};
+      const edges = report.edges || [];
+      const safeToDrop = Number(report.safe_to_drop || 0);
+      const metricHtml = `
+        <div class="metric-grid">
+          ${renderMetric('模式', '冗余依赖')}
+          ${renderMetric('冗余依赖边', report.redundant_edges ?? 0)}
+          ${renderMetric('可删除', report.safe_to_drop ?? 0)}
+          ${renderMetric('需保留', report.keep_for_strict_deps ?? 0)}
+          ${renderMetric('cc 依赖边', report.total_edges ?? 0)}
+        </div>`;
+      const insightHtml = safeToDrop > 0
+        ? renderInsightBanner('先删除可删除的冗余依赖', `当前有 ${safeToDrop} 条依赖已能经由其他依赖传递得到且源码未直接引用，删除后可减少 Bazel 分析阶段的依赖边。`, 'warning')
+        : renderInsightBanner('没有可直接删除的冗余依赖', '剩余的冗余依赖被源码直接引用，strict deps 下需要保留。', 'success');
+
+      const edgesCard = edges.length
+        ? `
+          <div class="card">
+            <div class="card-header">
+              <h3>冗余依赖边</h3>
+              <p>每条依赖都能经由右侧的另一个直接依赖传递得到；可删除的排在前面。</p>
+            </div>
+            <div class="list-table">
+              ${edges.map((edge) => `
+                <div class="list-row">
+                  <div>
+                    <strong>${escapeHtml(edge.from)} → ${escapeHtml(edge.to)}</strong>
+                    <span>经由 ${escapeHtml(edge.via)} · ${escapeHtml(edge.reason || '')}</span>
+                  </div>
+                  <span class="tag ${edge.safe_to_drop ? 'success' : 'warning'}">${edge.safe_to_drop ? '可删除' : '需保留'}</span>
+                </div>
+              `).join('')}
+            </div>
+          </div>`
+        : `
+          <div class="card">
+            <div class="card-header">
+              <h3>冗余依赖边</h3>
+              <p>当前工作区的 cc 依赖没有可由其他依赖传递得到的边。</p>
+            </div>
+          </div>`;
+
+      const overviewCard = `
+        <div class="card">
+          <div class="card-header">
+            <h3>清理建议</h3>
+            <p>删除冗余依赖不改变依赖关系，但会减少 Bazel 需要分析的边。</p>
+          </div>
+          <div class="stack">
+            <div class="item">
+              <div class="tag-list">
+                <span class="tag success">可删除：${escapeHtml(report.safe_to_drop ?? 0)}</span>
+                <span class="tag warning">需保留：${escapeHtml(report.keep_for_strict_deps ?? 0)}</span>
+              </div>
+              <ul>
+                <li>先删除源码未直接引用的依赖。</li>
+                <li>源码直接引用的依赖在 strict deps 下仍需声明。</li>
+                <li>每次删除后跑一次 Bazel 编译验证。</li>
+              </ul>
+            </div>
+          </div>
+        </div>`;
+
+      resultsEl.innerHTML = `
+        ${insightHtml}
+        ${metricHtml}
+        <div class="summary-grid">
+          <div class="summary-main">${edgesCard}</div>
+          <div class="summary-side">${overviewCard}${renderPerformanceCard(payload)}</div>
+        </div>`;
+    }
+
     function renderBuildTimeSummary(payload) {
       const report = payload.report.build_time_report || {};
       const summary = report.summary || {};
@@ -2819,6 +2937,13 @@ std::string WebServer::BuildUiPage() {
         cards.push(renderMetric('当前未使用依赖', currentReport.total_unused_dependencies ?? 0));
         cards.push(renderMetric('基线未使用依赖', previousReport.total_unused_dependencies ?? 0));
         cards.push(`<div class="metric-card"><div class="label">依赖变化</div><div class="value" style="color:${Number(currentReport.total_unused_dependencies || 0) - Number(previousReport.total_unused_dependencies || 0) > 0 ? 'var(--danger)' : Number(currentReport.total_unused_dependencies || 0) - Number(previousReport.total_unused_dependencies || 0) < 0 ? 'var(--success)' : 'var(--text)'}">${escapeHtml(formatDelta(currentReport.total_unused_dependencies, previousReport.total_unused_dependencies))}</div></div>`);
+      } else if (currentPayload.mode === 'reduce') {
+        const currentReport = currentPayload.report.transitive_reduction_report || {};
+        const previousReport = previousPayload.report.transitive_reduction_report || {};
+        const reductionDelta = Number(currentReport.redundant_edges || 0) - Number(previousReport.redundant_edges || 0);
+        cards.push(renderMetric('当前冗余依赖边', currentReport.redundant_edges ?? 0));
+        cards.push(renderMetric('基线冗余依赖边', previousReport.redundant_edges ?? 0));
+        cards.push(`<div class="metric-card"><div class="label">冗余边变化</div><div class="value" style="color:${reductionDelta > 0 ? 'var(--danger)' : reductionDelta < 0 ? 'var(--success)' : 'var(--text)'}">${escapeHtml(formatDelta(currentReport.redundant_edges, previousReport.redundant_edges))}</div></div>`);
       } else {
         const currentReport = currentPayload.report.build_time_report || {};
         const previousReport = previousPayload.report.build_time_report || {};
@@ -2851,6 +2976,15 @@ std::string WebServer::BuildUiPage() {
           : delta < 0
             ? renderInsightBanner('依赖清理有效', `和基线相比，未使用依赖减少了 ${Math.abs(delta)} 条。`, 'success')
             : renderInsightBanner('依赖规模持平', '未使用依赖数量变化不大，可以结合高/中/低置信度继续判断。');
+      } else if (currentPayload.mode === 'reduce') {
+        const currentReport = currentPayload.report.transitive_reduction_report || {};
+        const previousReport = previousPayload.report.transitive_reduction_report || {};
+        const delta = Number(currentReport.redundant_edges || 0) - Number(previousReport.redundant_edges || 0);
+        compareInsightHtml = delta > 0
+          ? renderInsightBanner('冗余依赖变多', `和基线相比，冗余依赖边增加了 ${delta} 条，建议优先删除可删除项。`, 'warning')
+          : delta < 0
+            ? renderInsightBanner('冗余依赖减少', `和基线相比，冗余依赖边减少了 ${Math.abs(delta)} 条。`, 'success')
+            : renderInsightBanner('冗余依赖持平', '冗余依赖边数量没有变化，可以结合可删除与需保留的比例继续判断。');
       } else {
         const currentReport = currentPayload.report.build_time_report || {};
         const previousReport = previousPayload.report.build_time_report || {};
@@ -2922,6 +3056,10 @@ std::string WebServer::BuildUiPage() {
         renderUnusedSummary(payload);
         return;
       }
+      if (payload.mode === 'reduce') {
+        renderReductionSummary(payload);
+        return;
+      }
       if (payload.mode === 'build-time') {
         renderBuildTimeSummary(payload);
         return;
@@ -0,0 +1,124 @@
+// 超长依赖链上的强连通分量与环枚举：Tarjan 与 Johnson 的 DFS 都是显式栈，
+// 100 万个节点的链不能触发栈溢出，也不能随深度退化
+
+#include "graph/DependencyGraph.h"
+#include "graph/TargetTable.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr size_t kChainLength = 1000000;
+// 回边 t[N-1] -> t[N/2]：后半段成为一个大分量，前半段是单节点分量
+constexpr size_t kBackEdgeTarget = kChainLength / 2;
+// 单个长环：只有一个基本环，默认的环数上限与截止时间内必须枚举完
+constexpr size_t kRingLength = 200000;
+
+int failures = 0;
+
+void Expect(bool condition, const std::string& message) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", message.c_str());
+        ++failures;
+    }
+}
+
+std::string ChainLabel(size_t index) {
+    char label[32];
+    // 补零保证字典序与链上顺序一致，label id 即链上下标
+    std::snprintf(label, sizeof(label), "//chain:t%07zu", index);
+    return label;
+}
+
+// t[i] -> t[i + 1]，最后一个节点指回 t[back_edge_target]
+TargetTable BuildChain(size_t length, size_t back_edge_target) {
+    std::unordered_map<std::string, BazelTarget> targets;
+    targets.reserve(length);
+    for (size_t index = 0; index < length; ++index) {
+        BazelTarget target;
+        target.full_label = ChainLabel(index);
+        target.name = target.full_label.substr(target.full_label.find(':') + 1);
+        target.path = "chain";
+        target.rule_type = "cc_library";
+        target.deps.push_back(ChainLabel(index + 1 < length ? index + 1 : back_edge_target));
+        targets.emplace(target.full_label, std::move(target));
+    }
+    return TargetTable::Build(targets);
+}
+
+void TestChainWithBackEdge() {
+    const TargetTable table = BuildChain(kChainLength, kBackEdgeTarget);
+    const DependencyGraph graph(table);
+    Expect(graph.NodeCount() == kChainLength, "node count");
+    Expect(graph.EdgeCount() == kChainLength, "edge count");
+
+    const SccPartition components = graph.FindStronglyConnectedComponents();
+    Expect(components.Count() == kBackEdgeTarget + 1, "component count");
+    const std::uint32_t cycle_component = components.component_of[kBackEdgeTarget];
+    Expect(components.Component(cycle_component).size() == kChainLength - kBackEdgeTarget, "cycle component size");
+    for (size_t index = 0; index + 1 < kBackEdgeTarget; ++index) {
+        // 逆拓扑序：依赖所在分量的编号更小
+        if (components.component_of[index] <= components.component_of[index + 1]) {
+            Expect(false, "reverse topological order at t" + std::to_string(index));
+            break;
+        }
+    }
+
+    // 默认的环数上限与截止时间：第一个环就要沿链走完整个分量，之后的起点都不在含环子图中
+    const DependencyGraph::CycleEnumerationOptions options;
+    size_t cycles = 0;
+    size_t cycle_length = 0;
+    DependencyGraph::NodeId cycle_start = TargetTable::kInvalidId;
+    const auto stats = graph.EnumerateCycles(options, [&](const std::vector<DependencyGraph::NodeId>& cycle) {
+        ++cycles;
+        cycle_length = cycle.size();
+        cycle_start = cycle.empty() ? TargetTable::kInvalidId : cycle.front();
+        return true;
+    });
+    Expect(!stats.deadline_reached, "enumeration finished before the deadline");
+    Expect(stats.truncated_components == 0, "enumeration was not truncated");
+    Expect(cycles == 1 && stats.cycles == 1 && stats.cyclic_components == 1, "exactly one cycle");
+    Expect(cycle_length == kChainLength - kBackEdgeTarget, "cycle length");
+    Expect(cycle_start == kBackEdgeTarget, "cycle starts at its smallest id");
+    std::printf("chain: %zu nodes, %zu components, 1 cycle of %zu nodes\n",
+                kChainLength, components.Count(), cycle_length);
+}
+
+// 起点之后的子图已无环时，Johnson 不能再逐个起点重新搜索整个分量
+void TestLongRingUnderDefaultBudget() {
+    const TargetTable table = BuildChain(kRingLength, 0);
+    const DependencyGraph graph(table);
+
+    const DependencyGraph::CycleEnumerationOptions options;
+    size_t cycles = 0;
+    size_t cycle_length = 0;
+    const auto start = std::chrono::steady_clock::now();
+    const auto stats = graph.EnumerateCycles(options, [&](const std::vector<DependencyGraph::NodeId>& cycle) {
+        ++cycles;
+        cycle_length = cycle.size();
+        return true;
+    });
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    Expect(!stats.deadline_reached, "ring enumeration finished before the default deadline");
+    Expect(stats.truncated_components == 0, "ring enumeration was not truncated");
+    Expect(cycles == 1 && cycle_length == kRingLength, "ring has exactly one cycle through every node");
+    std::printf("ring: %zu nodes, %zu cycle(s), %lld ms\n", kRingLength, cycles,
+                static_cast<long long>(elapsed.count()));
+}
+
+}  // namespace
+
+int main() {
+    TestChainWithBackEdge();
+    TestLongRingUnderDefaultBudget();
+    if (failures != 0) {
+        return 1;
+    }
+    std::printf("PASSED\n");
+    return 0;
+}